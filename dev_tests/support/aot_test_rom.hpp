@@ -0,0 +1,107 @@
+// ============================================================================
+// Synthetic AOT Test ROM
+// ----------------------------------------------------------------------------
+// Target Module : CPU / Aot backend (tools/rom_recompiler)
+// Purpose       : A small ROM that aot_test_rom_writer saves as invaders.e-h,
+//                 so the build can recompile it like the real ROM and
+//                 aot_backend_tests can load the same bytes.
+// Scope         : Direct and conditional CALL/RET, RST, PCHL to code the
+//                 recompiler cannot see, 16-bit loads/stores, rotates,
+//                 carry ALU ops, memory INR/DCR and a closing HLT.
+//
+// Author        : Jese/Arnav
+// Date          : 10/17/26
+// ============================================================================
+
+#ifndef AOT_TEST_ROM_HPP_
+#define AOT_TEST_ROM_HPP_
+
+// ========================== Include ========================================
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One run of bytes at a ROM address; everything else is 0x00 (NOP).
+struct AotTestRomPart {
+    uint16_t address;
+    std::vector<uint8_t> bytes;
+};
+
+inline const std::vector<AotTestRomPart> AOT_TEST_ROM = {
+    {0x0000, {
+        0xC3, 0x40, 0x00,       // 0000: JMP 0040
+    }},
+    {0x0008, {
+        0x1C,                   // 0008: INR E          (RST 1)
+        0xC9,                   // 0009: RET
+    }},
+    {0x0040, {
+        0x31, 0x00, 0x24,       // 0040: LXI SP,2400
+        0x21, 0x00, 0x21,       // 0043: LXI H,2100
+        0x11, 0x00, 0x00,       // 0046: LXI D,0000
+        0x0E, 0x10,             // 0049: MVI C,10
+        0xAF,                   // 004B: XRA A
+        0xCD, 0x90, 0x00,       // 004C: CALL 0090
+        0x32, 0x00, 0x22,       // 004F: STA 2200
+        0xCC, 0xA0, 0x00,       // 0052: CZ 00A0
+        0xC4, 0xA0, 0x00,       // 0055: CNZ 00A0
+        0xCF,                   // 0058: RST 1
+        0x22, 0x02, 0x22,       // 0059: SHLD 2202
+        0xEB,                   // 005C: XCHG
+        0x2A, 0x02, 0x22,       // 005D: LHLD 2202
+        0x19,                   // 0060: DAD D
+        0x07,                   // 0061: RLC
+        0x1F,                   // 0062: RAR
+        0x2F,                   // 0063: CMA
+        0x37,                   // 0064: STC
+        0x98,                   // 0065: SBB B
+        0xD5,                   // 0066: PUSH D
+        0xE3,                   // 0067: XTHL
+        0xD1,                   // 0068: POP D
+        0x21, 0xB0, 0x00,       // 0069: LXI H,00B0
+        0xE9,                   // 006C: PCHL
+        0x21, 0x01, 0x22,       // 006D: LXI H,2201
+        0x34,                   // 0070: INR M
+        0x35,                   // 0071: DCR M
+        0x36, 0x5A,             // 0072: MVI M,5A
+        0xFE, 0x40,             // 0074: CPI 40
+        0xDA, 0x7B, 0x00,       // 0076: JC 007B
+        0xF6, 0x01,             // 0079: ORI 01
+        0xE6, 0x7F,             // 007B: ANI 7F
+        0x32, 0x03, 0x22,       // 007D: STA 2203
+        0x76,                   // 0080: HLT
+    }},
+    {0x0090, {
+        0x86,                   // 0090: ADD M
+        0xF5,                   // 0091: PUSH PSW
+        0x23,                   // 0092: INX H
+        0xF1,                   // 0093: POP PSW
+        0x0D,                   // 0094: DCR C
+        0xC2, 0x90, 0x00,       // 0095: JNZ 0090
+        0x27,                   // 0098: DAA
+        0xC9,                   // 0099: RET
+    }},
+    {0x00A0, {
+        0x04,                   // 00A0: INR B
+        0xC0,                   // 00A1: RNZ
+        0x04,                   // 00A2: INR B
+        0xC9,                   // 00A3: RET
+    }},
+    {0x00B0, {
+        0x06, 0x33,             // 00B0: MVI B,33       (only reached via PCHL)
+        0xC3, 0x6D, 0x00,       // 00B2: JMP 006D
+    }},
+};
+
+// The whole 8 KB ROM region (0x0000-0x1FFF) as loaded.
+inline std::vector<uint8_t> aotTestRomImage() {
+    std::vector<uint8_t> image(0x2000, 0x00);
+    for (const AotTestRomPart& part : AOT_TEST_ROM) {
+        for (std::size_t i = 0; i < part.bytes.size(); ++i) {
+            image[part.address + i] = part.bytes[i];
+        }
+    }
+    return image;
+}
+
+#endif // AOT_TEST_ROM_HPP_
@@ -0,0 +1,49 @@
+// ============================================================================
+// AOT Test ROM Writer
+// ----------------------------------------------------------------------------
+// Target Module : CPU / Aot backend (tools/rom_recompiler)
+// Purpose       : Saves AOT_TEST_ROM (aot_test_rom.hpp) as invaders.h/g/f/e
+//                 in the given directory, the layout LoadSpaceInvadersROM
+//                 and rom_recompiler expect.
+//
+//                 Usage: aot_test_rom_writer <rom directory>
+//
+// Author        : Jese/Arnav
+// Date          : 10/17/26
+// ============================================================================
+
+// ========================== Include ========================================
+#include "aot_test_rom.hpp"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <rom directory>\n";
+        return 1;
+    }
+
+    std::filesystem::path dir = argv[1];
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+
+    // Same file → address mapping as LoadSpaceInvadersROM.
+    const std::vector<uint8_t> image = aotTestRomImage();
+    const std::pair<const char*, uint16_t> parts[] = {
+        {"invaders.h", 0x0000},
+        {"invaders.g", 0x0800},
+        {"invaders.f", 0x1000},
+        {"invaders.e", 0x1800},
+    };
+    for (const auto& [name, address] : parts) {
+        std::ofstream out(dir / name, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(image.data() + address), 0x0800);
+        if (!out) {
+            std::cerr << "[aot_test_rom_writer] Cannot write " << (dir / name).string() << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+// ============================================================================
+// AOT Backend Unit Tests - Recompiled ROM vs Table Interpreter
+// ----------------------------------------------------------------------------
+// Target Module : CPU / Aot backend (Intel 8080 Emulator)
+// Purpose       : Checks that code generated by tools/rom_recompiler runs
+//                 and leaves the same registers, flags and memory as the
+//                 dispatch table core.
+// Scope         : Links the C++ recompiled from AOT_TEST_ROM
+//                 (aot_test_rom.hpp) instead of aot_rom_stub.cpp; see
+//                 dev_tests/CMakeLists.txt or dev_tests/README.md. Runs the
+//                 ROM in one batch, in 1-cycle batches and in batches of
+//                 every size up to 256 cycles.
+//
+// Author        : Jese/Arnav
+// Date          : 10/17/26
+// ============================================================================
+
+//=========================== Define ==========================================
+#define ENABLE_COLOR_OUTPUT
+#define ENABLE_CPU_TESTING
+
+// ========================== Include ========================================
+#include "../../src/model/emulator.hpp"
+#include "../../src/model/aot_rom.hpp"
+#include "../support/aot_test_rom.hpp"
+#include "../support/test_utils.hpp"
+#include <iostream>
+
+// Enough for AOT_TEST_ROM to reach its HLT from reset.
+static const int AOT_TEST_ROM_CYCLES = 2000;
+
+// Loads AOT_TEST_ROM and the bytes it sums into a fresh emulator.
+static void loadAotTestRom(Emulator& emu) {
+    Memory& mem = emu.getMemoryRef();
+    for (const AotTestRomPart& part : AOT_TEST_ROM) {
+        writeRomInstructionSequence(mem, part.address, part.bytes);
+    }
+    for (uint16_t i = 0; i < 0x10; ++i) {
+        mem.WriteByte(0x2100 + i, static_cast<uint8_t>(0x11 * i + 3));
+    }
+}
+
+// Compares registers, flags, halt state and the RAM used by the ROM.
+static bool sameState(Emulator& lhs, Emulator& rhs) {
+    CPUState a = lhs.getCPUState();
+    CPUState b = rhs.getCPUState();
+    bool regs = a.a == b.a && a.b == b.b && a.c == b.c && a.d == b.d &&
+                a.e == b.e && a.h == b.h && a.l == b.l &&
+                a.sp == b.sp && a.pc == b.pc && a.halted == b.halted;
+    bool flags = a.flags.z == b.flags.z && a.flags.s == b.flags.s &&
+                 a.flags.p == b.flags.p && a.flags.cy == b.flags.cy &&
+                 a.flags.ac == b.flags.ac;
+    bool ram = true;
+    for (uint16_t addr = 0x2000; addr < 0x2400; ++addr) {
+        ram = ram && lhs.getMemoryRef().ReadByte(addr) == rhs.getMemoryRef().ReadByte(addr);
+    }
+    return regs && flags && ram;
+}
+
+// ====================== Unit Test: Generated ROM Linked ====================
+// The recompiled ROM is linked, the backend can be selected, and the
+// loaded bytes hash to the ROM the blocks were generated from.
+void UnitTest_Aot_GeneratedRomLinked() {
+    Emulator emu;
+    bool selected = emu.setCpuBackend(CpuBackend::Aot) && emu.getCpuBackend() == CpuBackend::Aot;
+    loadAotTestRom(emu);
+    bool hashMatches = aot_rom_hash(emu.getMemoryRef()) == AOT_ROM.rom_hash;
+
+    bool hasReset = false, hasRst1 = false, hasCallee = false, hasPchlTarget = false;
+    for (size_t i = 0; i < AOT_ROM.block_count; ++i) {
+        hasReset = hasReset || AOT_ROM.blocks[i].start == 0x0000;
+        hasRst1 = hasRst1 || AOT_ROM.blocks[i].start == 0x0008;
+        hasCallee = hasCallee || AOT_ROM.blocks[i].start == 0x0090;
+        hasPchlTarget = hasPchlTarget || AOT_ROM.blocks[i].start == 0x00B0;
+    }
+
+    printTestResult("AOT", "Generated ROM linked, backend selectable, ROM hash matches",
+                    selected && hashMatches);
+    printTestResult("AOT", "Blocks at reset, RST 1 and CALL targets; none behind PCHL",
+                    hasReset && hasRst1 && hasCallee && !hasPchlTarget);
+}
+
+// ====================== Unit Test: One Batch ===============================
+// The whole ROM runs to HLT in one emulateCycles() batch.
+void UnitTest_Aot_OneBatch() {
+    Emulator table, aot;
+    aot.setCpuBackend(CpuBackend::Aot);
+    loadAotTestRom(table);
+    loadAotTestRom(aot);
+
+    int tableCycles = table.emulateCycles(AOT_TEST_ROM_CYCLES);
+    int aotCycles = aot.emulateCycles(AOT_TEST_ROM_CYCLES);
+
+    printTestResult("AOT", "One batch: reaches HLT with the table core's state and cycles",
+                    table.getCPUState().halted && sameState(table, aot) && tableCycles == aotCycles);
+}
+
+// ====================== Unit Test: Split Batches ===========================
+// A block only runs if the table loop would still start its last
+// instruction, so every batch size stops at the same instruction.
+// Batches longer than the blocks also check the cycles each one reports.
+void UnitTest_Aot_SplitBatches() {
+    bool pass = true;
+    for (int batch = 1; batch <= 256; ++batch) {
+        Emulator table, aot;
+        aot.setCpuBackend(CpuBackend::Aot);
+        loadAotTestRom(table);
+        loadAotTestRom(aot);
+
+        int done = 0;
+        while (pass && done < AOT_TEST_ROM_CYCLES) {
+            int tableCycles = table.emulateCycles(batch);
+            int aotCycles = aot.emulateCycles(batch);
+            pass = tableCycles == aotCycles && sameState(table, aot);
+            done += tableCycles;
+        }
+    }
+
+    printTestResult("AOT", "Batches of 1-256 cycles: same state and cycles after every batch", pass);
+}
+
+int main() {
+    resetTestCounter();
+
+    std::cout << "=== Starting AOT Backend Tests ===\n";
+    UnitTest_Aot_GeneratedRomLinked();
+    UnitTest_Aot_OneBatch();
+    UnitTest_Aot_SplitBatches();
+    std::cout << "=== AOT Backend Tests Complete ===\n\n";
+
+    int totalTests = testsPassed + testsFailed;
+    std::cout << "\n==============================\n";
+    std::cout << " AOT Backend Test Summary\n";
+    std::cout << "------------------------------\n";
+    std::cout << " Total Tests : " << totalTests << "\n";
+    std::cout << GREEN << " Passed      : " << testsPassed << RESET << "\n";
+    std::cout << RED   << " Failed      : " << testsFailed << RESET << "\n";
+    std::cout << "==============================\n";
+
+    return testsFailed == 0 ? 0 : 1;
+}
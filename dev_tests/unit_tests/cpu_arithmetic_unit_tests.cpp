@@ -92,6 +92,22 @@ void UnitTest_ADD_FF() {
     printTestResult("ADD 0xFF", "A = 0x02 + 0xFF → A = 0x01, CY = 1", cpu.a == 0x01 && cpu.flags.cy);
 }
 
+// ====================== Unit Test: ADD B Aux Carry ======================
+// ADD B: A = 0x8F + 0x80 → 0x0F, CY = 1, AC = 0 (no carry out of bit 3)
+void UnitTest_ADD_B_AuxCarry() {
+    CPUState state = runSingleInstruction({0x80}, [](CPUState& cpu) {
+        cpu.a = 0x8F;
+        cpu.b = 0x80;
+    });
+#ifdef ENABLE_VERBOSE_DEBUG
+    printArithmeticDebug("ADD B Aux Carry",
+        0x8F, 0x80, false, state.a, state.flags,
+        0x0F, true, false, false, std::nullopt, false);
+#endif
+    printTestResult("ADD B Aux Carry", "A = 0x8F + 0x80 → A = 0x0F, CY = 1, AC = 0",
+                    state.a == 0x0F && state.flags.cy && !state.flags.ac);
+}
+
 // ====================== Unit Test: ADC B ===============================
 // ADC B: A = A + B + CY
 void UnitTest_ADC_B() {
@@ -286,6 +302,20 @@ void UnitTest_INR_A_Wrap() {
     printTestResult("INR A Wrap", "A = 0xFF + 1 → A = 0x00, Z = 1", state.a == 0x00 && state.flags.z);
 }
 
+// ====================== Unit Test: INR B Parity =========================
+// INR B: B = 0x02 + 1 → 0x03 (two bits set), P = 1 on even parity
+void UnitTest_INR_B_Parity() {
+    CPUState state = runSingleInstruction({0x04}, [](CPUState& cpu) {
+        cpu.b = 0x02;
+    });
+#ifdef ENABLE_VERBOSE_DEBUG
+    printArithmeticDebug("INR B Parity",
+        0x02, 0x01, false, state.b, state.flags,
+        0x03, false, false, false, true);
+#endif
+    printTestResult("INR B Parity", "B = 0x02 + 1 → B = 0x03, P = 1", state.b == 0x03 && state.flags.p);
+}
+
 // ====================== Unit Test: INR M ===============================
 // INR M: Increment memory at HL
 void UnitTest_INR_Memory() {
@@ -559,6 +589,7 @@ int main() {
     UnitTest_ADD_C_WithCarry();
     UnitTest_ADD_AA();
     UnitTest_ADD_FF();
+    UnitTest_ADD_B_AuxCarry();
     UnitTest_ADC_B();
     UnitTest_ADI_Immediate();
     UnitTest_ACI_Immediate();
@@ -579,6 +610,7 @@ int main() {
     std::cout << "=== Starting INR / DCR Tests (Register and Memory) Tests ===\n";
     UnitTest_INR_C();
     UnitTest_INR_A_Wrap();
+    UnitTest_INR_B_Parity();
     UnitTest_INR_Memory();
     UnitTest_DCR_D();
     UnitTest_DCR_B_Zero();
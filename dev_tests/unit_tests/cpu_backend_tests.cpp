@@ -0,0 +1,482 @@
+// ============================================================================
+// CPU Backend Unit Tests - Table Interpreter vs Threaded / Block Cache / JIT / AOT
+// ----------------------------------------------------------------------------
+// Target Module : CPU / Emulator (Intel 8080 Emulator)
+// Purpose       : Validates runtime backend selection and checks that the
+//                 threaded (computed-goto), block cache, JIT and AOT cores produce
+//                 the same registers, flags and memory as the dispatch table core.
+// Scope         : Runs the same small programs on both backends, in one
+//                 cycle budget and split into 1-cycle batches (each runs
+//                 exactly one instruction).
+//
+// Author        : Jese/Arnav
+// Date          : 10/16/26
+// ============================================================================
+
+//=========================== Define ==========================================
+#define ENABLE_COLOR_OUTPUT
+#define ENABLE_CPU_TESTING
+
+// ========================== Include ========================================
+#include "../../src/model/emulator.hpp"
+#include "../support/test_utils.hpp"
+#include <iostream>
+
+// Sums the bytes 0x2100-0x210F into A with a CALLed subroutine,
+// exercising MVI/LXI, MOV M, ADD, INX, DCR, JNZ, PUSH/POP PSW, STA and RET.
+static const std::vector<uint8_t> SUM_PROGRAM = {
+    0x31, 0x00, 0x24,       // 0000: LXI SP,2400
+    0x21, 0x00, 0x21,       // 0003: LXI H,2100
+    0x0E, 0x10,             // 0006: MVI C,10
+    0xAF,                   // 0008: XRA A
+    0xCD, 0x10, 0x00,       // 0009: CALL 0010
+    0x32, 0x00, 0x22,       // 000C: STA 2200
+    0x76,                   // 000F: HLT
+    0x86,                   // 0010: ADD M
+    0xF5,                   // 0011: PUSH PSW
+    0x23,                   // 0012: INX H
+    0xF1,                   // 0013: POP PSW
+    0x0D,                   // 0014: DCR C
+    0xC2, 0x10, 0x00,       // 0015: JNZ 0010
+    0x27,                   // 0018: DAA
+    0xC9,                   // 0019: RET
+};
+
+// Cycles from reset up to and including the HLT at 0x000F.
+static const int SUM_PROGRAM_CYCLES = 850;
+
+// Every backend, in CpuBackend order.
+static const CpuBackend ALL_BACKENDS[] = {
+    CpuBackend::Interpreter, CpuBackend::Threaded, CpuBackend::BlockCache, CpuBackend::Jit, CpuBackend::Aot,
+};
+
+// Loads SUM_PROGRAM and its data into a fresh emulator.
+static void loadSumProgram(Emulator& emu) {
+    Memory& mem = emu.getMemoryRef();
+    writeRomInstructionSequence(mem, 0x0000, SUM_PROGRAM);
+    for (uint16_t i = 0; i < 0x10; ++i) {
+        mem.WriteByte(0x2100 + i, static_cast<uint8_t>(0x11 * i + 3));
+    }
+}
+
+// Runs `cycles` as 1-cycle batches: one instruction each, with the
+// overshoot returned by emulateCycles() counted like a long batch does.
+static void runInSingleSteps(Emulator& emu, int cycles) {
+    int done = 0;
+    while (done < cycles) {
+        done += emu.emulateCycles(1);
+    }
+}
+
+// Compares registers, flags and the RAM used by the program.
+static bool sameState(Emulator& lhs, Emulator& rhs) {
+    CPUState a = lhs.getCPUState();
+    CPUState b = rhs.getCPUState();
+    bool regs = a.a == b.a && a.b == b.b && a.c == b.c && a.d == b.d &&
+                a.e == b.e && a.h == b.h && a.l == b.l &&
+                a.sp == b.sp && a.pc == b.pc;
+    bool flags = a.flags.z == b.flags.z && a.flags.s == b.flags.s &&
+                 a.flags.p == b.flags.p && a.flags.cy == b.flags.cy &&
+                 a.flags.ac == b.flags.ac;
+    bool ram = true;
+    for (uint16_t addr = 0x2000; addr < 0x2400; ++addr) {
+        ram = ram && lhs.getMemoryRef().ReadByte(addr) == rhs.getMemoryRef().ReadByte(addr);
+    }
+    return regs && flags && ram;
+}
+
+// ====================== Unit Test: Backend Selection ========================
+// The table interpreter is the default, the threaded core can be selected.
+void UnitTest_BackendSelection() {
+    Emulator emu;
+    bool defaultOk = emu.getCpuBackend() == CpuBackend::Interpreter;
+    bool selected = emu.setCpuBackend(CpuBackend::Threaded);
+    bool threadedOk = emu.getCpuBackend() == CpuBackend::Threaded;
+    emu.setCpuBackend(CpuBackend::Interpreter);
+    bool backOk = emu.getCpuBackend() == CpuBackend::Interpreter;
+
+    printTestResult("Backend Select", "Default Interpreter, switch to Threaded and back",
+                    defaultOk && selected && threadedOk && backOk);
+}
+
+// ====================== Unit Test: Same Result, One Batch ===================
+// Both backends run SUM_PROGRAM to HLT in a single emulateCycles() batch.
+void UnitTest_SumProgram_OneBatch() {
+    Emulator table, threaded;
+    threaded.setCpuBackend(CpuBackend::Threaded);
+    loadSumProgram(table);
+    loadSumProgram(threaded);
+
+    table.emulateCycles(SUM_PROGRAM_CYCLES);
+    threaded.emulateCycles(SUM_PROGRAM_CYCLES);
+
+    uint8_t stored = threaded.getMemoryRef().ReadByte(0x2200);
+    printTestResult("Threaded Batch", "Sum program matches the table core, result stored at 0x2200",
+                    sameState(table, threaded) && stored == table.getCPUState().a);
+}
+
+// ====================== Unit Test: Same Result, Single Steps ================
+// The threaded core writes its locals back after every batch, so stepping
+// one instruction at a time must match a single long batch.
+void UnitTest_SumProgram_SingleSteps() {
+    Emulator batched, stepped;
+    batched.setCpuBackend(CpuBackend::Threaded);
+    stepped.setCpuBackend(CpuBackend::Threaded);
+    loadSumProgram(batched);
+    loadSumProgram(stepped);
+
+    batched.emulateCycles(SUM_PROGRAM_CYCLES);
+    runInSingleSteps(stepped, SUM_PROGRAM_CYCLES);
+
+    printTestResult("Threaded Step", "Single-instruction batches match one 850-cycle batch",
+                    sameState(batched, stepped));
+}
+
+// ====================== Unit Test: State Edits Between Batches ==============
+// Changes made to CPUState between batches are picked up by the next batch.
+void UnitTest_StateEditBetweenBatches() {
+    Emulator emu;
+    emu.setCpuBackend(CpuBackend::Threaded);
+    writeRomInstructionSequence(emu.getMemoryRef(), 0x0000, {0x3C, 0x3C}); // INR A; INR A
+
+    emu.emulateCycles(1);
+    emu.getCPUStateRef().a = 0x41;
+    emu.emulateCycles(1);
+
+    CPUState state = emu.getCPUState();
+    printTestResult("Threaded Reload", "A edited to 0x41 between batches → INR A gives 0x42",
+                    state.a == 0x42 && state.pc == 0x0002);
+}
+
+// ====================== Unit Test: Block Cache Matches Table ===============
+// Whole ROM blocks per dispatch, and partial blocks when a batch ends
+// mid-block, give the same state as the table core.
+void UnitTest_BlockCache_SumProgram() {
+    Emulator table, batched, stepped;
+    batched.setCpuBackend(CpuBackend::BlockCache);
+    stepped.setCpuBackend(CpuBackend::BlockCache);
+    loadSumProgram(table);
+    loadSumProgram(batched);
+    loadSumProgram(stepped);
+
+    table.emulateCycles(SUM_PROGRAM_CYCLES);
+    batched.emulateCycles(SUM_PROGRAM_CYCLES);
+    runInSingleSteps(stepped, SUM_PROGRAM_CYCLES);
+
+    printTestResult("Block Cache", "Sum program matches the table core in one batch and in single steps",
+                    sameState(table, batched) && sameState(table, stepped));
+}
+
+// ====================== Unit Test: Block Cache ROM Reload ===================
+// Writing the ROM between batches drops the blocks decoded from the old bytes.
+void UnitTest_BlockCache_RomRewrite() {
+    Emulator emu;
+    emu.setCpuBackend(CpuBackend::BlockCache);
+    Memory& mem = emu.getMemoryRef();
+    writeRomInstructionSequence(mem, 0x0000, {0x3E, 0x11, 0xC3, 0x00, 0x00}); // MVI A,11; JMP 0000
+
+    emu.emulateCycles(17); // MVI (7) + JMP (10)
+    bool firstOk = emu.getCPUState().a == 0x11;
+    mem.writeRomBytes(0x0001, 0x22); // MVI A,22
+    emu.emulateCycles(17);
+
+    printTestResult("Block Cache", "ROM rewritten between batches → new MVI operand is used",
+                    firstOk && emu.getCPUState().a == 0x22);
+}
+
+// Copies 8 bytes 0x2100 → 0x2200 between a PUSH and a POP run, then counts
+// BC down from 3: the idioms the block cache fuses into superinstructions.
+static const std::vector<uint8_t> FUSION_PROGRAM = {
+    0x31, 0x00, 0x24,       // 0000: LXI SP,2400
+    0x11, 0x00, 0x21,       // 0003: LXI D,2100
+    0x21, 0x00, 0x22,       // 0006: LXI H,2200
+    0x06, 0x08,             // 0009: MVI B,08
+    0xC5, 0xD5, 0xE5, 0xF5, // 000B: PUSH B; PUSH D; PUSH H; PUSH PSW
+    0x1A,                   // 000F: LDAX D
+    0x77,                   // 0010: MOV M,A
+    0x23,                   // 0011: INX H
+    0x13,                   // 0012: INX D
+    0x05,                   // 0013: DCR B
+    0xC2, 0x0F, 0x00,       // 0014: JNZ 000F
+    0xF1, 0xE1, 0xD1, 0xC1, // 0017: POP PSW; POP H; POP D; POP B
+    0x01, 0x03, 0x00,       // 001B: LXI B,0003
+    0x0B,                   // 001E: DCX B
+    0x78,                   // 001F: MOV A,B
+    0xB1,                   // 0020: ORA C
+    0xC2, 0x1E, 0x00,       // 0021: JNZ 001E
+    0x76,                   // 0024: HLT
+};
+
+// Cycles from reset up to and including the HLT at 0x0024.
+static const int FUSION_PROGRAM_CYCLES = 522;
+
+// ====================== Unit Test: Block Cache Superinstructions ===========
+// Fused copy loop, countdown and PUSH/POP runs give the same state as the
+// table core, whole and when batches split the fused ops.
+void UnitTest_BlockCache_Fusion() {
+    Emulator table, batched, stepped;
+    batched.setCpuBackend(CpuBackend::BlockCache);
+    stepped.setCpuBackend(CpuBackend::BlockCache);
+    for (Emulator* emu : {&table, &batched, &stepped}) {
+        Memory& mem = emu->getMemoryRef();
+        writeRomInstructionSequence(mem, 0x0000, FUSION_PROGRAM);
+        for (uint16_t i = 0; i < 0x08; ++i) {
+            mem.WriteByte(0x2100 + i, static_cast<uint8_t>(0x80 - 0x10 * i));
+        }
+    }
+
+    table.emulateCycles(FUSION_PROGRAM_CYCLES);
+    batched.emulateCycles(FUSION_PROGRAM_CYCLES);
+    runInSingleSteps(stepped, FUSION_PROGRAM_CYCLES);
+
+    bool copied = batched.getMemoryRef().ReadByte(0x2207) == 0x10;
+    printTestResult("Block Cache", "Fused copy/countdown/PUSH/POP match the table core in one batch and in single steps",
+                    copied && sameState(table, batched) && sameState(table, stepped));
+}
+
+// ====================== Unit Test: JIT Matches Table =======================
+// Native ROM blocks (chained JMP/CALL, RET through the dispatcher, DAA via
+// its handler) give the same state as the table core, whole and stepped.
+void UnitTest_Jit_SumProgram() {
+    Emulator table, batched, stepped;
+    if (!batched.setCpuBackend(CpuBackend::Jit) || !stepped.setCpuBackend(CpuBackend::Jit)) {
+        printTestResult("JIT", "Not available on this host → backend stays Interpreter",
+                        batched.getCpuBackend() == CpuBackend::Interpreter);
+        return;
+    }
+    loadSumProgram(table);
+    loadSumProgram(batched);
+    loadSumProgram(stepped);
+
+    table.emulateCycles(SUM_PROGRAM_CYCLES);
+    batched.emulateCycles(SUM_PROGRAM_CYCLES);
+    runInSingleSteps(stepped, SUM_PROGRAM_CYCLES);
+
+    printTestResult("JIT", "Sum program matches the table core in one batch and in single steps",
+                    sameState(table, batched) && sameState(table, stepped));
+}
+
+// ====================== Unit Test: AOT Matches Table =======================
+// Blocks recompiled at build time run when the loaded ROM is the one
+// they were generated from; any other ROM is interpreted. Either way
+// the state matches the table core. This build links the stub or the
+// real ROM, so generated blocks are covered by aot_backend_tests.cpp.
+void UnitTest_Aot_SumProgram() {
+    Emulator table, batched, stepped;
+    if (!batched.setCpuBackend(CpuBackend::Aot) || !stepped.setCpuBackend(CpuBackend::Aot)) {
+        printTestResult("AOT", "No recompiled ROM linked → backend stays Interpreter",
+                        batched.getCpuBackend() == CpuBackend::Interpreter);
+        return;
+    }
+    loadSumProgram(table);
+    loadSumProgram(batched);
+    loadSumProgram(stepped);
+
+    table.emulateCycles(SUM_PROGRAM_CYCLES);
+    batched.emulateCycles(SUM_PROGRAM_CYCLES);
+    runInSingleSteps(stepped, SUM_PROGRAM_CYCLES);
+
+    printTestResult("AOT", "Sum program matches the table core in one batch and in single steps",
+                    sameState(table, batched) && sameState(table, stepped));
+}
+
+// ====================== Unit Test: Cycle Budget ============================
+// emulateCycles() counts 8080 cycles, not instructions: a 10-cycle budget
+// runs three 4-cycle NOPs and reports the 2-cycle overshoot.
+void UnitTest_CycleBudget() {
+    bool pass = true;
+    for (CpuBackend backend : ALL_BACKENDS) {
+        Emulator emu;
+        emu.setCpuBackend(backend);
+        writeRomInstructionSequence(emu.getMemoryRef(), 0x0000, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00});
+        int first = emu.emulateCycles(10);
+        int second = emu.emulateCycles(1);
+        pass = pass && first == 12 && second == 4 && emu.getCPUState().pc == 0x0004;
+    }
+
+    printTestResult("Cycle Budget", "10 cycles → 3 NOPs, 12 cycles reported, on every backend", pass);
+}
+
+// Counts B down from 5 (a loop that changes state), then polls 0x2000
+// until it is non-zero (an idle loop), then halts.
+static const std::vector<uint8_t> POLL_PROGRAM = {
+    0x31, 0x00, 0x24,       // 0000: LXI SP,2400
+    0x06, 0x05,             // 0003: MVI B,05
+    0x05,                   // 0005: DCR B
+    0xC2, 0x05, 0x00,       // 0006: JNZ 0005
+    0x3A, 0x00, 0x20,       // 0009: LDA 2000
+    0xA7,                   // 000C: ANA A
+    0xCA, 0x09, 0x00,       // 000D: JZ 0009
+    0x76,                   // 0010: HLT
+};
+
+// ====================== Unit Test: Idle Loop Fast-Forward ===================
+// A long batch skips the polling spin; single steps never skip. Both must
+// stop at the same instruction with the same state on every backend, and
+// the loop must still exit once the polled flag is set.
+void UnitTest_IdleLoop_Skip() {
+    bool pass = true;
+    for (CpuBackend backend : ALL_BACKENDS) {
+        Emulator batched, stepped;
+        batched.setCpuBackend(backend);
+        stepped.setCpuBackend(backend);
+        writeRomInstructionSequence(batched.getMemoryRef(), 0x0000, POLL_PROGRAM);
+        writeRomInstructionSequence(stepped.getMemoryRef(), 0x0000, POLL_PROGRAM);
+
+        int done = batched.emulateCycles(5003);
+        runInSingleSteps(stepped, 5003);
+        bool same = sameState(batched, stepped) && done == static_cast<int>(stepped.getCycleCount());
+
+        batched.getMemoryRef().WriteByte(0x2000, 0x01);
+        batched.emulateCycles(100);
+        bool exited = batched.getCPUState().halted && batched.getCPUState().pc == 0x0011;
+
+        pass = pass && same && exited;
+    }
+
+    printTestResult("Idle Loop", "Skipped polling spin matches single steps, loop exits once the flag is set",
+                    pass);
+}
+
+// Polls 0x2000 with flags that change inside each iteration: CPI sets
+// S and clears Z, ORA A puts Z back before the jump to the head.
+static const std::vector<uint8_t> FLAG_POLL_PROGRAM = {
+    0x31, 0x00, 0x24,       // 0000: LXI SP,2400
+    0xAF,                   // 0003: XRA A
+    0x3A, 0x00, 0x20,       // 0004: LDA 2000
+    0xFE, 0x80,             // 0007: CPI 80
+    0xB7,                   // 0009: ORA A
+    0xCA, 0x04, 0x00,       // 000A: JZ 0004
+    0x76,                   // 000D: HLT
+};
+
+// ====================== Unit Test: Idle Loop, Batch Ends Mid-Iteration ======
+// A batch that ends inside an idle loop iteration leaves the flags of the
+// last instruction run, e.g. CPI's S/Z, not those seen at the loop head.
+// Every batch size is compared with the table core after each batch.
+void UnitTest_IdleLoop_MidIterationFlags() {
+    bool pass = true;
+    for (CpuBackend backend : ALL_BACKENDS) {
+        for (int batch = 1; batch <= 60 && pass; ++batch) {
+            Emulator table, other;
+            other.setCpuBackend(backend);
+            writeRomInstructionSequence(table.getMemoryRef(), 0x0000, FLAG_POLL_PROGRAM);
+            writeRomInstructionSequence(other.getMemoryRef(), 0x0000, FLAG_POLL_PROGRAM);
+
+            int done = 0;
+            while (pass && done < 600) {
+                int tableCycles = table.emulateCycles(batch);
+                int otherCycles = other.emulateCycles(batch);
+                pass = tableCycles == otherCycles && sameState(table, other);
+                done += tableCycles;
+            }
+        }
+    }
+
+    printTestResult("Idle Loop", "Batches ending mid-iteration keep the table core's flags on every backend",
+                    pass);
+}
+
+// ====================== Unit Test: Idle Loop vs Memory Slow Path ============
+// Counted and watched reads are never skipped: a long batch fires the same
+// watchpoint callbacks and counts the same reads as single steps.
+void UnitTest_IdleLoop_SlowPath() {
+    const Memory::AccessPolicy policies[] = {Memory::AccessPolicy::Counting, Memory::AccessPolicy::Watching};
+    const int CYCLES = 100000;
+    bool pass = true;
+    for (CpuBackend backend : ALL_BACKENDS) {
+        for (Memory::AccessPolicy policy : policies) {
+            Emulator batched, stepped;
+            int batchedHits = 0, steppedHits = 0;
+            Emulator* emus[] = {&batched, &stepped};
+            int* hits[] = {&batchedHits, &steppedHits};
+            for (int i = 0; i < 2; ++i) {
+                emus[i]->setCpuBackend(backend);
+                writeRomInstructionSequence(emus[i]->getMemoryRef(), 0x0000, POLL_PROGRAM);
+                emus[i]->setMemoryAccessPolicy(policy);
+                emus[i]->getMemoryRef().SetWatchCallback([count = hits[i]](uint16_t, uint8_t, bool) { ++*count; });
+                emus[i]->getMemoryRef().AddWatchpoint(0x2000, Memory::WATCH_READ);
+            }
+
+            int done = batched.emulateCycles(CYCLES);
+            runInSingleSteps(stepped, CYCLES);
+            pass = pass && sameState(batched, stepped) && done == static_cast<int>(stepped.getCycleCount()) &&
+                   batchedHits > 1000 && batchedHits == steppedHits &&
+                   batched.getMemoryRef().GetReadCount(0x2000) == stepped.getMemoryRef().GetReadCount(0x2000);
+        }
+    }
+
+    printTestResult("Idle Loop", "Watched/counted polling is not skipped: callbacks and read counts match single steps",
+                    pass);
+}
+
+// ====================== Unit Test: HLT ======================================
+// HLT idles out the batch on every backend; an interrupt resumes after it.
+void UnitTest_Halt() {
+    static const std::vector<uint8_t> HALT_PROGRAM = {
+        0x31, 0x00, 0x24,   // 0000: LXI SP,2400
+        0xFB,               // 0003: EI
+        0x76,               // 0004: HLT
+        0x3E, 0x42,         // 0005: MVI A,42
+        0x76,               // 0007: HLT
+        0xFB,               // 0008: EI
+        0xC9,               // 0009: RET
+    };
+
+    bool pass = true;
+    for (CpuBackend backend : ALL_BACKENDS) {
+        Emulator emu;
+        emu.setCpuBackend(backend);
+        writeRomInstructionSequence(emu.getMemoryRef(), 0x0000, HALT_PROGRAM);
+
+        bool idle = emu.emulateCycles(1000) == 1000 && emu.getCPUState().halted &&
+                    emu.getCPUState().pc == 0x0005;
+        emu.requestInterrupt(1);
+        bool woken = !emu.getCPUState().halted;
+        emu.emulateCycles(1000);
+        bool resumed = emu.getCPUState().a == 0x42 && emu.getCPUState().pc == 0x0008 &&
+                       emu.getCPUState().halted;
+
+        // Halted from the first HLT on, a frame is exactly CYCLES_PER_FRAME.
+        Emulator framed;
+        framed.setCpuBackend(backend);
+        writeRomInstructionSequence(framed.getMemoryRef(), 0x0000, HALT_PROGRAM);
+        bool exact = framed.runUntilFrameEnd() == Emulator::CYCLES_PER_FRAME;
+
+        pass = pass && idle && woken && resumed && exact;
+    }
+
+    printTestResult("HLT", "Halt idles the batch, RST wakes it, frames stay exact", pass);
+}
+
+int main() {
+    resetTestCounter();
+
+    std::cout << "=== Starting CPU Backend Tests ===\n";
+    UnitTest_BackendSelection();
+    UnitTest_SumProgram_OneBatch();
+    UnitTest_SumProgram_SingleSteps();
+    UnitTest_StateEditBetweenBatches();
+    UnitTest_BlockCache_SumProgram();
+    UnitTest_BlockCache_RomRewrite();
+    UnitTest_BlockCache_Fusion();
+    UnitTest_Jit_SumProgram();
+    UnitTest_Aot_SumProgram();
+    UnitTest_CycleBudget();
+    UnitTest_IdleLoop_Skip();
+    UnitTest_IdleLoop_SlowPath();
+    UnitTest_IdleLoop_MidIterationFlags();
+    UnitTest_Halt();
+    std::cout << "=== CPU Backend Tests Complete ===\n\n";
+
+    int totalTests = testsPassed + testsFailed;
+    std::cout << "\n==============================\n";
+    std::cout << " CPU Backend Test Summary\n";
+    std::cout << "------------------------------\n";
+    std::cout << " Total Tests : " << totalTests << "\n";
+    std::cout << GREEN << " Passed      : " << testsPassed << RESET << "\n";
+    std::cout << RED   << " Failed      : " << testsFailed << RESET << "\n";
+    std::cout << "==============================\n";
+
+    return 0;
+}
@@ -411,7 +411,7 @@ void UnitTest_Basic_PUSH_POP() {
     cpu.pc = 0x0000;
 
     writeRomInstructionSequence(mem, 0x0000, { 0xC5, 0xD5, 0xD1, 0xC1 });
-    emu.emulateCycles(4);
+    emu.emulateCycles(42); // 2 x PUSH (11) + 2 x POP (10)
 
     const bool dRestored = (cpu.d == 0x33 && cpu.e == 0x44);
     const bool bRestored = (cpu.b == 0x11 && cpu.c == 0x22);
@@ -449,7 +449,7 @@ void UnitTest_Nested_PUSH_POP() {
     };
 
     writeRomInstructionSequence(mem, 0x0000, opcodes);
-    emu.emulateCycles(opcodes.size());
+    emu.emulateCycles(63); // 3 x PUSH (11) + 3 x POP (10)
 
     //  Validate: All registers restored correctly and SP reset
     bool pass = (cpu.b == 0x11 && cpu.c == 0x22 &&
@@ -480,7 +480,7 @@ void UnitTest_CALL_RET() {
     // CALL 0x1234 (CD 34 12)
     writeRomInstructionSequence(mem, 0x0000, { 0xCD, 0x34, 0x12 }); // CALL
     writeRomInstructionSequence(mem, 0x1234, { 0xC9 });             // RET at target
-    emu.emulateCycles(2); // CALL and RET
+    emu.emulateCycles(27); // CALL (17) and RET (10)
 
     StackInspector inspector(mem, 0x2FFE);  // After CALL, SP = 0x2FFE
 
@@ -0,0 +1,138 @@
+// ============================================================================
+// Frame Pacer Unit Tests
+// ----------------------------------------------------------------------------
+// Target Module : FramePacer (Controller, Intel 8080 Emulator)
+// Purpose       : Validates that frames are paced on absolute deadlines
+//                 without drift, that jitter is recorded, and that the
+//                 pacer sleeps instead of spinning between frames.
+// Scope         : Timing only, no emulation. Bounds are loose enough for
+//                 a loaded CI host; the ±0.5 ms target is checked on the
+//                 95th percentile jitter, resyncs are checked on their own.
+//
+// Author        : Jesse/Sergio
+// Date          : 10/16/26
+// ============================================================================
+
+//=========================== Define ==========================================
+#define ENABLE_COLOR_OUTPUT
+
+// ========================== Include ========================================
+#include "../../src/controller/frame_pacer.hpp"
+#include "../support/test_utils.hpp"
+#include <algorithm>
+#include <ctime>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Short frames keep the test fast: 30 frames at 120 Hz = 250 ms.
+static const uint32_t TEST_FPS = 120;
+static const int TEST_FRAMES = 30;
+static const int64_t TEST_PERIOD_NS = 1000000000 / TEST_FPS;
+
+// ====================== Unit Test: No Drift =================================
+// N frames end N periods after start(), even with slow frames in between.
+void UnitTest_FramePacer_NoDrift() {
+    FramePacer pacer(TEST_FPS);
+    pacer.start();
+    int64_t begin = FramePacer::nowNs();
+    for (int i = 0; i < TEST_FRAMES; ++i) {
+        if (i % 5 == 0) {
+            // A frame that takes half a period does not push the schedule.
+            std::this_thread::sleep_for(std::chrono::nanoseconds(TEST_PERIOD_NS / 2));
+        }
+        pacer.waitForNextFrame();
+    }
+    int64_t elapsed = FramePacer::nowNs() - begin;
+    int64_t expected = TEST_FRAMES * TEST_PERIOD_NS;
+
+    FrameTiming stats = pacer.getStats();
+    printTestResult("Frame Pacer", "30 frames take 30 periods (±1 ms), jitter recorded per frame",
+                    std::llabs(elapsed - expected) < 1000000 && stats.frames == TEST_FRAMES &&
+                    stats.resyncs == 0);
+}
+
+// ====================== Unit Test: Jitter ===================================
+// 95th percentile |jitter| stays inside the ±0.5 ms target, so one
+// preempted frame cannot fail it. Resynced frames are counted, not sampled.
+void UnitTest_FramePacer_Jitter() {
+    FramePacer pacer(TEST_FPS);
+    pacer.start();
+    std::vector<int64_t> jitter;
+    for (int i = 0; i < TEST_FRAMES; ++i) {
+        uint64_t resyncs = pacer.getStats().resyncs;
+        pacer.waitForNextFrame();
+        FrameTiming stats = pacer.getStats();
+        if (stats.resyncs == resyncs) {
+            jitter.push_back(std::llabs(stats.last_jitter_ns));
+        }
+    }
+    FrameTiming stats = pacer.getStats();
+
+    bool sampled = !jitter.empty();
+    int64_t p95 = 0;
+    if (sampled) {
+        size_t rank = (jitter.size() * 95 + 99) / 100 - 1;
+        std::nth_element(jitter.begin(), jitter.begin() + rank, jitter.end());
+        p95 = jitter[rank];
+    }
+    std::cout << "  p95 |jitter|: " << p95 << " ns, resyncs: " << stats.resyncs << "\n";
+    printTestResult("Frame Pacer", "95th percentile frame jitter below 0.5 ms",
+                    sampled && p95 < FramePacer::LATE_NS && stats.spin_ns > 0);
+    printTestResult("Frame Pacer", "An idle pacer never resyncs", stats.resyncs == 0);
+}
+
+// ====================== Unit Test: Sleeps Between Frames ====================
+// An idle pacer spends most of each period asleep, not spinning.
+void UnitTest_FramePacer_Sleeps() {
+    FramePacer pacer(TEST_FPS);
+    pacer.start();
+    std::clock_t cpuBegin = std::clock();
+    for (int i = 0; i < TEST_FRAMES; ++i) {
+        pacer.waitForNextFrame();
+    }
+    double cpuSeconds = static_cast<double>(std::clock() - cpuBegin) / CLOCKS_PER_SEC;
+    double wallSeconds = static_cast<double>(TEST_FRAMES) / TEST_FPS;
+
+    printTestResult("Frame Pacer", "Host CPU time under 25% of wall time while pacing",
+                    cpuSeconds < 0.25 * wallSeconds);
+}
+
+// ====================== Unit Test: Resync ===================================
+// A stall of many periods starts a new schedule instead of a catch-up burst.
+void UnitTest_FramePacer_Resync() {
+    FramePacer pacer(TEST_FPS);
+    pacer.start();
+    pacer.waitForNextFrame();
+    std::this_thread::sleep_for(std::chrono::nanoseconds(TEST_PERIOD_NS * (FramePacer::MAX_BEHIND + 3)));
+    pacer.waitForNextFrame();
+    int64_t resumed = FramePacer::nowNs();
+    pacer.waitForNextFrame();
+    int64_t gap = FramePacer::nowNs() - resumed;
+
+    FrameTiming stats = pacer.getStats();
+    printTestResult("Frame Pacer", "Long stall → one resync, next frame a full period later",
+                    stats.resyncs == 1 && stats.late_frames >= 1 && gap > TEST_PERIOD_NS / 2);
+}
+
+int main() {
+    resetTestCounter();
+
+    std::cout << "=== Starting Frame Pacer Tests ===\n";
+    UnitTest_FramePacer_NoDrift();
+    UnitTest_FramePacer_Jitter();
+    UnitTest_FramePacer_Sleeps();
+    UnitTest_FramePacer_Resync();
+    std::cout << "=== Frame Pacer Tests Complete ===\n\n";
+
+    int totalTests = testsPassed + testsFailed;
+    std::cout << "\n==============================\n";
+    std::cout << " Frame Pacer Unit Test Summary\n";
+    std::cout << "------------------------------\n";
+    std::cout << " Total Tests : " << totalTests << "\n";
+    std::cout << GREEN << " Passed      : " << testsPassed << RESET << "\n";
+    std::cout << RED   << " Failed      : " << testsFailed << RESET << "\n";
+    std::cout << "==============================\n";
+
+    return 0;
+}
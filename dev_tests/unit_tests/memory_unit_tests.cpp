@@ -20,6 +20,7 @@
 #include "../support/test_utils.hpp"
 #include <cassert>
 #include <iostream>
+#include <vector>
 
 // =================== Unit Test: RAM Zero on Init ====================
 // RAM should be zero-initialized on startup
@@ -120,6 +121,353 @@ void UnitTest_VRAMSizeCheck() {
 }
 
 
+// =================== Unit Test: Page Flags ==============================
+// Every 256-byte page is flagged with the region it belongs to
+void UnitTest_PageFlags() {
+    Memory memory;
+    bool result = (memory.GetPageFlags(0x0000) & Memory::PAGE_ROM) &&
+                  (memory.GetPageFlags(0x1FFF) & Memory::PAGE_ROM) &&
+                  (memory.GetPageFlags(0x2000) & Memory::PAGE_RAM) &&
+                  (memory.GetPageFlags(0x2400) & Memory::PAGE_VRAM) &&
+                  (memory.GetPageFlags(0x3FFF) & Memory::PAGE_VRAM) &&
+                  (memory.GetPageFlags(0x4000) & Memory::PAGE_RAM) &&
+                  !(memory.GetPageFlags(0x4000) & Memory::PAGE_MIRROR);
+    printTestResult("Unit", "Page flags: ROM 0x0000-0x1FFF, RAM, VRAM 0x2400-0x3FFF", result);
+}
+
+// =================== Unit Test: ROM Write Discarded =====================
+// A ROM write lands in the discard page and never shows up on reads
+void UnitTest_ROMWriteDiscarded() {
+    Memory memory;
+    memory.writeRomBytes(0x0100, 0x5A);
+    memory.WriteByte(0x0100, 0xA5);
+    memory.WriteByte(0x1F00, 0xA5);
+    bool result = (memory.ReadByte(0x0100) == 0x5A && memory.ReadByte(0x1F00) == 0x00);
+    printTestResult("Unit", "ROM page writes discarded, ROM contents kept", result);
+}
+
+// =================== Unit Test: Copy Owns Its Pages =====================
+// A copied Memory reads and writes its own storage, not the original's
+void UnitTest_CopyRebuildsPages() {
+    Memory original;
+    original.WriteByte(0x2100, 0x11);
+    Memory copy(original);
+    copy.WriteByte(0x2100, 0x22);
+    bool result = (original.ReadByte(0x2100) == 0x11 && copy.ReadByte(0x2100) == 0x22);
+    printTestResult("Unit", "Copied memory has its own page table", result);
+}
+
+// =================== Unit Test: No Tracking Policy ======================
+// NoTracking leaves every page off the slow path and counts nothing
+void UnitTest_PolicyNoTracking() {
+    Memory memory;
+    memory.SetAccessPolicy(Memory::AccessPolicy::NoTracking);
+    memory.WriteByte(0x2000, 0x01);
+    memory.ReadByte(0x2000);
+    bool fast = true;
+    for (uint32_t addr = 0; addr < Memory::MEMORY_SIZE; addr += Memory::PAGE_SIZE) {
+        fast &= !(memory.GetPageFlags(static_cast<uint16_t>(addr)) & Memory::PAGE_SLOW);
+    }
+    bool result = fast && memory.GetReadCount(0x2000) == 0 && memory.GetWriteCount(0x2000) == 0;
+    printTestResult("Unit", "NoTracking policy: no slow pages, no counters", result);
+}
+
+// =================== Unit Test: Counting Policy =========================
+// Counting records exact per-address reads and writes, ROM writes included
+void UnitTest_PolicyCounting() {
+    Memory memory;
+    memory.SetAccessPolicy(Memory::AccessPolicy::Counting);
+    memory.WriteByte(0x2001, 0x02);
+    memory.WriteByte(0x2001, 0x03);
+    memory.ReadByte(0x2001);
+    memory.ReadByte(0x0000);
+    bool result = memory.GetWriteCount(0x2001) == 2 && memory.GetReadCount(0x2001) == 1 &&
+                  memory.GetReadCount(0x0000) == 1 && memory.ReadByte(0x2001) == 0x03;
+    printTestResult("Unit", "Counting policy: exact read/write counts per address", result);
+}
+
+// =================== Unit Test: Watching Policy =========================
+// Watching flags only the page holding a watchpoint
+void UnitTest_PolicyWatching() {
+    Memory memory;
+    memory.SetAccessPolicy(Memory::AccessPolicy::Watching);
+    memory.AddWatchpoint(0x2105);
+    bool watched = (memory.GetPageFlags(0x2100) & Memory::PAGE_WATCHED) &&
+                   !(memory.GetPageFlags(0x2200) & Memory::PAGE_SLOW);
+    memory.WriteByte(0x2105, 0x44);
+    bool value = memory.ReadByte(0x2105) == 0x44 && memory.GetWriteCount(0x2105) == 0;
+    memory.SetAccessPolicy(Memory::AccessPolicy::NoTracking);
+    bool off = !(memory.GetPageFlags(0x2100) & Memory::PAGE_SLOW);
+    memory.ClearWatchpoints();
+    printTestResult("Unit", "Watching policy: only the watched page is slow", watched && value && off);
+}
+
+// =================== Unit Test: VRAM Dirty Rows ========================
+// A VRAM write marks its 32-byte row once | RAM and ROM writes mark nothing
+void UnitTest_VRAMDirtyRows() {
+    Memory memory;
+    bool cleared = memory.ConsumeDirtyRows().all() && memory.ConsumeDirtyRows().none();
+    memory.WriteByte(0x2000, 0x01);
+    memory.writeRomBytes(0x0100, 0x01);
+    memory.WriteByte(0x0200, 0x01);
+    memory.WriteByte(Memory::VRAM_START + 0x21, 0xFF);  // Row 1
+    memory.WriteByte(Memory::VRAM_END, 0xFF);           // Row 223
+    Memory::DirtyRows rows = memory.ConsumeDirtyRows();
+    bool result = cleared && rows.count() == 2 && rows.test(1) && rows.test(Memory::VRAM_ROWS - 1) &&
+                  memory.ConsumeDirtyRows().none();
+    printTestResult("Unit", "VRAM writes mark exactly their rows, consuming clears them", result);
+}
+
+// =================== Unit Test: Dirty Row Range =========================
+// Consuming one half leaves the other half's rows dirty
+void UnitTest_VRAMDirtyRange() {
+    Memory memory;
+    memory.ConsumeDirtyRows();
+    memory.WriteByte(Memory::VRAM_START, 0x01);
+    memory.WriteByte(Memory::VRAM_END, 0x01);
+    Memory::DirtyRows top = memory.ConsumeDirtyRows(0, Memory::VRAM_ROWS / 2);
+    Memory::DirtyRows rest = memory.ConsumeDirtyRows();
+    bool result = top.count() == 1 && top.test(0) && rest.count() == 1 && rest.test(Memory::VRAM_ROWS - 1);
+    printTestResult("Unit", "Consuming a row range keeps rows outside it", result);
+}
+
+// =================== Unit Test: Word Access ============================
+// Little-endian words, within a page and across pages
+void UnitTest_WordReadWrite() {
+    Memory memory;
+    memory.WriteWord(0x2010, 0xBEEF);
+    memory.WriteWord(0x20FF, 0x1234);   // Crosses into the next page
+    bool result = memory.ReadByte(0x2010) == 0xEF && memory.ReadByte(0x2011) == 0xBE &&
+                  memory.ReadWord(0x2010) == 0xBEEF &&
+                  memory.ReadByte(0x20FF) == 0x34 && memory.ReadByte(0x2100) == 0x12 &&
+                  memory.ReadWord(0x20FF) == 0x1234;
+    printTestResult("Unit", "Word read/write is little-endian, also across pages", result);
+}
+
+// =================== Unit Test: Word Wrap and ROM ======================
+// 0xFFFF + 1 wraps to 0x0000 (ROM, discarded) | Half-ROM words keep the RAM half
+void UnitTest_WordWrapAndROM() {
+    Memory memory;
+    memory.writeRomBytes(0x0000, 0xAA);
+    memory.WriteWord(0xFFFF, 0x5566);
+    bool wrap = memory.ReadByte(0xFFFF) == 0x66 && memory.ReadByte(0x0000) == 0xAA &&
+                memory.ReadWord(0xFFFF) == 0xAA66;
+    memory.WriteWord(0x1FFF, 0x7788);
+    memory.WriteWord(0x0100, 0x7788);
+    bool rom = memory.ReadByte(0x1FFF) == 0x00 && memory.ReadByte(0x2000) == 0x77 &&
+               memory.ReadWord(0x0100) == 0x0000;
+    printTestResult("Unit", "Word at 0xFFFF wraps to 0x0000, ROM bytes stay protected", wrap && rom);
+}
+
+// =================== Unit Test: Word Slow Path =========================
+// Words on flagged pages go byte by byte: counted, watched, marked dirty
+void UnitTest_WordSlowPath() {
+    Memory memory;
+    memory.SetAccessPolicy(Memory::AccessPolicy::Counting);
+    memory.ConsumeDirtyRows();
+    memory.WriteWord(Memory::VRAM_START + 0x1F, 0xFFFF);   // Rows 0 and 1
+    uint16_t value = memory.ReadWord(Memory::VRAM_START + 0x1F);
+    Memory::DirtyRows rows = memory.ConsumeDirtyRows();
+    bool result = value == 0xFFFF && rows.count() == 2 && rows.test(0) && rows.test(1) &&
+                  memory.GetWriteCount(Memory::VRAM_START + 0x1F) == 1 &&
+                  memory.GetReadCount(Memory::VRAM_START + 0x20) == 1;
+    printTestResult("Unit", "Word access on a tracked page counts both bytes, marks both rows", result);
+}
+
+// =================== Unit Test: Watchpoint Callback ======================
+// Only the exact address and kind reach the callback | Removing unflags the page
+void UnitTest_WatchpointCallback() {
+    Memory memory;
+    memory.SetAccessPolicy(Memory::AccessPolicy::Watching);
+    int hits = 0;
+    uint8_t seen = 0;
+    memory.SetWatchCallback([&](uint16_t address, uint8_t value, bool isWrite) {
+        hits += (address == 0x2105 && isWrite) ? 1 : 100;
+        seen = value;
+    });
+    memory.AddWatchpoint(0x2105, Memory::WATCH_WRITE);
+    memory.WriteByte(0x2105, 0x44);
+    memory.ReadByte(0x2105);
+    memory.WriteByte(0x2106, 0x45);
+    memory.WriteByte(0x2140, 0x46);
+    memory.RemoveWatchpoint(0x2105);
+    bool off = !(memory.GetPageFlags(0x2100) & Memory::PAGE_WATCHED);
+    memory.WriteByte(0x2105, 0x47);
+    printTestResult("Unit", "Watchpoint callback: exact address and kind only, removable",
+                    hits == 1 && seen == 0x44 && off);
+}
+
+// =================== Unit Test: COW Snapshot ===========================
+// Only written pages are copied | Restore is exact and repeatable | Reads stay fast
+void UnitTest_SnapshotCopyOnWrite() {
+    Memory memory;
+    memory.SetAccessPolicy(Memory::AccessPolicy::NoTracking);
+    memory.WriteByte(0x2100, 0x11);
+    memory.TakeSnapshot();
+    bool marked = (memory.GetPageFlags(0x2100) & Memory::PAGE_COW) &&
+                  !(memory.GetPageFlags(0x2100) & Memory::PAGE_SLOW) &&
+                  !(memory.GetPageFlags(0x0000) & Memory::PAGE_COW);
+    memory.WriteByte(0x2100, 0x22);
+    memory.WriteByte(0x2101, 0x33);
+    memory.WriteByte(0x3000, 0x44);
+    size_t copied = memory.GetSnapshotPageCount();
+    bool first = memory.RestoreSnapshot() && memory.ReadByte(0x2100) == 0x11 &&
+                 memory.ReadByte(0x2101) == 0x00 && memory.ReadByte(0x3000) == 0x00;
+    memory.WriteByte(0x2100, 0x55);
+    bool second = memory.RestoreSnapshot() && memory.ReadByte(0x2100) == 0x11;
+    printTestResult("Unit", "COW snapshot copies 2 written pages, restores exactly twice",
+                    marked && copied == 2 && first && second);
+}
+
+// =================== Unit Test: Snapshot Chain ==========================
+// Restoring the active snapshot, then the finished one, steps back two snapshots
+void UnitTest_SnapshotChain() {
+    Memory memory;
+    Memory::PageSnapshot older;
+    memory.WriteByte(0x2200, 0x01);
+    memory.TakeSnapshot();
+    memory.WriteByte(0x2200, 0x02);
+    memory.WriteByte(0x4000, 0x02);
+    memory.TakeSnapshot(&older);
+    memory.WriteByte(0x2200, 0x03);
+    bool one = memory.RestoreSnapshot() && memory.ReadByte(0x2200) == 0x02;
+    bool two = memory.RestoreSnapshot(older) && memory.ReadByte(0x2200) == 0x01 &&
+               memory.ReadByte(0x4000) == 0x00;
+    bool back = memory.RestoreSnapshot() && memory.ReadByte(0x2200) == 0x02 &&
+                memory.ReadByte(0x4000) == 0x02;
+    printTestResult("Unit", "Snapshot chain steps back, active snapshot still restorable",
+                    one && two && back);
+}
+
+// =================== Unit Test: Shared ROM ==============================
+// Same bytes, one image | No generation bump on sharing | A ROM write unshares
+void UnitTest_SharedRomAcrossInstances() {
+    const std::vector<uint8_t> code = {0x3E, 0x42, 0x76};
+    Memory first;
+    Memory second;
+    for (uint16_t i = 0; i < code.size(); ++i) {
+        first.writeRomBytes(i, code[i]);
+        second.writeRomBytes(i, code[i]);
+    }
+    uint32_t generation = first.GetRomGeneration();
+    bool privateBefore = !first.IsRomShared() && first.GetRom() != second.GetRom();
+    first.ShareRom();
+    second.ShareRom();
+    bool shared = first.IsRomShared() && first.GetRom() == second.GetRom() &&
+                  first.GetRom().use_count() >= 2 && first.GetRomGeneration() == generation &&
+                  second.ReadByte(0x0001) == 0x42;
+
+    second.writeRomBytes(0x0001, 0x99);
+    bool unshared = !second.IsRomShared() && second.ReadByte(0x0001) == 0x99 &&
+                    first.ReadByte(0x0001) == 0x42 && first.GetRom() != second.GetRom();
+    printTestResult("Unit", "Equal ROMs share one image, a ROM write copies it first",
+                    privateBefore && shared && unshared);
+}
+
+// =================== Unit Test: Shared ROM Lifetime =====================
+// The image is freed with its last instance | Clear() and copies keep RAM private
+void UnitTest_SharedRomLifetime() {
+    std::vector<uint8_t> image(Memory::RAM_START, 0xA5);
+    size_t before = Memory::GetSharedRomCount();
+    bool live = false;
+    bool copyShares = false;
+    bool ramPrivate = false;
+    {
+        Memory memory;
+        memory.AttachRom(Memory::InternRom(image.data()));
+        live = Memory::GetSharedRomCount() == before + 1 && memory.ReadByte(0x1FFF) == 0xA5;
+        Memory copy(memory);
+        copy.WriteByte(0x2000, 0x01);
+        copyShares = copy.GetRom() == memory.GetRom() && memory.ReadByte(0x2000) == 0x00;
+        memory.Clear();
+        ramPrivate = memory.ReadByte(0x1FFF) == 0x00 && copy.ReadByte(0x1FFF) == 0xA5;
+    }
+    printTestResult("Unit", "Shared ROM image lives exactly as long as its users",
+                    live && copyShares && ramPrivate && Memory::GetSharedRomCount() == before);
+}
+
+// =================== Unit Test: Compact Layout Mirrors ==================
+// 8KB of RAM owned | 0x4000+ reads/writes the same bytes, ROM mirrors stay read-only
+void UnitTest_CompactLayoutMirrors() {
+    Memory memory(Memory::Layout::Compact16K);
+    memory.SetAccessPolicy(Memory::AccessPolicy::NoTracking);
+    memory.writeRomBytes(0x0123, 0x5A);
+    memory.WriteByte(0x2010, 0x11);
+    memory.WriteByte(0xE011, 0x22);     // Mirror of 0x2011
+    memory.WriteByte(0x4123, 0x99);     // Mirror of ROM: discarded
+    memory.WriteWord(0x7FFF, 0xBBAA);   // 0x3FFF and its wrap to 0x8000 -> 0x0000 (ROM)
+    bool result = memory.GetRamSize() == 0x2000 &&
+                  memory.ReadByte(0x6010) == 0x11 && memory.ReadByte(0xA010) == 0x11 &&
+                  memory.ReadByte(0x2011) == 0x22 &&
+                  memory.ReadByte(0xC123) == 0x5A && memory.ReadByte(0x0123) == 0x5A &&
+                  memory.ReadByte(0x3FFF) == 0xAA && memory.ReadByte(0x0000) == 0x00 &&
+                  (memory.GetPageFlags(0x6400) & Memory::PAGE_MIRROR) &&
+                  (memory.GetPageFlags(0x6400) & Memory::PAGE_VRAM) &&
+                  !(memory.GetPageFlags(0x2400) & Memory::PAGE_MIRROR);
+    printTestResult("Unit", "Compact layout: 8KB RAM, mirrors alias RAM/VRAM/ROM", result);
+}
+
+// =================== Unit Test: Compact Mirrors, Snapshots, Rows =========
+// A mirror write marks the backing row and copies the backing page once
+void UnitTest_CompactMirrorSnapshot() {
+    Memory memory(Memory::Layout::Compact16K);
+    memory.SetAccessPolicy(Memory::AccessPolicy::NoTracking);
+    memory.WriteByte(0x2400, 0x01);
+    memory.ConsumeDirtyRows();
+    memory.TakeSnapshot();
+    memory.WriteByte(0x6400, 0x02);     // Copies page 0x24 through its mirror
+    memory.WriteByte(0x2400, 0x03);     // Same backing page: no second copy
+    memory.WriteByte(0xA401, 0x04);
+    Memory::DirtyRows rows = memory.ConsumeDirtyRows();
+    size_t copied = memory.GetSnapshotPageCount();
+    bool restored = memory.RestoreSnapshot() && memory.ReadByte(0x2400) == 0x01 &&
+                    memory.ReadByte(0xE400) == 0x01 && memory.ReadByte(0x2401) == 0x00;
+    printTestResult("Unit", "Mirror writes mark VRAM row 0, copy one page, restore exactly",
+                    rows.count() == 1 && rows.test(0) && copied == 1 && restored);
+}
+
+// =================== Unit Test: Compact Watchpoints and States ==========
+// A watchpoint hits through every mirror | States don't cross layouts
+void UnitTest_CompactWatchAndState() {
+    Memory memory(Memory::Layout::Compact16K);
+    memory.SetAccessPolicy(Memory::AccessPolicy::Watching);
+    int hits = 0;
+    memory.SetWatchCallback([&](uint16_t, uint8_t, bool) { ++hits; });
+    memory.AddWatchpoint(0x2050, Memory::WATCH_WRITE);
+    memory.WriteByte(0x6050, 0x01);
+    memory.WriteByte(0xE050, 0x02);
+    memory.WriteByte(0x2051, 0x03);
+
+    Memory::State state;
+    memory.SaveState(state);
+    memory.WriteByte(0x2050, 0x07);
+    bool loaded = memory.LoadState(state) && memory.ReadByte(0xA050) == 0x02;
+    Memory full;
+    full.SetAccessPolicy(Memory::AccessPolicy::NoTracking);
+    bool refused = state.ram.size() == 0x2000 && !full.LoadState(state);
+    memory.SetLayout(Memory::Layout::Full64K);
+    bool switched = memory.GetRamSize() == Memory::MEMORY_SIZE - Memory::RAM_START &&
+                    memory.ReadByte(0x2050) == 0x00 && !memory.LoadState(state);
+    printTestResult("Unit", "Compact watchpoint hits via mirrors, states stay in their layout",
+                    hits == 3 && loaded && refused && switched);
+}
+
+// =================== Unit Test: Snapshot Survives LoadState =============
+// A full state load does not corrupt the active snapshot | A new ROM refuses it
+void UnitTest_SnapshotAcrossLoadState() {
+    Memory memory;
+    Memory::State state;
+    memory.SaveState(state);
+    memory.WriteByte(0x5000, 0x77);
+    memory.TakeSnapshot();
+    bool loaded = memory.LoadState(state) && memory.ReadByte(0x5000) == 0x00;
+    bool restored = memory.RestoreSnapshot() && memory.ReadByte(0x5000) == 0x77;
+    memory.writeRomBytes(0x0000, 0x01);
+    bool stale = !memory.RestoreSnapshot();
+    printTestResult("Unit", "Snapshot survives LoadState, refused after ROM change",
+                    loaded && restored && stale);
+}
+
 #ifdef ENABLE_MEMORY_DEBUG
 // =================== Unit Test: Snapshot Match ==========================
 // Test Snapshot: Should match if memory is unchanged
@@ -159,11 +507,39 @@ int main() {
     UnitTest_RAMWriteRead();
     UnitTest_RAMZeroOnInit();
     UnitTest_WriteAtFFFF();
+    UnitTest_WordReadWrite();
+    UnitTest_WordWrapAndROM();
+    UnitTest_WordSlowPath();
 
     // === VRAM Tests ===
     UnitTest_VRAMReflectsWrite();
     UnitTest_VRAMSizeCheck();
     UnitTest_VRAMPointerCorrect();
+    UnitTest_VRAMDirtyRows();
+    UnitTest_VRAMDirtyRange();
+
+    // === Page Table Tests ===
+    UnitTest_PageFlags();
+    UnitTest_ROMWriteDiscarded();
+    UnitTest_CopyRebuildsPages();
+    UnitTest_SharedRomAcrossInstances();
+    UnitTest_SharedRomLifetime();
+
+    // === Compact Layout Tests ===
+    UnitTest_CompactLayoutMirrors();
+    UnitTest_CompactMirrorSnapshot();
+    UnitTest_CompactWatchAndState();
+
+    // === Access Policy Tests ===
+    UnitTest_PolicyNoTracking();
+    UnitTest_PolicyCounting();
+    UnitTest_PolicyWatching();
+    UnitTest_WatchpointCallback();
+
+    // === Snapshot Tests ===
+    UnitTest_SnapshotCopyOnWrite();
+    UnitTest_SnapshotChain();
+    UnitTest_SnapshotAcrossLoadState();
 
     // === Debug Tests ===
 #ifdef ENABLE_MEMORY_DEBUG
@@ -23,6 +23,8 @@
 #include <iostream>
 #include <vector>
 #include <cassert>
+#include <cstdint>
+#include <filesystem>
 
 // =================== Unit Test: ROM Fills Up to ROM Boundary =============
 // Verifies loading large ROM that ends exactly at the ROM limit (0x1FFF)
@@ -161,6 +163,51 @@ void UnitTest_MemoryWriteToROMRegion() {
     printTestResult("Unit", "Direct write to ROM region blocked", blocked);
 }
 
+// =================== Unit Test: Single Bulk Write =======================
+// A whole file lands with one ROM generation bump, not one per byte
+void UnitTest_ROMLoadSingleGenerationBump() {
+    Memory memory;
+    const std::string filename = "rom_bulk.bin";
+    std::vector<uint8_t> data(0x0800);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 7);
+    }
+    createBinaryFile(filename, data);
+
+    uint32_t before = memory.GetRomGeneration();
+    bool loaded = LoadROMFile(filename, memory, 0x0800);
+    bool verified = memory.ReadByte(0x0800) == data[0] && memory.ReadByte(0x0C01) == data[0x401] &&
+                    memory.ReadByte(0x0FFF) == data[0x7FF];
+
+    printTestResult("Unit", "2KB file copied with one ROM generation bump",
+                    loaded && verified && memory.GetRomGeneration() == before + 1);
+    std::remove(filename.c_str());
+}
+
+// =================== Unit Test: Full Set With Load Time ==================
+// Loads invaders.h/g/f/e from a directory and reports the time taken
+void UnitTest_ROMLoadSetTimed() {
+    Memory memory;
+    const std::string directory = "rom_set_test";
+    std::filesystem::create_directory(directory);
+    const std::vector<std::pair<std::string, uint8_t>> parts = {
+        {"invaders.h", 0x11}, {"invaders.g", 0x22}, {"invaders.f", 0x33}, {"invaders.e", 0x44}
+    };
+    for (const auto& [name, fill] : parts) {
+        createBinaryFile(directory + "/" + name, std::vector<uint8_t>(0x0800, fill));
+    }
+
+    uint64_t loadTimeUs = UINT64_MAX;
+    bool loaded = LoadSpaceInvadersROM(memory, directory, &loadTimeUs);
+    bool verified = memory.ReadByte(0x0000) == 0x11 && memory.ReadByte(0x0FFF) == 0x22 &&
+                    memory.ReadByte(0x1000) == 0x33 && memory.ReadByte(0x1FFF) == 0x44;
+
+    std::cout << "  ROM set load: " << loadTimeUs << " us\n";
+    printTestResult("Unit", "Full ROM set loads and reports load time (us)",
+                    loaded && verified && loadTimeUs != UINT64_MAX);
+    std::filesystem::remove_all(directory);
+}
+
 // =================== Entry Point =========================================
 int main() {
     std::cout << "=== Running ROMLoader Unit Tests ===\n";
@@ -175,6 +222,8 @@ int main() {
     UnitTest_ROMFileNotFound();
     UnitTest_ROMOverwrite();
     UnitTest_MemoryWriteToROMRegion();
+    UnitTest_ROMLoadSingleGenerationBump();
+    UnitTest_ROMLoadSetTimed();
 
     std::cout << "\n=== Unit Tests Complete: " << testCounter - 1 << " Total ===\n";
     return 0;
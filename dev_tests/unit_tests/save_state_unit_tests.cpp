@@ -0,0 +1,198 @@
+// ============================================================================
+// Save State Unit Tests
+// ----------------------------------------------------------------------------
+// Target Module : Emulator::saveState / loadState, Memory::SaveState / LoadState
+// Purpose       : Validates that an in-memory state restores the machine
+//                 exactly (re-running from it repeats the same frames), that
+//                 a state from another ROM is refused, that live inputs
+//                 survive a restore, and that a save/restore pair is cheap
+//                 enough to run every frame for run-ahead, also in the
+//                 compact 16 KB memory layout.
+// Scope         : Whole frames on the default backend.
+//
+// Author        : Jese/Arnav
+// Date          : 10/16/26
+// ============================================================================
+
+//=========================== Define ==========================================
+#define ENABLE_COLOR_OUTPUT
+#define ENABLE_CPU_TESTING
+
+// ========================== Include ========================================
+#include "../../src/model/emulator.hpp"
+#include "../support/test_utils.hpp"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+// Enables interrupts and spins; RST 2 advances a counter at 0x2002 and
+// writes it into VRAM at 0x2400 + counter, so every frame changes RAM.
+static const std::vector<uint8_t> FRAME_PROGRAM = {
+    0x31, 0x00, 0x24,       // 0000: LXI SP,2400
+    0xFB,                   // 0003: EI
+    0xC3, 0x04, 0x00,       // 0004: JMP 0004
+    0x00,                   // 0007: NOP
+    0xFB,                   // 0008: EI
+    0xC9,                   // 0009: RET
+    0x00, 0x00, 0x00,       // 000A: NOP x6
+    0x00, 0x00, 0x00,
+    0x21, 0x02, 0x20,       // 0010: LXI H,2002
+    0x34,                   // 0013: INR M
+    0x7E,                   // 0014: MOV A,M
+    0x6F,                   // 0015: MOV L,A
+    0x26, 0x24,             // 0016: MVI H,24
+    0x77,                   // 0018: MOV M,A
+    0xFB,                   // 0019: EI
+    0xC9,                   // 001A: RET
+};
+
+// True when both emulators have identical registers, clock and RAM.
+static bool sameMachine(Emulator& lhs, Emulator& rhs) {
+    CPUState a = lhs.getCPUState();
+    CPUState b = rhs.getCPUState();
+    bool regs = a.a == b.a && a.b == b.b && a.c == b.c && a.d == b.d && a.e == b.e &&
+                a.h == b.h && a.l == b.l && a.sp == b.sp && a.pc == b.pc &&
+                a.flags.psw == b.flags.psw && a.interrupts_enabled == b.interrupts_enabled;
+    bool ram = true;
+    for (uint32_t addr = Memory::RAM_START; addr < Memory::MEMORY_SIZE; ++addr) {
+        ram = ram && lhs.getMemoryRef().ReadByte(addr) == rhs.getMemoryRef().ReadByte(addr);
+    }
+    return regs && ram && lhs.getCycleCount() == rhs.getCycleCount();
+}
+
+// ====================== Unit Test: Round Trip ===============================
+// Restoring and re-running three frames lands on the same machine state.
+void UnitTest_SaveState_RoundTrip() {
+    Emulator emu;
+    Emulator reference;
+    writeRomInstructionSequence(emu.getMemoryRef(), 0x0000, FRAME_PROGRAM);
+    writeRomInstructionSequence(reference.getMemoryRef(), 0x0000, FRAME_PROGRAM);
+
+    emu.runUntilFrameEnd();
+    emu.runUntilFrameEnd();
+    EmulatorState saved;
+    emu.saveState(saved);
+    for (int i = 0; i < 3; ++i) {
+        emu.runUntilFrameEnd();
+    }
+    bool restored = emu.loadState(saved) && emu.getCycleCount() == saved.cycle_count &&
+                    emu.getMemoryRef().ReadByte(0x2002) == 1;
+    for (int i = 0; i < 3; ++i) {
+        emu.runUntilFrameEnd();
+    }
+
+    for (int i = 0; i < 5; ++i) {
+        reference.runUntilFrameEnd();
+    }
+
+    printTestResult("Save State", "Load + 3 frames == 5 uninterrupted frames (regs, RAM, clock)",
+                    restored && sameMachine(emu, reference));
+}
+
+// ====================== Unit Test: Stale ROM ================================
+// A state saved before the ROM changed is refused and changes nothing.
+void UnitTest_SaveState_StaleRom() {
+    Emulator emu;
+    writeRomInstructionSequence(emu.getMemoryRef(), 0x0000, FRAME_PROGRAM);
+    emu.runUntilFrameEnd();
+
+    EmulatorState saved;
+    emu.saveState(saved);
+    emu.runUntilFrameEnd();
+    uint64_t cycles = emu.getCycleCount();
+    emu.getMemoryRef().writeRomBytes(0x0007, 0x00);
+
+    printTestResult("Save State", "State from another ROM generation → refused, emulator untouched",
+                    !emu.loadState(saved) && emu.getCycleCount() == cycles &&
+                    emu.getMemoryRef().ReadByte(0x2002) == 1);
+}
+
+// ====================== Unit Test: Live Inputs ==============================
+// Keys pressed after the save are still held after the restore.
+void UnitTest_SaveState_KeepsInputs() {
+    Emulator emu;
+    writeRomInstructionSequence(emu.getMemoryRef(), 0x0000, FRAME_PROGRAM);
+
+    EmulatorState saved;
+    emu.saveState(saved);
+    emu.setInputState(GameInput::Coin, true);
+    bool loaded = emu.loadState(saved);
+
+    printTestResult("Save State", "Restore keeps the live input ports",
+                    loaded && emu.getCPUState().port_in_1.coin == 1);
+}
+
+// ====================== Unit Test: Copy Time ================================
+// A save/restore pair takes microseconds, not milliseconds.
+void UnitTest_SaveState_Fast() {
+    Emulator emu;
+    writeRomInstructionSequence(emu.getMemoryRef(), 0x0000, FRAME_PROGRAM);
+    emu.runUntilFrameEnd();
+
+    const int ROUNDS = 1000;
+    EmulatorState saved;
+    bool loaded = true;
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < ROUNDS; ++i) {
+        emu.saveState(saved);
+        loaded = emu.loadState(saved) && loaded;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+
+    std::cout << "  save + load: " << (elapsed / ROUNDS) << " ns\n";
+    printTestResult("Save State", "Save + load under 50 µs (one frame is 16,667 µs)",
+                    loaded && elapsed / ROUNDS < 50000);
+}
+
+// ====================== Unit Test: Compact Layout ===========================
+// The 16 KB layout runs the same frames and its state holds 8 KB of RAM.
+void UnitTest_SaveState_CompactLayout() {
+    Emulator emu;
+    Emulator reference;
+    emu.setMemoryLayout(Memory::Layout::Compact16K);
+    writeRomInstructionSequence(emu.getMemoryRef(), 0x0000, FRAME_PROGRAM);
+    writeRomInstructionSequence(reference.getMemoryRef(), 0x0000, FRAME_PROGRAM);
+
+    emu.runUntilFrameEnd();
+    EmulatorState saved;
+    emu.saveState(saved);
+    emu.runUntilFrameEnd();
+    emu.runUntilFrameEnd();
+    bool restored = emu.loadState(saved);
+    emu.runUntilFrameEnd();
+    emu.runUntilFrameEnd();
+    for (int i = 0; i < 3; ++i) {
+        reference.runUntilFrameEnd();
+    }
+
+    bool same = emu.getCycleCount() == reference.getCycleCount() &&
+                emu.getMemoryRef().ReadByte(0x2002) == reference.getMemoryRef().ReadByte(0x2002) &&
+                emu.getMemoryRef().ReadByte(0x2403) == reference.getMemoryRef().ReadByte(0x2403) &&
+                emu.getMemoryRef().ReadByte(0x6403) == reference.getMemoryRef().ReadByte(0x2403);
+    printTestResult("Save State", "Compact 16 KB layout: 8 KB state, same frames as the flat layout",
+                    restored && same && saved.memory.ram.size() == 0x2000);
+}
+
+int main() {
+    resetTestCounter();
+
+    std::cout << "=== Starting Save State Tests ===\n";
+    UnitTest_SaveState_RoundTrip();
+    UnitTest_SaveState_StaleRom();
+    UnitTest_SaveState_KeepsInputs();
+    UnitTest_SaveState_Fast();
+    UnitTest_SaveState_CompactLayout();
+    std::cout << "=== Save State Tests Complete ===\n\n";
+
+    int totalTests = testsPassed + testsFailed;
+    std::cout << "\n==============================\n";
+    std::cout << " Save State Unit Test Summary\n";
+    std::cout << "------------------------------\n";
+    std::cout << " Total Tests : " << totalTests << "\n";
+    std::cout << GREEN << " Passed      : " << testsPassed << RESET << "\n";
+    std::cout << RED   << " Failed      : " << testsFailed << RESET << "\n";
+    std::cout << "==============================\n";
+
+    return 0;
+}
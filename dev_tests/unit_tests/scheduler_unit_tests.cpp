@@ -0,0 +1,196 @@
+// ============================================================================
+// Event Scheduler Unit Tests
+// ----------------------------------------------------------------------------
+// Target Module : EventScheduler / Emulator::runUntilFrameEnd (Intel 8080 Emulator)
+// Purpose       : Validates deadline ordering of the event queue and that a
+//                 frame fires RST 1 and RST 2 at their cycle positions
+//                 without drifting from frame to frame.
+// Scope         : Scheduler in isolation, then whole frames on every backend.
+//
+// Author        : Jese/Arnav
+// Date          : 10/16/26
+// ============================================================================
+
+//=========================== Define ==========================================
+#define ENABLE_COLOR_OUTPUT
+#define ENABLE_CPU_TESTING
+
+// ========================== Include ========================================
+#include "../../src/model/emulator.hpp"
+#include "../../src/model/scheduler.hpp"
+#include "../support/test_utils.hpp"
+#include <iostream>
+#include <vector>
+
+// Enables interrupts and spins; RST 1 stores 0x01 at 0x2000, RST 2 stores
+// 0x02 at 0x2001 and bumps a frame counter at 0x2002.
+static const std::vector<uint8_t> FRAME_PROGRAM = {
+    0x31, 0x00, 0x24,       // 0000: LXI SP,2400
+    0xFB,                   // 0003: EI
+    0xC3, 0x04, 0x00,       // 0004: JMP 0004
+    0x00,                   // 0007: NOP
+    0x3E, 0x01,             // 0008: MVI A,01
+    0x32, 0x00, 0x20,       // 000A: STA 2000
+    0xFB,                   // 000D: EI
+    0xC9,                   // 000E: RET
+    0x00,                   // 000F: NOP
+    0x3E, 0x02,             // 0010: MVI A,02
+    0x32, 0x01, 0x20,       // 0012: STA 2001
+    0x21, 0x02, 0x20,       // 0015: LXI H,2002
+    0x34,                   // 0018: INR M
+    0xFB,                   // 0019: EI
+    0xC9,                   // 001A: RET
+};
+
+// Longest 8080 instruction: the most a batch can overshoot its deadline.
+static const int MAX_OVERSHOOT = 18;
+
+// ====================== Unit Test: Deadline Order ===========================
+// Events pop earliest first, ties in schedule order, and only once due.
+void UnitTest_Scheduler_Order() {
+    EventScheduler scheduler;
+    scheduler.schedule(EventId::VBlank, 30);
+    scheduler.schedule(EventId::MidScreen, 10);
+    scheduler.schedule(EventId::VBlank, 20);
+    scheduler.schedule(EventId::VBlank, 10);
+
+    ScheduledEvent event;
+    bool early = !scheduler.popDue(9, event) && scheduler.nextDeadline() == 10;
+    bool first = scheduler.popDue(25, event) && event.when == 10 && event.id == EventId::MidScreen;
+    bool tie = scheduler.popDue(25, event) && event.when == 10 && event.id == EventId::VBlank;
+    bool third = scheduler.popDue(25, event) && event.when == 20;
+    bool notYet = !scheduler.popDue(25, event) && scheduler.nextDeadline() == 30;
+
+    printTestResult("Scheduler", "Earliest deadline first, ties in schedule order, nothing early",
+                    early && first && tie && third && notYet);
+}
+
+// ====================== Unit Test: Empty Queue ==============================
+// An empty queue never has anything due.
+void UnitTest_Scheduler_Empty() {
+    EventScheduler scheduler;
+    scheduler.schedule(EventId::MidScreen, 5);
+    scheduler.clear();
+
+    ScheduledEvent event;
+    printTestResult("Scheduler", "Cleared queue → no deadline, nothing due",
+                    !scheduler.popDue(UINT64_MAX, event) && scheduler.nextDeadline() == UINT64_MAX);
+}
+
+// ====================== Unit Test: Frame Interrupts =========================
+// One frame runs the RST 1 ISR on every backend and stops right after
+// vblank has entered RST 2, whose ISR runs at the start of the next frame;
+// three frames later the cycle count is still on the 33,333-cycle grid.
+void UnitTest_RunUntilFrameEnd() {
+    bool pass = true;
+    for (CpuBackend backend : {CpuBackend::Interpreter, CpuBackend::Threaded, CpuBackend::BlockCache,
+                               CpuBackend::Jit, CpuBackend::Aot}) {
+        Emulator emu;
+        emu.setCpuBackend(backend);
+        Memory& mem = emu.getMemoryRef();
+        writeRomInstructionSequence(mem, 0x0000, FRAME_PROGRAM);
+
+        int executed = emu.runUntilFrameEnd();
+        bool firstFrame = mem.ReadByte(0x2000) == 0x01 && emu.getCPUState().pc == 0x0010 &&
+                          executed >= Emulator::CYCLES_PER_FRAME &&
+                          executed < Emulator::CYCLES_PER_FRAME + MAX_OVERSHOOT;
+
+        emu.runUntilFrameEnd();
+        emu.runUntilFrameEnd();
+        emu.runUntilFrameEnd();
+        uint64_t end = 4ull * Emulator::CYCLES_PER_FRAME;
+        bool noDrift = mem.ReadByte(0x2001) == 0x02 && mem.ReadByte(0x2002) == 3 &&
+                       emu.getCycleCount() >= end &&
+                       emu.getCycleCount() < end + MAX_OVERSHOOT;
+
+        pass = pass && firstFrame && noDrift;
+    }
+
+    printTestResult("Frame Events", "RST 1 and RST 2 each frame, frames stay 33,333 cycles apart",
+                    pass);
+}
+
+// ====================== Unit Test: Mid-Screen Timing ========================
+// RST 1 is not delivered before half a frame has run, and is right after.
+void UnitTest_MidScreenTiming() {
+    Emulator emu;
+    Memory& mem = emu.getMemoryRef();
+    writeRomInstructionSequence(mem, 0x0000, FRAME_PROGRAM);
+
+    emu.emulateCycles(Emulator::CYCLES_PER_FRAME / 2 - MAX_OVERSHOOT);
+    bool before = mem.ReadByte(0x2000) == 0x00;
+    emu.runUntilFrameEnd();
+    bool after = mem.ReadByte(0x2000) == 0x01;
+
+    printTestResult("Frame Events", "Mid-screen RST 1 fires at half a frame, not earlier",
+                    before && after);
+}
+
+// ====================== Unit Test: Frame Copy ===============================
+// The frame argument receives all of VRAM by the end of the frame.
+void UnitTest_FrameCopy() {
+    Emulator emu;
+    Memory& mem = emu.getMemoryRef();
+    writeRomInstructionSequence(mem, 0x0000, FRAME_PROGRAM);
+    mem.WriteByte(Memory::VRAM_START, 0xA5);
+    mem.WriteByte(Memory::VRAM_END, 0x5A);
+
+    std::vector<uint8_t> frame(Memory::VRAM_END - Memory::VRAM_START + 1, 0);
+    emu.runUntilFrameEnd(frame.data());
+
+    printTestResult("Frame Events", "Top and bottom half of VRAM copied into the frame",
+                    frame.front() == 0xA5 && frame.back() == 0x5A);
+}
+
+// ====================== Unit Test: Dirty Rows ===============================
+// After the first full copy only written rows are copied and reported; a
+// frame that writes no VRAM reports no rows.
+void UnitTest_FrameDirtyRows() {
+    Emulator emu;
+    Memory& mem = emu.getMemoryRef();
+    writeRomInstructionSequence(mem, 0x0000, FRAME_PROGRAM);
+
+    std::vector<uint8_t> frame(Memory::VRAM_END - Memory::VRAM_START + 1, 0);
+    emu.runUntilFrameEnd(frame.data());
+    bool first = emu.consumeDirtyRows().all();
+
+    emu.runUntilFrameEnd(frame.data());
+    bool idle = emu.consumeDirtyRows().none();
+
+    mem.WriteByte(Memory::VRAM_START + 5 * Memory::VRAM_ROW_SIZE, 0x3C);
+    emu.runUntilFrameEnd(frame.data());
+    Memory::DirtyRows rows = emu.consumeDirtyRows();
+    bool copied = rows.count() == 1 && rows.test(5) && frame[5 * Memory::VRAM_ROW_SIZE] == 0x3C;
+
+    // A different buffer has none of the earlier rows, so it gets them all.
+    std::vector<uint8_t> other(frame.size(), 0);
+    emu.runUntilFrameEnd(other.data());
+    bool fresh = emu.consumeDirtyRows().all() && other == frame;
+
+    printTestResult("Frame Events", "Only changed rows copied; a new buffer gets a full copy",
+                    first && idle && copied && fresh);
+}
+
+int main() {
+    resetTestCounter();
+
+    std::cout << "=== Starting Event Scheduler Tests ===\n";
+    UnitTest_Scheduler_Order();
+    UnitTest_Scheduler_Empty();
+    UnitTest_RunUntilFrameEnd();
+    UnitTest_MidScreenTiming();
+    UnitTest_FrameCopy();
+    UnitTest_FrameDirtyRows();
+    std::cout << "=== Event Scheduler Tests Complete ===\n\n";
+
+    int totalTests = testsPassed + testsFailed;
+    std::cout << "\n==============================\n";
+    std::cout << " Scheduler Unit Test Summary\n";
+    std::cout << "------------------------------\n";
+    std::cout << " Total Tests : " << totalTests << "\n";
+    std::cout << GREEN << " Passed      : " << testsPassed << RESET << "\n";
+    std::cout << RED   << " Failed      : " << testsFailed << RESET << "\n";
+    std::cout << "==============================\n";
+
+    return 0;
+}
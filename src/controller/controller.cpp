@@ -10,9 +10,11 @@
 
 /***************** Include files. ***********************/
 #include "controller.hpp"
+#include "frame_pacer.hpp"
 #include "mainwindow.h"
 
-#include <algorithm> // For std::fill.
+#include <algorithm> // For std::fill, std::max.
+#include <cstdio>    // For std::printf.
 
 // Qt tools.
 #include <QKeyEvent> // For Qt Key enumerations.
@@ -21,6 +23,9 @@
 // The VRAM size for Space Invaders is 7168 bytes.
 constexpr size_t VRAM_SIZE = 7168;
 
+// Emulated FPS is averaged over windows of this length.
+constexpr int64_t FPS_WINDOW_NS = 1000000000;
+
 /***************** Namespaces. ***********************/
 
 /***************** Local Classes. ***********************/
@@ -30,7 +35,11 @@ constexpr size_t VRAM_SIZE = 7168;
 /***************** Global Class Functions. ***********************/
 
 Controller::Controller(Emulator* model, MainWindow* view, QObject* parent)
-    : QObject{parent}, m_model(model), m_view(view), m_isRunning(false), m_romPath("")
+    : QObject{parent}, m_model(model), m_view(view), m_isRunning(false), m_romPath(""),
+      m_speedMultiplier(1), m_renderInterval(1), m_framesSinceRender(0),
+      m_emulatedFrames(0), m_fpsWindowFrames(0), m_fpsWindowStart(FramePacer::nowNs()), m_emulatedFps(0.0),
+      m_framesInFlight(0), m_maxFrameSkip(DEFAULT_MAX_FRAME_SKIP), m_consecutiveSkips(0),
+      m_runAheadFrames(0)
 {
     if (nullptr == m_model || nullptr == m_view)
     {
@@ -59,11 +68,11 @@ Controller::Controller(Emulator* model, MainWindow* view, QObject* parent)
     // Toggle Run (View -> Controller).
     connect(view, SIGNAL(sendToggleRunSignal(bool*)), this, SLOT(onToggleRun(bool*)));
 
+    // Frame consumed, for frame skipping (View -> Controller).
+    connect(view, SIGNAL(sendFrameConsumedSignal()), this, SLOT(onFrameConsumed()));
+
     // Initialize frame buffer.
     std::fill(m_frameBuffer.begin(), m_frameBuffer.end(), 0);
-
-    // Get emulator frame base pointe.
-    emulatorFrameBufferPtr = m_model->getFrameBuffer();
 }
 
 void Controller::onLoadROM(const std::string& romFilePath, bool *isValidRomPath)
@@ -79,6 +88,9 @@ void Controller::onLoadROM(const std::string& romFilePath, bool *isValidRomPath)
             *isValidRomPath = true;
         }
 
+        std::printf("ROM loaded in %llu us\n",
+                    static_cast<unsigned long long>(m_model->getRomLoadTimeUs()));
+
         // Store copy of path.
         m_romPath = romFilePath;
 
@@ -174,7 +186,16 @@ void Controller::onKeyEvent(int key, bool isPressed)
     m_model->setInputState(input, isPressed);
 }
 
-void Controller::runFrame()
+void Controller::onFrameConsumed()
+{
+    // Never below zero: the video test also feeds the view.
+    int inFlight = m_framesInFlight.load();
+    while (inFlight > 0 && !m_framesInFlight.compare_exchange_weak(inFlight, inFlight - 1))
+    {
+    }
+}
+
+void Controller::runFrame(bool hostLate)
 {
     if (!m_isRunning)
     {
@@ -183,27 +204,65 @@ void Controller::runFrame()
 
     mutex.lock(); // Block any other signals that alter the emulator state.
 
-    // Emulate cycles for the first half of the screen.
-    m_model->emulateCycles(CYCLES_PER_FRAME / 2);
+    // In turbo mode only every K-th frame is shown, the others skip the
+    // VRAM copy and the conversion in the view.
+    bool render = ++m_framesSinceRender >= m_renderInterval;
 
-    // Trigger the mid-screen interrupt (RST 1). This is a characteristic
-    // of the original Space Invaders hardware.
-    m_model->requestInterrupt(1);
-
-    // Copy first half of the screen to the frame buffer.
-    memcpy(m_frameBuffer.data(), emulatorFrameBufferPtr, FRAME_BUFFER_MID_SCREEN);
-
-    // Emulate cycles for the second half of the screen.
-    m_model->emulateCycles(CYCLES_PER_FRAME / 2);
+    // Keep emulating in real time when the host falls behind, but do not
+    // queue another frame while the view still converts the last one.
+    if (render && m_consecutiveSkips < m_maxFrameSkip)
+    {
+        bool guiBusy = m_framesInFlight.load() > 0;
+        if (guiBusy || hostLate)
+        {
+            render = false;
+            m_consecutiveSkips++;
+            m_skipStats.skipped++;
+            m_skipStats.skipped_gui_busy += guiBusy ? 1 : 0;
+            m_skipStats.skipped_late += guiBusy ? 0 : 1;
+            m_skipStats.max_consecutive = std::max(m_skipStats.max_consecutive, m_consecutiveSkips);
+        }
+    }
 
-    // Trigger the V-Blank interrupt (RST 2). This signals the end of a frame.
-    m_model->requestInterrupt(2);
+    // The model's scheduler fires the mid-screen (RST 1) and V-Blank
+    // (RST 2) interrupts at their exact cycles and copies each half of
+    // the screen into the frame buffer as the beam passes it.
+    if (render && m_runAheadFrames > 0)
+    {
+        runAheadFrame();
+    }
+    else
+    {
+        m_model->runUntilFrameEnd(render ? m_frameBuffer.data() : nullptr);
+    }
 
-    // Copy the second half of the screen to the frame buffer.
-    memcpy(m_frameBuffer.data() + FRAME_BUFFER_MID_SCREEN, emulatorFrameBufferPtr + FRAME_BUFFER_MID_SCREEN, FRAME_BUFFER_MID_SCREEN);
+    if (render)
+    {
+        // Send buffer frame signal to view class. A frame with no changed
+        // row is already on screen, so it is not converted again.
+        m_framesSinceRender = 0;
+        m_consecutiveSkips = 0;
+        if (m_model->consumeDirtyRows().none())
+        {
+            m_skipStats.unchanged++;
+        }
+        else
+        {
+            m_skipStats.presented++;
+            m_framesInFlight++;
+            emit sendframeBuffer(&m_frameBuffer);
+        }
+    }
 
-    // Send buffer frame signal to view class.
-    emit sendframeBuffer(&m_frameBuffer);
+    m_emulatedFrames++;
+    m_fpsWindowFrames++;
+    int64_t now = FramePacer::nowNs();
+    if (now - m_fpsWindowStart >= FPS_WINDOW_NS)
+    {
+        m_emulatedFps = static_cast<double>(m_fpsWindowFrames) * 1e9 / static_cast<double>(now - m_fpsWindowStart);
+        m_fpsWindowFrames = 0;
+        m_fpsWindowStart = now;
+    }
 
     // The view could also have a method to display debug info.
     // CPUState state = m_model->getCPUState();
@@ -212,13 +271,90 @@ void Controller::runFrame()
     mutex.unlock();
 }
 
+void Controller::runAheadFrame()
+{
+    // Advance the real machine by one frame, nobody sees this one.
+    m_model->runUntilFrameEnd(nullptr);
+
+    // Speculate: run ahead with the keys held now and show the result.
+    m_model->saveState(m_runAheadState);
+    for (uint32_t i = 1; i < m_runAheadFrames; ++i)
+    {
+        m_model->runUntilFrameEnd(nullptr);
+    }
+    m_model->runUntilFrameEnd(m_frameBuffer.data());
+
+    // Roll back to the real frame. The state cannot be stale here: the
+    // ROM only changes under the mutex held by the caller.
+    m_model->loadState(m_runAheadState);
+}
+
+void Controller::setRunAhead(uint32_t frames)
+{
+    mutex.lock();
+    m_runAheadFrames = frames;
+    mutex.unlock();
+}
+
+// --- Frame Skip ---
+
+void Controller::setMaxFrameSkip(uint32_t frames)
+{
+    mutex.lock();
+    m_maxFrameSkip = frames;
+    mutex.unlock();
+}
+
+FrameSkipStats Controller::getFrameSkipStats() const
+{
+    mutex.lock(); // runFrame() updates the counters on the emulation thread.
+    FrameSkipStats stats = m_skipStats;
+    mutex.unlock();
+    return stats;
+}
+
+// --- Turbo Mode ---
+
+void Controller::setTurbo(uint32_t speedMultiplier, uint32_t renderInterval)
+{
+    mutex.lock();
+    m_speedMultiplier = speedMultiplier;
+    m_renderInterval = (0 == renderInterval) ? 1 : renderInterval;
+    m_framesSinceRender = 0;
+    mutex.unlock();
+}
+
+uint32_t Controller::framesPerTick() const
+{
+    return isUnthrottled() ? UNTHROTTLED_BATCH : m_speedMultiplier;
+}
+
+bool Controller::isUnthrottled() const
+{
+    return TURBO_UNTHROTTLED == m_speedMultiplier;
+}
+
+bool Controller::isRunning() const
+{
+    return m_isRunning;
+}
+
+double Controller::getEmulatedFps() const
+{
+    return m_emulatedFps;
+}
+
+uint64_t Controller::getEmulatedFrames() const
+{
+    return m_emulatedFrames;
+}
+
 // --- CLI / Debug Methods ---
 
 void Controller::stepSingleInstruction()
 {
-    // Emulate just enough cycles to hopefully execute one instruction.
-    // The exact number of cycles per instruction varies, but the emulator
-    // core handles that. We just need to advance it.
+    // A 1-cycle budget always runs exactly one instruction, whatever
+    // its real cycle count.
     m_model->emulateCycles(1);
 }
 
@@ -13,6 +13,7 @@
 #define CONTROLLER_HPP_
 
 /***************** Include files. ***********************/
+#include <atomic>
 #include <string>
 #include <QMutex>
 #include "emulator.hpp" // Needs to know about the Emulator's public interface
@@ -22,6 +23,21 @@
 #include <QObject>
 
 /***************** Global Classes. ***********************/
+
+/**
+ * @brief Counters of frames not sent to the view because the host
+ *        could not keep up. Turbo-mode decimation is not counted.
+ */
+struct FrameSkipStats
+{
+    uint64_t presented = 0;        // Frames sent to the view.
+    uint64_t unchanged = 0;        // Frames identical to the one on screen, not sent.
+    uint64_t skipped = 0;          // Frames emulated but not presented.
+    uint64_t skipped_gui_busy = 0; // ... because the view had not converted the previous one.
+    uint64_t skipped_late = 0;     // ... because the emulation thread woke up late.
+    uint32_t max_consecutive = 0;  // Longest run of skipped frames.
+};
+
 // Forward-declaration of the View's main window class to avoid including Qt headers here.
 // This breaks the circular dependency between Controller and View.
 class MainWindow; 
@@ -44,8 +60,79 @@ public:
     /**
      * @brief Executes a single frame's worth of emulation and updates the view.
      *        This function should be called repeatedly by a timer in the View (e.g., 60Hz).
+     *        Emulation always advances, but the frame is not presented while the
+     *        view is still busy with an earlier one or the caller is behind
+     *        schedule, up to the maximum frame skip.
+     * @param hostLate true if the caller woke up late for this frame.
+     */
+    void runFrame(bool hostLate = false);
+
+    // --- Frame Skip ---
+    /**
+     * @brief Sets how many frames in a row may be skipped before one is
+     *        presented regardless. 0 presents every frame.
+     */
+    void setMaxFrameSkip(uint32_t frames);
+
+    /**
+     * @brief Presented and skipped frame counters.
+     *        Safe from any thread (e.g. the GUI thread): the copy is taken
+     *        under the mutex runFrame() holds, so it waits for a running frame.
+     */
+    FrameSkipStats getFrameSkipStats() const;
+
+    // Default maximum frame skip: the screen updates at least 15 times a second.
+    static constexpr uint32_t DEFAULT_MAX_FRAME_SKIP = 3;
+
+    // --- Turbo Mode ---
+    /**
+     * @brief Sets the emulation speed and render decimation.
+     * @param speedMultiplier Emulated frames per 60 Hz host tick, or
+     *        TURBO_UNTHROTTLED to run as fast as the host allows.
+     * @param renderInterval Convert and emit only every K-th frame (K >= 1).
+     */
+    void setTurbo(uint32_t speedMultiplier, uint32_t renderInterval);
+
+    /**
+     * @brief Number of runFrame() calls the emulation thread makes per tick.
+     */
+    uint32_t framesPerTick() const;
+
+    /**
+     * @brief True when the emulation thread should not wait for the pacer.
      */
-    void runFrame();
+    bool isUnthrottled() const;
+
+    /**
+     * @brief True while a ROM is loaded and emulation is not paused.
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Emulated frames per second, measured over the last second.
+     */
+    double getEmulatedFps() const;
+
+    /**
+     * @brief Total frames emulated since construction.
+     */
+    uint64_t getEmulatedFrames() const;
+
+    // Speed multiplier that disables pacing.
+    static constexpr uint32_t TURBO_UNTHROTTLED = 0;
+
+    // Frames run per tick when unthrottled, between checks of appRunning.
+    static constexpr uint32_t UNTHROTTLED_BATCH = 60;
+
+    // --- Run-Ahead ---
+    /**
+     * @brief Sets how many frames ahead of the real state are shown.
+     *        Each shown frame emulates one real frame, saves the state,
+     *        runs the given number of frames with the current input,
+     *        presents the last one and restores. 0 disables run-ahead.
+     * @param frames Frames to run ahead (1-2 hides Space Invaders' input lag).
+     */
+    void setRunAhead(uint32_t frames);
 
     // --- CLI / Debug Methods ---
     /**
@@ -94,6 +181,11 @@ public slots:
      */
     void onKeyEvent(int key, bool isPressed);
 
+    /**
+     * @brief Handles the view reporting that it converted a frame.
+     */
+    void onFrameConsumed();
+
 signals:
     
     /**
@@ -104,19 +196,41 @@ signals:
     void sendframeBuffer(const frame_buffer_t *buffer);
 
 private:
+    // --- Private Functions ---
+    /**
+     * @brief Runs one real frame, then the run-ahead frames into the
+     *        frame buffer, and restores the real state. Mutex must be held.
+     */
+    void runAheadFrame();
+
     // --- Private Members ---
     Emulator* m_model;
     MainWindow* m_view;
     bool m_isRunning;
     std::string m_romPath;
-    const uint8_t* emulatorFrameBufferPtr;
     frame_buffer_t m_frameBuffer;
-    QMutex mutex;
-
-    // --- Constants ---
-    // The original arcade machine had a 2MHz CPU and a 60Hz refresh rate.
-    // This gives us approximately 33,333 cycles per frame.
-    static constexpr int CYCLES_PER_FRAME = 33333;
+    mutable QMutex mutex; // Also taken by const getters of state runFrame() updates.
+
+    // Turbo mode.
+    uint32_t m_speedMultiplier;
+    uint32_t m_renderInterval;
+    uint32_t m_framesSinceRender;
+
+    // Emulated FPS measurement.
+    uint64_t m_emulatedFrames;
+    uint64_t m_fpsWindowFrames;
+    int64_t m_fpsWindowStart;
+    double m_emulatedFps;
+
+    // Frame skip.
+    std::atomic<int> m_framesInFlight; // Emitted but not yet converted by the view.
+    uint32_t m_maxFrameSkip;
+    uint32_t m_consecutiveSkips;
+    FrameSkipStats m_skipStats;
+
+    // Run-ahead.
+    uint32_t m_runAheadFrames;
+    EmulatorState m_runAheadState;
 };
 
 #endif /* CONTROLLER_HPP_ */
@@ -0,0 +1,123 @@
+/**********************************************************
+ * @file frame_pacer.cpp
+ *
+ * @brief Implementation of the absolute-deadline frame pacer.
+ *
+ * @author Jesse
+ * @author Sergio
+ *
+ *********************************************************/
+
+/***************** Include files. ***********************/
+#include "frame_pacer.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <ctime>
+#endif
+
+/***************** Macros and defines. ***********************/
+
+// Bounds of the spin tail, and the margin kept above the observed
+// wake-up latency of the OS sleep.
+static constexpr int64_t MIN_SPIN_NS = 50000;
+static constexpr int64_t MAX_SPIN_NS = 2000000;
+static constexpr int64_t SPIN_MARGIN_NS = 50000;
+static constexpr int64_t INITIAL_SPIN_NS = 200000;
+
+/***************** Global Class Functions. ***********************/
+
+FramePacer::FramePacer(uint32_t framesPerSecond)
+    : fps(framesPerSecond == 0 ? 1 : framesPerSecond), spin_ns(INITIAL_SPIN_NS)
+{
+}
+
+void FramePacer::start()
+{
+    origin = nowNs();
+    frame = 1;
+    resetStats();
+}
+
+void FramePacer::waitForNextFrame()
+{
+    const int64_t target = deadline(frame);
+
+    // Sleep to just before the deadline, then spin the rest.
+    const int64_t wake = target - spin_ns;
+    if (wake > nowNs())
+    {
+        sleepUntil(wake);
+
+        // Track the OS wake-up latency: grow at once, shrink slowly.
+        const int64_t wanted = (nowNs() - wake) + SPIN_MARGIN_NS;
+        spin_ns = wanted > spin_ns ? wanted : spin_ns - (spin_ns - wanted) / 16;
+        spin_ns = spin_ns < MIN_SPIN_NS ? MIN_SPIN_NS : (spin_ns > MAX_SPIN_NS ? MAX_SPIN_NS : spin_ns);
+    }
+    int64_t now = nowNs();
+    while (now < target)
+    {
+        now = nowNs();
+    }
+
+    const int64_t jitter = now - target;
+    const int64_t abs_jitter = std::llabs(jitter);
+    stats.frames++;
+    stats.last_jitter_ns = jitter;
+    stats.total_abs_jitter_ns += abs_jitter;
+    stats.max_jitter_ns = abs_jitter > stats.max_jitter_ns ? abs_jitter : stats.max_jitter_ns;
+    stats.late_frames += jitter > LATE_NS ? 1 : 0;
+    stats.spin_ns = spin_ns;
+
+    // Far behind (debugger, suspended laptop): start a new schedule
+    // rather than running a burst of frames to catch up.
+    if (now - target > static_cast<int64_t>(MAX_BEHIND) * (deadline(1) - origin))
+    {
+        origin = now;
+        frame = 1;
+        stats.resyncs++;
+        return;
+    }
+    frame++;
+}
+
+FrameTiming FramePacer::getStats() const
+{
+    return stats;
+}
+
+void FramePacer::resetStats()
+{
+    stats = {};
+    stats.spin_ns = spin_ns;
+}
+
+int64_t FramePacer::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t FramePacer::deadline(uint64_t n) const
+{
+    return origin + static_cast<int64_t>((n * 1000000000ull) / fps);
+}
+
+void FramePacer::sleepUntil(int64_t target)
+{
+#if defined(__linux__)
+    // steady_clock is CLOCK_MONOTONIC on Linux.
+    timespec ts;
+    ts.tv_sec = target / 1000000000;
+    ts.tv_nsec = target % 1000000000;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR)
+    {
+    }
+#else
+    std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(target)));
+#endif
+}
@@ -0,0 +1,103 @@
+/**********************************************************
+ * @file frame_pacer.hpp
+ *
+ * @brief Paces the emulation thread to the arcade frame rate.
+ *        Sleeps on absolute deadlines (clock_nanosleep with
+ *        TIMER_ABSTIME on Linux) and spins only for a short,
+ *        self-calibrating tail before each deadline, so an idle
+ *        instance uses almost no host CPU. Deadlines are computed
+ *        from a fixed origin, so a late frame never shifts the ones
+ *        after it.
+ *
+ * @author Jesse
+ * @author Sergio
+ *
+ *********************************************************/
+#ifndef FRAME_PACER_HPP_
+#define FRAME_PACER_HPP_
+
+/***************** Include files. ***********************/
+#include <cstdint>
+
+/***************** Global Classes. ***********************/
+
+/**
+ * @brief Per-frame timing statistics. Jitter is the wake-up time
+ *        minus the frame deadline (positive = late).
+ */
+struct FrameTiming
+{
+    uint64_t frames = 0;          // Frames paced since start() / resetStats().
+    uint64_t late_frames = 0;     // Frames that woke more than 0.5 ms late.
+    uint64_t resyncs = 0;         // Times the pacer gave up catching up.
+    int64_t last_jitter_ns = 0;   // Jitter of the last frame.
+    int64_t max_jitter_ns = 0;    // Largest |jitter| seen.
+    int64_t total_abs_jitter_ns = 0; // Sum of |jitter|, for the mean.
+    int64_t spin_ns = 0;          // Current calibrated spin tail.
+};
+
+/**
+ * @brief Absolute-deadline frame pacer.
+ */
+class FramePacer
+{
+public:
+    /**
+     * @brief Creates a pacer for the given frame rate.
+     * @param framesPerSecond Frames per second, 60 for Space Invaders.
+     */
+    explicit FramePacer(uint32_t framesPerSecond);
+
+    /**
+     * @brief Sets the first deadline one period from now.
+     */
+    void start();
+
+    /**
+     * @brief Blocks until the next frame deadline and records its jitter.
+     *        Falls back to a fresh origin when more than MAX_BEHIND
+     *        frames late, instead of running a burst to catch up.
+     */
+    void waitForNextFrame();
+
+    /**
+     * @brief Timing statistics since start() or resetStats().
+     */
+    FrameTiming getStats() const;
+
+    /**
+     * @brief Clears the statistics, keeps the deadlines.
+     */
+    void resetStats();
+
+    /**
+     * @brief Monotonic clock in nanoseconds.
+     */
+    static int64_t nowNs();
+
+    // A frame later than this counts as late.
+    static constexpr int64_t LATE_NS = 500000;
+
+    // Frames behind schedule before the pacer resyncs.
+    static constexpr uint64_t MAX_BEHIND = 4;
+
+private:
+    /**
+     * @brief Deadline of frame n, relative to the origin. Computed
+     *        from n so the fractional period never accumulates.
+     */
+    int64_t deadline(uint64_t n) const;
+
+    /**
+     * @brief Sleeps until the absolute time target.
+     */
+    static void sleepUntil(int64_t target);
+
+    uint32_t fps;
+    int64_t origin = 0;     // Time of frame 0.
+    uint64_t frame = 0;     // Index of the next deadline.
+    int64_t spin_ns;        // Spin tail before each deadline.
+    FrameTiming stats;
+};
+
+#endif /* FRAME_PACER_HPP_ */
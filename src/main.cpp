@@ -1,41 +1,101 @@
 #include "controller.hpp"
 #include "emulator.hpp"
+#include "frame_pacer.hpp"
 #include "mainwindow.h"
 
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <thread>
 #include <QApplication>
-#include <QElapsedTimer>
 
-// Approximate period to run 60 Frames Per Second.
-constexpr qint64 FRAME_NS = 1000000000 / 60;
+// The arcade monitor refreshes at 60 Hz.
+constexpr uint32_t FRAMES_PER_SECOND = 60;
 
 /**
  * @brief Controller thread.
  * 
- * Runs a single frame every 1/60 Hz ~= 16.666 ms.
+ * Runs the controller's frames per tick every 1/60 Hz ~= 16.666 ms
+ * (one frame at normal speed, N in turbo mode). The pacer sleeps
+ * between ticks, so the thread only uses CPU while emulating. When
+ * unthrottled, ticks run back to back.
  * 
  * @param appRunning Pointer communicating if the other thread is running.
  * @param ctrl Controller class pointer.
  */
 void runFrames(bool *appRunning, Controller *ctrl)
 {
-    QElapsedTimer timer;
-    timer.start();
+    FramePacer pacer(FRAMES_PER_SECOND);
+    pacer.start();
+    int64_t lastReport = FramePacer::nowNs();
 
     while (*appRunning)
     {
-        // Approximate of 60 FPS.
-        if (timer.nsecsElapsed() >= FRAME_NS)
+        // Wait for the next 60 Hz deadline, then emulate this tick's frames.
+        // A late wake-up lets the controller skip presenting to catch up.
+        // Paused or without a ROM runFrame() returns at once, so the
+        // loop waits even when unthrottled instead of spinning.
+        bool late = false;
+        if (!ctrl->isUnthrottled() || !ctrl->isRunning())
         {
-            // Restart timer.
-            timer.start();
+            pacer.waitForNextFrame();
+            late = pacer.getStats().last_jitter_ns > FramePacer::LATE_NS;
+        }
+        for (uint32_t i = 0; i < ctrl->framesPerTick(); ++i)
+        {
+            ctrl->runFrame(late);
+        }
 
-            // Emulate single frame.
-            ctrl->runFrame();
+        // Report the emulated frame rate once per second of host time in turbo mode.
+        if (1 != ctrl->framesPerTick() && FramePacer::nowNs() - lastReport >= 1000000000)
+        {
+            lastReport = FramePacer::nowNs();
+            std::printf("Emulated FPS: %.1f\n", ctrl->getEmulatedFps());
         }
+    }
+}
 
-        // Sleep thread maybe??
+/**
+ * @brief Applies the speed and latency options from the command line.
+ * 
+ * --speed=N         Run N emulated frames per 60 Hz tick, 0 = unthrottled.
+ * --render-every=K  Convert and paint only every K-th frame.
+ * --run-ahead=N     Show frames N frames ahead of the real state.
+ * --max-frame-skip=N  Frames in a row that may go unshown when the host is behind.
+ * --compact-memory  Emulate only the 16 KB the board decodes, mirrored above 0x3FFF.
+ */
+static void applyCommandLineOptions(int argc, char* argv[], Controller& ctrl, Emulator& model)
+{
+    uint32_t speed = 1;
+    uint32_t renderEvery = 1;
+    uint32_t runAhead = 0;
+    uint32_t maxFrameSkip = Controller::DEFAULT_MAX_FRAME_SKIP;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (0 == std::strncmp(argv[i], "--speed=", 8))
+        {
+            speed = static_cast<uint32_t>(std::strtoul(argv[i] + 8, nullptr, 10));
+        }
+        else if (0 == std::strncmp(argv[i], "--render-every=", 15))
+        {
+            renderEvery = static_cast<uint32_t>(std::strtoul(argv[i] + 15, nullptr, 10));
+        }
+        else if (0 == std::strncmp(argv[i], "--run-ahead=", 12))
+        {
+            runAhead = static_cast<uint32_t>(std::strtoul(argv[i] + 12, nullptr, 10));
+        }
+        else if (0 == std::strncmp(argv[i], "--max-frame-skip=", 17))
+        {
+            maxFrameSkip = static_cast<uint32_t>(std::strtoul(argv[i] + 17, nullptr, 10));
+        }
+        else if (0 == std::strcmp(argv[i], "--compact-memory"))
+        {
+            model.setMemoryLayout(Memory::Layout::Compact16K);
+        }
     }
+    ctrl.setTurbo(speed, renderEvery);
+    ctrl.setRunAhead(runAhead);
+    ctrl.setMaxFrameSkip(maxFrameSkip);
 }
 
 /**
@@ -51,6 +111,7 @@ int main(int argc, char* argv[])
     MainWindow w;
     Emulator model;
     Controller controller(&model, &w);
+    applyCommandLineOptions(argc, argv, controller, model);
 
     // Create separate thread for Controller.
     bool applicationRunning = true;
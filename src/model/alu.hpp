@@ -0,0 +1,346 @@
+/**********************************************************
+ * @file alu.hpp
+ *
+ * @brief Flag and arithmetic primitives of the 8080 ALU.
+ *        Shared by every CPU core (table interpreter and threaded
+ *        interpreter) so all of them produce identical results.
+ *        The functions only touch the values passed in, so cores
+ *        that keep registers in locals can inline them freely.
+ *
+ *        Flags live in a packed PSW byte (flags_t). Z, S and P of a
+ *        result come from the constexpr ZSP_TABLE, so setting them
+ *        is one lookup and a masked byte store.
+ *
+ *        Z, S, P and AC are evaluated lazily: ALU ops only record
+ *        their result/operands in a LazyFlags, and alu_resolve*()
+ *        writes the real flags when something reads them
+ *        (conditional branches, PUSH PSW, DAA, end of a batch).
+ *
+ * @author Jese/Arnav (CPU Core)
+ *
+ *********************************************************/
+#ifndef ALU_HPP_
+#define ALU_HPP_
+
+/***************** Include files. ***********************/
+#include "emulator.hpp"
+#include <array>
+#include <cstdint>
+
+/***************** Global Types. ***********************/
+
+/**
+ * @brief The condition flag block of CPUState.
+ */
+using CpuFlags = flags_t;
+
+/***************** Global Constants. ***********************/
+
+// Bit masks of the PSW byte.
+constexpr uint8_t FLAG_CY = 0x01;
+constexpr uint8_t FLAG_P  = 0x04;
+constexpr uint8_t FLAG_AC = 0x10;
+constexpr uint8_t FLAG_Z  = 0x40;
+constexpr uint8_t FLAG_S  = 0x80;
+constexpr uint8_t FLAG_ZSP = FLAG_Z | FLAG_S | FLAG_P;
+
+// Reserved bits: bit 1 reads as 1, bits 3 and 5 as 0.
+constexpr uint8_t PSW_FIXED_ONES = 0x02;
+constexpr uint8_t PSW_VALID_BITS = FLAG_S | FLAG_Z | FLAG_AC | FLAG_P | FLAG_CY;
+
+/**
+ * @brief Z, S and P bits (in PSW position) of every 8-bit result.
+ */
+constexpr std::array<uint8_t, 256> ZSP_TABLE = [] {
+    std::array<uint8_t, 256> table{};
+    for (int value = 0; value < 256; ++value)
+    {
+        int bits = 0;
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            bits += (value >> bit) & 0x01;
+        }
+        table[value] = (value == 0 ? FLAG_Z : 0) |
+                       (value & 0x80 ? FLAG_S : 0) |
+                       ((bits & 0x01) == 0 ? FLAG_P : 0);
+    }
+    return table;
+}();
+
+/***************** Global Functions. ***********************/
+
+/**
+ * @brief Sets Z, S and P from an 8-bit result.
+ */
+inline void alu_zsp(CpuFlags& f, uint8_t result)
+{
+    f.psw = (f.psw & ~FLAG_ZSP) | ZSP_TABLE[result];
+}
+
+// --- Lazy flag bookkeeping ---
+
+/**
+ * @brief Records a result that defines Z, S and P.
+ */
+inline void alu_defer_zsp(LazyFlags& lz, uint8_t result)
+{
+    lz.result = result;
+    lz.zsp_pending = true;
+}
+
+/**
+ * @brief Records the operands that define AC.
+ */
+inline void alu_defer_ac(LazyFlags& lz, LazyFlags::AcKind kind, uint8_t lhs, uint8_t rhs, uint8_t carry)
+{
+    lz.ac_kind = kind;
+    lz.ac_lhs = lhs;
+    lz.ac_rhs = rhs;
+    lz.ac_carry = carry;
+}
+
+/**
+ * @brief Sets AC directly, dropping any pending AC.
+ */
+inline void alu_set_ac(CpuFlags& f, LazyFlags& lz, bool ac)
+{
+    f.ac = ac;
+    lz.ac_kind = LazyFlags::AcKind::None;
+}
+
+/**
+ * @brief Writes pending Z, S and P to the flags.
+ */
+inline void alu_resolve_zsp(CpuFlags& f, LazyFlags& lz)
+{
+    if (lz.zsp_pending)
+    {
+        alu_zsp(f, lz.result);
+        lz.zsp_pending = false;
+    }
+}
+
+/**
+ * @brief Writes a pending AC to the flags.
+ */
+inline void alu_resolve_ac(CpuFlags& f, LazyFlags& lz)
+{
+    switch (lz.ac_kind)
+    {
+        case LazyFlags::AcKind::None:
+            return;
+        case LazyFlags::AcKind::Add:
+            f.ac = ((lz.ac_lhs & 0x0F) + (lz.ac_rhs & 0x0F) + lz.ac_carry) > 0x0F;
+            break;
+        case LazyFlags::AcKind::Sub:
+            f.ac = (lz.ac_lhs & 0x0F) < ((lz.ac_rhs & 0x0F) + lz.ac_carry);
+            break;
+        case LazyFlags::AcKind::Dcr:
+            f.ac = (lz.ac_lhs & 0x0F) != 0x00;
+            break;
+    }
+    lz.ac_kind = LazyFlags::AcKind::None;
+}
+
+/**
+ * @brief Writes every pending flag, after this CpuFlags is current.
+ */
+inline void alu_resolve(CpuFlags& f, LazyFlags& lz)
+{
+    alu_resolve_zsp(f, lz);
+    alu_resolve_ac(f, lz);
+}
+
+/**
+ * @brief Tests PSW bits without resolving: pending Z/S/P are read
+ *        from ZSP_TABLE. Used by the conditional branches.
+ */
+inline bool alu_test(const CpuFlags& f, const LazyFlags& lz, uint8_t mask)
+{
+    uint8_t psw = lz.zsp_pending ? ((f.psw & ~FLAG_ZSP) | ZSP_TABLE[lz.result]) : f.psw;
+    return (psw & mask) != 0;
+}
+
+// --- Operations ---
+
+/**
+ * @brief INR: returns value + 1. Affects Z, S, P, AC.
+ */
+inline uint8_t alu_inr(LazyFlags& lz, uint8_t value)
+{
+    uint8_t result = value + 1;
+    alu_defer_zsp(lz, result);
+    alu_defer_ac(lz, LazyFlags::AcKind::Add, value, 1, 0);
+    return result;
+}
+
+/**
+ * @brief DCR: returns value - 1. Affects Z, S, P, AC.
+ */
+inline uint8_t alu_dcr(LazyFlags& lz, uint8_t value)
+{
+    uint8_t result = value - 1;
+    alu_defer_zsp(lz, result);
+    alu_defer_ac(lz, LazyFlags::AcKind::Dcr, value, 0, 0);
+    return result;
+}
+
+/**
+ * @brief DAD: returns hl + value. Affects CY only.
+ */
+inline uint16_t alu_dad(CpuFlags& f, uint16_t hl, uint16_t value)
+{
+    uint32_t result = hl + value;
+    f.cy = (result > 0xFFFF);
+    return result & 0xFFFF;
+}
+
+/**
+ * @brief ADD/ADC/ADI/ACI: a = a + value + carry_in. Affects all flags.
+ */
+inline void alu_add(uint8_t& a, CpuFlags& f, LazyFlags& lz, uint8_t value, uint8_t carry_in)
+{
+    uint16_t result = a + value + carry_in;
+    alu_defer_ac(lz, LazyFlags::AcKind::Add, a, value, carry_in);
+    f.cy = result > 0xFF;
+    a = result & 0xFF;
+    alu_defer_zsp(lz, a);
+}
+
+/**
+ * @brief Flags of a - value - borrow, shared by SUB/SBB and CMP.
+ * @return The 8-bit difference.
+ */
+inline uint8_t alu_sub_flags(uint8_t a, CpuFlags& f, LazyFlags& lz, uint8_t value, uint8_t borrow)
+{
+    uint8_t result = a - value - borrow;
+    f.cy = (a < (value + borrow));
+    alu_defer_ac(lz, LazyFlags::AcKind::Sub, a, value, borrow);
+    alu_defer_zsp(lz, result);
+    return result;
+}
+
+/**
+ * @brief SUB/SBB/SUI/SBI: a = a - value - borrow. Affects all flags.
+ */
+inline void alu_sub(uint8_t& a, CpuFlags& f, LazyFlags& lz, uint8_t value, uint8_t borrow)
+{
+    a = alu_sub_flags(a, f, lz, value, borrow);
+}
+
+/**
+ * @brief CMP/CPI: flags of a - value, a is unchanged.
+ */
+inline void alu_cmp(uint8_t a, CpuFlags& f, LazyFlags& lz, uint8_t value)
+{
+    alu_sub_flags(a, f, lz, value, 0);
+}
+
+/**
+ * @brief ANA/ANI: a = a & value. CY cleared, AC = bit 3 of (a | value).
+ */
+inline void alu_ana(uint8_t& a, CpuFlags& f, LazyFlags& lz, uint8_t value)
+{
+    alu_set_ac(f, lz, ((a | value) & 0x08) != 0);
+    a = a & value;
+    f.cy = 0;
+    alu_defer_zsp(lz, a);
+}
+
+/**
+ * @brief XRA/XRI: a = a ^ value. CY and AC cleared.
+ */
+inline void alu_xra(uint8_t& a, CpuFlags& f, LazyFlags& lz, uint8_t value)
+{
+    a = a ^ value;
+    f.cy = 0;
+    alu_set_ac(f, lz, false);
+    alu_defer_zsp(lz, a);
+}
+
+/**
+ * @brief ORA/ORI: a = a | value. CY and AC cleared.
+ */
+inline void alu_ora(uint8_t& a, CpuFlags& f, LazyFlags& lz, uint8_t value)
+{
+    a = a | value;
+    f.cy = 0;
+    alu_set_ac(f, lz, false);
+    alu_defer_zsp(lz, a);
+}
+
+/**
+ * @brief DAA: decimal adjust accumulator. Affects all flags.
+ */
+inline void alu_daa(uint8_t& a, CpuFlags& f, LazyFlags& lz)
+{
+    alu_resolve_ac(f, lz);
+
+    uint8_t lsb = a & 0x0F;
+    uint8_t msb = a >> 4;
+    uint8_t correction = 0;
+
+    if (f.ac || lsb > 9)
+    {
+        correction += 0x06;
+    }
+
+    if (f.cy || msb > 9 || (msb >= 9 && lsb > 9))
+    {
+        correction += 0x60;
+        f.cy = true;
+    }
+
+    a = (a + correction) & 0xFF;
+    alu_defer_zsp(lz, a);
+    alu_set_ac(f, lz, (a & 0x0F) < lsb);
+}
+
+/**
+ * @brief RLC: rotate a left, bit 7 into CY and bit 0.
+ */
+inline void alu_rlc(uint8_t& a, CpuFlags& f)
+{
+    f.cy = (a & 0x80) != 0;
+    a = (a << 1) | (a >> 7);
+}
+
+/**
+ * @brief RRC: rotate a right, bit 0 into CY and bit 7.
+ */
+inline void alu_rrc(uint8_t& a, CpuFlags& f)
+{
+    f.cy = (a & 0x01) != 0;
+    a = (a >> 1) | (a << 7);
+}
+
+/**
+ * @brief RAR: rotate a right through CY.
+ */
+inline void alu_rar(uint8_t& a, CpuFlags& f)
+{
+    bool old_cy = f.cy;
+    f.cy = (a & 0x01) != 0;
+    a = (a >> 1) | (old_cy ? 0x80 : 0x00);
+}
+
+/**
+ * @brief Packs the flags into the PSW byte pushed by PUSH PSW.
+ *        Layout: S Z 0 AC 0 P 1 CY.
+ */
+inline uint8_t alu_pack_psw(CpuFlags& f, LazyFlags& lz)
+{
+    alu_resolve(f, lz);
+    return (f.psw & PSW_VALID_BITS) | PSW_FIXED_ONES;
+}
+
+/**
+ * @brief Unpacks a PSW byte popped by POP PSW, dropping pending flags.
+ */
+inline void alu_unpack_psw(CpuFlags& f, LazyFlags& lz, uint8_t psw)
+{
+    f.psw = (psw & PSW_VALID_BITS) | PSW_FIXED_ONES;
+    lz = LazyFlags{};
+}
+
+#endif /* ALU_HPP_ */
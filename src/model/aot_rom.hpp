@@ -0,0 +1,97 @@
+/**********************************************************
+ * @file aot_rom.hpp
+ *
+ * @brief Interface between the ahead-of-time recompiled ROM and
+ *        the emulator. tools/rom_recompiler translates the ROM into
+ *        a C++ file with one function per basic block; that file
+ *        (or aot_rom_stub.cpp when no ROM was recompiled) defines
+ *        AOT_ROM, which the Aot backend runs.
+ *
+ *        Generated blocks work on CPUState, LazyFlags and Memory
+ *        with the same alu.hpp helpers as the interpreter, and end by
+ *        storing the next PC and returning the cycles they used.
+ *        Indirect control flow simply stores a PC without a block;
+ *        the interpreter takes over from there.
+ *
+ * @author Jese/Arnav (CPU Core)
+ *
+ *********************************************************/
+#ifndef AOT_ROM_HPP_
+#define AOT_ROM_HPP_
+
+/***************** Include files. ***********************/
+#include "emulator.hpp"
+#include "alu.hpp"
+#include "memory.hpp"
+#include <cstddef>
+#include <cstdint>
+
+/***************** Global Types. ***********************/
+
+/**
+ * @brief A recompiled basic block: runs every instruction from start,
+ *        leaves state.pc at the next instruction and returns the
+ *        cycles executed. lead_cycles is the cost of all but the last
+ *        instruction, the block runs when more than that is left.
+ */
+struct AotBlock
+{
+    uint16_t start;
+    uint16_t lead_cycles;
+    int (*run)(CPUState& s, LazyFlags& lz, Memory& m);
+};
+
+/**
+ * @brief A recompiled ROM image. rom_hash is aot_rom_hash() of the ROM
+ *        the blocks were generated from; block_count is 0 in the stub.
+ */
+struct AotRom
+{
+    uint64_t rom_hash;
+    const AotBlock* blocks;
+    size_t block_count;
+};
+
+/***************** Global Variables. ***********************/
+
+/**
+ * @brief The ROM linked into this build (generated file or stub).
+ */
+extern const AotRom AOT_ROM;
+
+/***************** Global Functions. ***********************/
+
+/**
+ * @brief FNV-1a hash of the ROM region (0x0000-0x1FFF).
+ */
+inline uint64_t aot_rom_hash(const Memory& m)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (uint32_t addr = 0; addr < 0x2000; ++addr)
+    {
+        hash = (hash ^ m.ReadByte(static_cast<uint16_t>(addr))) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// --- Helpers used by the generated code ---
+
+inline uint16_t aot_pair(uint8_t hi, uint8_t lo)
+{
+    return static_cast<uint16_t>((hi << 8) | lo);
+}
+
+inline void aot_push(CPUState& s, Memory& m, uint16_t value)
+{
+    s.sp -= 2;
+    m.WriteWord(s.sp, value);
+}
+
+inline uint16_t aot_pop(CPUState& s, Memory& m)
+{
+    uint16_t value = m.ReadWord(s.sp);
+    s.sp += 2;
+    return value;
+}
+
+#endif /* AOT_ROM_HPP_ */
@@ -0,0 +1,17 @@
+/**********************************************************
+ * @file aot_rom_stub.cpp
+ *
+ * @brief Empty AOT_ROM, linked when the build has no recompiled ROM
+ *        (SPACE_INVADERS_ROM_DIR not set). The Aot backend reports
+ *        itself unavailable in that case.
+ *
+ * @author Jese/Arnav (CPU Core)
+ *
+ *********************************************************/
+
+/***************** Include files. ***********************/
+#include "aot_rom.hpp"
+
+/***************** Global Variables. ***********************/
+
+const AotRom AOT_ROM = {0, nullptr, 0};
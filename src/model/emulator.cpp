@@ -9,8 +9,10 @@
 
 /***************** Include files. ***********************/
 #include "emulator.hpp"
+#include "alu.hpp"
+#include "aot_rom.hpp"
 #include <iostream>
-#include <algorithm> // For std::copy
+#include <cstring>   // For std::memcpy
 #include "memory.hpp"
 #include "romloader.hpp"
 
@@ -23,6 +25,13 @@
 
 /***************** Local Functions. ***********************/
 
+// Maps the 3-bit register code of an opcode to its CPUState field.
+// REG_M (6) has no register and is handled by the callers.
+static constexpr uint8_t CPUState::* REGISTER_FIELDS[8] = {
+    &CPUState::b, &CPUState::c, &CPUState::d, &CPUState::e,
+    &CPUState::h, &CPUState::l, nullptr,      &CPUState::a
+};
+
 /***************** Global Class Functions. ***********************/
 
 /**
@@ -37,357 +46,483 @@ void Emulator::reset()
 {
     state = {}; // Zero-initialize all registers and flags
     state.port_in_1.bit_3_reserved = 1; // Bit 3 is always 1 (Not sure if it's relevant to the game, though.)
+    state.flags.bit_1_reserved = 1;     // PSW bit 1 is always 1.
     state.pc = 0x0000; // Start execution from the beginning of memory
     state.sp = 0x0000;
+    lazy_flags = {};
     memory.Clear();
+
+    cycle_count = 0;
+    scheduler.clear();
+    scheduler.schedule(EventId::MidScreen, CYCLES_PER_FRAME / 2);
+    scheduler.schedule(EventId::VBlank, CYCLES_PER_FRAME);
 }
 
 bool Emulator::loadROM(const std::string& romFilePath)
 {
     // Load the given ROM file starting at address 0x0000
-    return LoadSpaceInvadersROM(memory, romFilePath);
+    uint64_t loadTimeUs = 0;
+    if (!LoadSpaceInvadersROM(memory, romFilePath, &loadTimeUs))
+    {
+        return false;
+    }
+    rom_load_time_us = loadTimeUs;
+
+    // Instances that loaded the same ROM read one process-wide copy.
+    memory.ShareRom();
+    return true;
+}
+
+uint64_t Emulator::getRomLoadTimeUs() const
+{
+    return rom_load_time_us;
+}
+
+int Emulator::executeInstruction()
+{
+    uint8_t opcode = memory.ReadByte(state.pc);
+    const OpcodeInfo& info = OPCODE_TABLE[opcode];
+    uint16_t sp = state.sp;
+    info.execute(*this, opcode);
+
+    // A conditional CALL/RET only moves SP when it is taken.
+    return (info.cycles_taken != info.cycles && state.sp != sp) ? info.cycles_taken : info.cycles;
 }
 
-void Emulator::emulateCycles(int cycles)
+int Emulator::emulateCycles(int cycles)
 {
-    // This is a simplified cycle loop. A real implementation would
-    // decrement cycles based on the cost of each instruction.
-    // For now, we'll treat it as "number of instructions to execute".
-    for (int i = 0; i < cycles; ++i)
+    int executed = 0;
+    if (!state.halted)
+    {
+        switch (backend)
+        {
+            case CpuBackend::Threaded:   { executed = runThreaded(cycles); break; }
+            case CpuBackend::BlockCache: { executed = runBlocks(cycles); break; }
+            case CpuBackend::Jit:        { executed = runJit(cycles); break; }
+            case CpuBackend::Aot:        { executed = runAot(cycles); break; }
+            default:                     { executed = runTable(cycles); break; }
+        }
+    }
+
+    // A halted CPU does nothing until the next interrupt, which only
+    // arrives between batches: the rest of the budget passes at once.
+    if (state.halted && executed < cycles)
+    {
+        executed = cycles;
+    }
+    cycle_count += executed;
+    return executed;
+}
+
+int Emulator::runUntilFrameEnd(uint8_t* frame)
+{
+    uint64_t start = cycle_count;
+    bool frame_done = false;
+    while (!frame_done)
+    {
+        // The backends stop at the first instruction boundary at or past
+        // the deadline, so this is the only check per block.
+        uint64_t deadline = scheduler.nextDeadline();
+        if (deadline > cycle_count)
+        {
+            int executed = emulateCycles(static_cast<int>(deadline - cycle_count));
+            if (executed == 0)
+            {
+                // PC ran off the end of memory, the CPU cannot advance.
+                cycle_count = deadline;
+            }
+        }
+
+        ScheduledEvent event;
+        while (scheduler.popDue(cycle_count, event))
+        {
+            frame_done = dispatchEvent(event, frame) || frame_done;
+        }
+    }
+    return static_cast<int>(cycle_count - start);
+}
+
+uint64_t Emulator::getCycleCount() const
+{
+    return cycle_count;
+}
+
+bool Emulator::dispatchEvent(const ScheduledEvent& event, uint8_t* frame)
+{
+    const uint32_t half = Memory::VRAM_ROWS / 2;
+
+    // Reschedule from the deadline, not from cycle_count, so instruction
+    // overshoot never accumulates into drift.
+    switch (event.id)
+    {
+        case EventId::MidScreen:
+        {
+            // Trigger the mid-screen interrupt (RST 1). This is a
+            // characteristic of the original Space Invaders hardware.
+            if (frame != nullptr)
+            {
+                copyDirtyRows(frame, 0, half);
+            }
+            requestInterrupt(1);
+            scheduler.schedule(EventId::MidScreen, event.when + CYCLES_PER_FRAME);
+            return false;
+        }
+        case EventId::VBlank:
+        {
+            // Trigger the V-Blank interrupt (RST 2). This signals the end of a frame.
+            if (frame != nullptr)
+            {
+                copyDirtyRows(frame, half, Memory::VRAM_ROWS);
+                frame_target = frame;
+            }
+            requestInterrupt(2);
+            scheduler.schedule(EventId::VBlank, event.when + CYCLES_PER_FRAME);
+            return true;
+        }
+        default:
+        {
+            return false;
+        }
+    }
+}
+
+void Emulator::copyDirtyRows(uint8_t* frame, uint32_t first, uint32_t last)
+{
+    // Rows not copied now stay dirty in memory for the next copy.
+    Memory::DirtyRows rows = memory.ConsumeDirtyRows(first, last);
+    if (frame != frame_target)
+    {
+        for (uint32_t row = first; row < last; ++row)
+        {
+            rows.set(row);
+        }
+    }
+
+    const uint8_t* vram = memory.GetVRAMPointer();
+    for (uint32_t row = first; row < last; ++row)
+    {
+        if (rows.test(row))
+        {
+            size_t offset = row << Memory::VRAM_ROW_SHIFT;
+            std::memcpy(frame + offset, vram + offset, Memory::VRAM_ROW_SIZE);
+        }
+    }
+    frame_dirty_rows |= rows;
+}
+
+Memory::DirtyRows Emulator::consumeDirtyRows()
+{
+    Memory::DirtyRows rows = frame_dirty_rows;
+    frame_dirty_rows.reset();
+    return rows;
+}
+
+int Emulator::runTable(int cycles)
+{
+    // Every instruction is charged its 8080 cycle count; the last one
+    // may end past the budget.
+    int remaining = cycles;
+    while (remaining > 0 && !state.halted)
     {
         if (state.pc >= 0xFFFF)
         {
             // Prevent execution from running off the end of memory
             break; 
         }
-        executeInstruction();
+        uint16_t pc = state.pc;
+        remaining -= executeInstruction();
+
+        // Idle loops end in a jump back to their head.
+        if (state.pc <= pc && remaining > 0 && idleLoopHead(state.pc))
+        {
+            remaining -= skipIdleLoop(remaining);
+        }
     }
+    return endBatch(cycles, remaining);
+}
+
+int Emulator::endBatch(int cycles, int remaining)
+{
+    // Leave state.flags complete for getCPUState() and the controller.
+    alu_resolve(state.flags, lazy_flags);
+    return cycles - remaining;
+}
+
+template <std::size_t... I>
+constexpr void Emulator::fillMovGroup(std::array<OpcodeInfo, 256>& table, std::index_sequence<I...>)
+{
+    // I is the opcode offset from 0x40: bits 3-5 = destination, bits 0-2 = source.
+    ((table[0x40 + I] = entry<&Emulator::op_MOV<static_cast<RegisterCode>((I >> 3) & 0x07),
+                                                static_cast<RegisterCode>(I & 0x07)>, 1>(
+          (((I >> 3) & 0x07) == REG_M || (I & 0x07) == REG_M) ? 7 : 5,
+          (((I >> 3) & 0x07) == REG_M || (I & 0x07) == REG_M) ? 7 : 5)), ...);
+}
+
+template <std::size_t... I>
+constexpr void Emulator::fillAluGroup(std::array<OpcodeInfo, 256>& table, std::index_sequence<I...>)
+{
+    // I is the opcode offset from 0x80: bits 3-5 = operation, bits 0-2 = source.
+    ((table[0x80 + I] = entry<&Emulator::op_ALU<static_cast<AluOp>((I >> 3) & 0x07),
+                                                static_cast<RegisterCode>(I & 0x07)>, 1>(
+          ((I & 0x07) == REG_M) ? 7 : 4,
+          ((I & 0x07) == REG_M) ? 7 : 4)), ...);
 }
 
-void Emulator::executeInstruction()
+/**
+ * @brief Builds the opcode dispatch table.
+ *
+ * Cycle counts follow the Intel 8080 datasheet. cycles_taken only
+ * differs from cycles for conditional CALL (11/17) and RET (5/11).
+ */
+constexpr std::array<Emulator::OpcodeInfo, 256> Emulator::buildOpcodeTable()
 {
-     uint8_t opcode = memory.ReadByte(state.pc);
+    std::array<OpcodeInfo, 256> table{};
 
-    // Checks for MOV opcodes.
-    if ((opcode & 0xC0) == 0x40 && opcode != 0x76) // 0x76 is the opcode for HLT and not a MOV opcode
+    // Default every opcode to the unimplemented handler.
+    for (int op = 0; op < 256; ++op)
     {
-        RegisterCode dst = (RegisterCode)((opcode >> 3) & 0x07);  // Determines which register to set
-        RegisterCode src = (RegisterCode)(opcode & 0x07);  // Determines which register to get value from
-        set_reg(dst, get_reg(src));
-        state.pc += 1;
-        return;
+        table[op] = entry<&Emulator::op_UNIMPLEMENTED, 1>(4, 4);
     }
 
-    // Switch statement for rest of the opcodes
-    switch (opcode)
+    // Data Transfer Group
+    table[0x01] = entry<&Emulator::op_LXI_B, 3>(10, 10);
+    table[0x02] = entry<&Emulator::op_STAX_B, 1>(7, 7);
+    table[0x06] = entry<&Emulator::op_MVI_B, 2>(7, 7);
+    table[0x0A] = entry<&Emulator::op_LDAX_B, 1>(7, 7);
+    table[0x0E] = entry<&Emulator::op_MVI_C, 2>(7, 7);
+    table[0x11] = entry<&Emulator::op_LXI_D, 3>(10, 10);
+    table[0x12] = entry<&Emulator::op_STAX_D, 1>(7, 7);
+    table[0x16] = entry<&Emulator::op_MVI_D, 2>(7, 7);
+    table[0x1A] = entry<&Emulator::op_LDAX_D, 1>(7, 7);
+    table[0x1E] = entry<&Emulator::op_MVI_E, 2>(7, 7);
+    table[0x21] = entry<&Emulator::op_LXI_H, 3>(10, 10);
+    table[0x22] = entry<&Emulator::op_SHLD, 3>(16, 16);
+    table[0x26] = entry<&Emulator::op_MVI_H, 2>(7, 7);
+    table[0x2A] = entry<&Emulator::op_LHLD, 3>(16, 16);
+    table[0x2E] = entry<&Emulator::op_MVI_L, 2>(7, 7);
+    table[0x31] = entry<&Emulator::op_LXI_SP, 3>(10, 10);
+    table[0x32] = entry<&Emulator::op_STA, 3>(13, 13);
+    table[0x36] = entry<&Emulator::op_MVI_M, 2>(10, 10);
+    table[0x3A] = entry<&Emulator::op_LDA, 3>(13, 13);
+    table[0x3E] = entry<&Emulator::op_MVI_A, 2>(7, 7);
+    table[0xEB] = entry<&Emulator::op_XCHG, 1>(4, 4);
+
+    // MOV r,r / MOV r,M / MOV M,r (0x76 is HLT, set below).
+    fillMovGroup(table, std::make_index_sequence<64>{});
+
+    // Arithmetic Group
+    table[0x03] = entry<&Emulator::op_INX_B, 1>(5, 5);
+    table[0x04] = entry<&Emulator::op_INR_B, 1>(5, 5);
+    table[0x05] = entry<&Emulator::op_DCR_B, 1>(5, 5);
+    table[0x09] = entry<&Emulator::op_DAD_B, 1>(10, 10);
+    table[0x0B] = entry<&Emulator::op_DCX_B, 1>(5, 5);
+    table[0x0C] = entry<&Emulator::op_INR_C, 1>(5, 5);
+    table[0x0D] = entry<&Emulator::op_DCR_C, 1>(5, 5);
+    table[0x13] = entry<&Emulator::op_INX_D, 1>(5, 5);
+    table[0x14] = entry<&Emulator::op_INR_D, 1>(5, 5);
+    table[0x15] = entry<&Emulator::op_DCR_D, 1>(5, 5);
+    table[0x19] = entry<&Emulator::op_DAD_D, 1>(10, 10);
+    table[0x1B] = entry<&Emulator::op_DCX_D, 1>(5, 5);
+    table[0x1C] = entry<&Emulator::op_INR_E, 1>(5, 5);
+    table[0x1D] = entry<&Emulator::op_DCR_E, 1>(5, 5);
+    table[0x23] = entry<&Emulator::op_INX_H, 1>(5, 5);
+    table[0x24] = entry<&Emulator::op_INR_H, 1>(5, 5);
+    table[0x25] = entry<&Emulator::op_DCR_H, 1>(5, 5);
+    table[0x27] = entry<&Emulator::op_DAA, 1>(4, 4);
+    table[0x29] = entry<&Emulator::op_DAD_H, 1>(10, 10);
+    table[0x2B] = entry<&Emulator::op_DCX_H, 1>(5, 5);
+    table[0x2C] = entry<&Emulator::op_INR_L, 1>(5, 5);
+    table[0x2D] = entry<&Emulator::op_DCR_L, 1>(5, 5);
+    table[0x34] = entry<&Emulator::op_INR_M, 1>(10, 10);
+    table[0x35] = entry<&Emulator::op_DCR_M, 1>(10, 10);
+    table[0x39] = entry<&Emulator::op_DAD_SP, 1>(10, 10);
+    table[0x3C] = entry<&Emulator::op_INR_A, 1>(5, 5);
+    table[0x3D] = entry<&Emulator::op_DCR_A, 1>(5, 5);
+    table[0xC6] = entry<&Emulator::op_ADI, 2>(7, 7);
+    table[0xCE] = entry<&Emulator::op_ACI, 2>(7, 7);
+    table[0xD6] = entry<&Emulator::op_SUI, 2>(7, 7);
+    table[0xDE] = entry<&Emulator::op_SBI, 2>(7, 7);
+
+    // Logical Group
+    table[0x07] = entry<&Emulator::op_RLC, 1>(4, 4);
+    table[0x0F] = entry<&Emulator::op_RRC, 1>(4, 4);
+    table[0x1F] = entry<&Emulator::op_RAR, 1>(4, 4);
+    table[0x2F] = entry<&Emulator::op_CMA, 1>(4, 4);
+    table[0x37] = entry<&Emulator::op_STC, 1>(4, 4);
+    table[0x3F] = entry<&Emulator::op_CMC, 1>(4, 4);
+    table[0xE6] = entry<&Emulator::op_ANI, 2>(7, 7);
+    table[0xEE] = entry<&Emulator::op_XRI, 2>(7, 7);
+    table[0xF6] = entry<&Emulator::op_ORI, 2>(7, 7);
+    table[0xFE] = entry<&Emulator::op_CPI, 2>(7, 7);
+
+    // 0x80-0xBF: ALU A,r / A,M. Bits 3-5 select the operation.
+    fillAluGroup(table, std::make_index_sequence<64>{});
+
+    // Branch Group. Conditional opcodes share one handler each,
+    // bits 3-5 select the condition (NZ, Z, NC, C, PO, PE, P, M).
+    table[0xC3] = entry<&Emulator::op_JMP, 3>(10, 10);
+    table[0xC9] = entry<&Emulator::op_RET, 1>(10, 10);
+    table[0xCD] = entry<&Emulator::op_CALL, 3>(17, 17);
+    table[0xE9] = entry<&Emulator::op_PCHL, 1>(5, 5);
+    for (int cc = 0; cc < 8; ++cc)
     {
-        case 0x00: op_NOP(); state.pc += 1; break;
-        case 0x01: op_LXI_B(); state.pc += 3; break;
-        case 0x02: op_STAX_B(); state.pc += 1; break;
-        case 0x03: op_INX_B(); state.pc += 1; break;
-        case 0x04: op_INR_B(); state.pc += 1; break;
-        case 0x05: op_DCR_B(); state.pc += 1; break;
-        case 0x06: op_MVI_B(); state.pc += 2; break;
-        case 0x07: op_RLC(); state.pc += 1; break;
-        case 0x09: op_DAD_B(); state.pc += 1; break;
-        case 0x0a: op_LDAX_B(); state.pc += 1; break;
-        case 0x0b: op_DCX_B(); state.pc += 1; break;
-        case 0x0c: op_INR_C(); state.pc += 1; break;
-        case 0x0d: op_DCR_C(); state.pc += 1; break;
-        case 0x0e: op_MVI_C(); state.pc += 2; break;
-        case 0x0f: op_RRC(); state.pc += 1; break;
-        case 0x11: op_LXI_D(); state.pc += 3; break;
-        case 0x12: op_STAX_D(); state.pc += 1; break;
-        case 0x13: op_INX_D(); state.pc += 1; break;
-        case 0x14: op_INR_D(); state.pc += 1; break;
-        case 0x15: op_DCR_D(); state.pc += 1; break;
-        case 0x16: op_MVI_D(); state.pc += 2; break;
-        case 0x19: op_DAD_D(); state.pc += 1; break;
-        case 0x1a: op_LDAX_D(); state.pc += 1; break;
-        case 0x1b: op_DCX_D(); state.pc += 1; break;
-        case 0x1c: op_INR_E(); state.pc += 1; break;
-        case 0x1d: op_DCR_E(); state.pc += 1; break;
-        case 0x1e: op_MVI_E(); state.pc += 2; break;
-        case 0x1f: op_RAR(); state.pc += 1; break;
-        case 0x21: op_LXI_H(); state.pc += 3; break;
-        case 0x22: op_SHLD(); state.pc += 3; break;
-        case 0x23: op_INX_H(); state.pc += 1; break;
-        case 0x24: op_INR_H(); state.pc += 1; break;
-        case 0x25: op_DCR_H(); state.pc += 1; break;
-        case 0x26: op_MVI_H(); state.pc += 2; break;
-        case 0x27: op_DAA(); state.pc += 1; break;
-        case 0x29: op_DAD_H(); state.pc += 1; break;
-        case 0x2a: op_LHLD(); state.pc += 3; break;
-        case 0x2b: op_DCX_H(); state.pc += 1; break;
-        case 0x2c: op_INR_L(); state.pc += 1; break;
-        case 0x2d: op_DCR_L(); state.pc += 1; break;
-        case 0x2e: op_MVI_L(); state.pc += 2; break;
-        case 0x2f: op_CMA(); state.pc += 1; break;
-        case 0x31: op_LXI_SP(); state.pc += 3; break;
-        case 0x32: op_STA(); state.pc += 3; break;
-        case 0x34: op_INR_M(); state.pc += 1; break;
-        case 0x35: op_DCR_M(); state.pc += 1; break;
-        case 0x36: op_MVI_M(); state.pc += 2; break;
-        case 0x37: op_STC(); state.pc += 1; break;
-        case 0x39: op_DAD_SP(); state.pc += 1; break;
-        case 0x3a: op_LDA(); state.pc += 3; break;
-        case 0x3c: op_INR_A(); state.pc += 1; break;
-        case 0x3d: op_DCR_A(); state.pc += 1; break;
-        case 0x3e: op_MVI_A(); state.pc += 2; break;
-        case 0x3f: op_CMC(); state.pc += 1; break;
-        case 0x76: op_HLT(); state.pc += 1; break;
-        case 0xc1: op_POP_B(); state.pc += 1; break;
-        case 0xc3: op_JMP(); break;
-        case 0xc5: op_PUSH_B(); state.pc += 1; break;
-        case 0xc9: op_RET(); break;
-        case 0xcd: op_CALL(); break;
-        case 0xd1: op_POP_D(); state.pc += 1; break;
-        case 0xd5: op_PUSH_D(); state.pc += 1; break;
-        case 0xe1: op_POP_H(); state.pc += 1; break;
-        case 0xe3: op_XTHL(); state.pc += 1; break;
-        case 0xe5: op_PUSH_H(); state.pc += 1; break;
-        case 0xe9: op_PCHL(); break;
-        case 0xeb: op_XCHG(); state.pc += 1; break;
-        case 0xf1: op_POP_PSW(); state.pc += 1; break;
-        case 0xf5: op_PUSH_PSW(); state.pc += 1; break;
-        case 0xfb: op_EI(); state.pc += 1; break;
-        case 0x80: op_ADD(state.b); state.pc += 1; break;  // ADD B 
-        case 0x81: op_ADD(state.c); state.pc += 1; break;  // ADD C
-        case 0x82: op_ADD(state.d); state.pc += 1; break;  // ADD D
-        case 0x83: op_ADD(state.e); state.pc += 1; break;  // ADD E
-        case 0x84: op_ADD(state.h); state.pc += 1; break;  // ADD H
-        case 0x85: op_ADD(state.l); state.pc += 1; break;  // ADD L
-        case 0x86: op_ADD(memory.ReadByte(hl())); state.pc += 1; break;   // ADD M
-        case 0x87: op_ADD(state.a); state.pc += 1; break;  // ADD A
-        case 0x88: op_ADC(state.b); state.pc += 1; break;  // ADC B
-        case 0x89: op_ADC(state.c); state.pc += 1; break;  // ADC C
-        case 0x8A: op_ADC(state.d); state.pc += 1; break;  // ADC D
-        case 0x8B: op_ADC(state.e); state.pc += 1; break;  // ADC E
-        case 0x8C: op_ADC(state.h); state.pc += 1; break;  // ADC H
-        case 0x8D: op_ADC(state.l); state.pc += 1; break;  // ADC L
-        case 0x8E: op_ADC(memory.ReadByte(hl())); state.pc += 1; break;   // ADC M
-        case 0x8F: op_ADC(state.a); state.pc += 1; break;  // ADC A
-        case 0x90: op_SUB(state.b); state.pc += 1; break;  // SUB B
-        case 0x91: op_SUB(state.c); state.pc += 1; break;  // SUB C
-        case 0x92: op_SUB(state.d); state.pc += 1; break;  // SUB D
-        case 0x93: op_SUB(state.e); state.pc += 1; break;  // SUB E
-        case 0x94: op_SUB(state.h); state.pc += 1; break;  // SUB H
-        case 0x95: op_SUB(state.l); state.pc += 1; break;  // SUB L
-        case 0x96: op_SUB(memory.ReadByte(hl())); state.pc += 1; break;  // SUB M
-        case 0x97: op_SUB(state.a); state.pc += 1; break;  // SUB A
-        case 0x98: op_SBB(state.b); state.pc += 1; break;  // SBB B
-        case 0x99: op_SBB(state.c); state.pc += 1; break;  // SBB C
-        case 0x9A: op_SBB(state.d); state.pc += 1; break;  // SBB D
-        case 0x9B: op_SBB(state.e); state.pc += 1; break;  // SBB E
-        case 0x9C: op_SBB(state.h); state.pc += 1; break;  // SBB H
-        case 0x9D: op_SBB(state.l); state.pc += 1; break;  // SBB L
-        case 0x9E: op_SBB(memory.ReadByte(hl())); state.pc += 1; break;  // SBB M
-        case 0x9F: op_SBB(state.a); state.pc += 1; break;  // SBB A
-        case 0xA0: op_ANA(state.b); state.pc += 1; break;  // ANA B
-        case 0xA1: op_ANA(state.c); state.pc += 1; break;  // ANA C
-        case 0xA2: op_ANA(state.d); state.pc += 1; break;  // ANA D
-        case 0xA3: op_ANA(state.e); state.pc += 1; break;  // ANA E
-        case 0xA4: op_ANA(state.h); state.pc += 1; break;  // ANA H
-        case 0xA5: op_ANA(state.l); state.pc += 1; break;  // ANA L
-        case 0xA6: op_ANA(memory.ReadByte(hl())); state.pc += 1; break;  // ANA M
-        case 0xA7: op_ANA(state.a); state.pc += 1; break;  // ANA A
-        case 0xA8: op_XRA(state.b); state.pc += 1; break;  // XRA B
-        case 0xA9: op_XRA(state.c); state.pc += 1; break;  // XRA C
-        case 0xAA: op_XRA(state.d); state.pc += 1; break;  // XRA D
-        case 0xAB: op_XRA(state.e); state.pc += 1; break;  // XRA E
-        case 0xAC: op_XRA(state.h); state.pc += 1; break;  // XRA H
-        case 0xAD: op_XRA(state.l); state.pc += 1; break;  // XRA L
-        case 0xAE: op_XRA(memory.ReadByte(hl())); state.pc += 1; break; // XRA M
-        case 0xAF: op_XRA(state.a); state.pc += 1; break;  // XRA A
-        case 0xB0: op_ORA(state.b); state.pc += 1; break;  // ORA B
-        case 0xB1: op_ORA(state.c); state.pc += 1; break;  // ORA C
-        case 0xB2: op_ORA(state.d); state.pc += 1; break;  // ORA D
-        case 0xB3: op_ORA(state.e); state.pc += 1; break;  // ORA E
-        case 0xB4: op_ORA(state.h); state.pc += 1; break;  // ORA H
-        case 0xB5: op_ORA(state.l); state.pc += 1; break;  // ORA L
-        case 0xB6: op_ORA(memory.ReadByte(hl())); state.pc += 1; break;  // ORA M
-        case 0xB7: op_ORA(state.a); state.pc += 1; break;  // ORA A
-        case 0xB8: op_CMP(state.b); state.pc += 1; break;  // CMP B
-        case 0xB9: op_CMP(state.c); state.pc += 1; break;  // CMP C
-        case 0xBA: op_CMP(state.d); state.pc += 1; break;  // CMP D
-        case 0xBB: op_CMP(state.e); state.pc += 1; break;  // CMP E
-        case 0xBC: op_CMP(state.h); state.pc += 1; break;  // CMP H
-        case 0xBD: op_CMP(state.l); state.pc += 1; break;  // CMP L
-        case 0xBE: op_CMP(memory.ReadByte(hl())); state.pc += 1; break;  // CMP M
-        case 0xBF: op_CMP(state.a); state.pc += 1; break;  // CMP A
-        case 0xC0: op_RET_cond(!state.flags.z); break;  // RNZ
-        case 0xC2: op_JMP_cond(!state.flags.z); break;  // JNZ addr
-        case 0xC4: op_CALL_cond(!state.flags.z); break;  // CNZ addr
-        case 0xC6: op_ADI(memory.ReadByte(state.pc + 1)); state.pc += 2; break;  // ADI d8
-        case 0xC8: op_RET_cond(state.flags.z); break;  // RZ
-        case 0xCA: op_JMP_cond(state.flags.z); break;  // JZ addr
-        case 0xCC: op_CALL_cond(state.flags.z); break; // CZ addr
-        case 0xCE: op_ACI(memory.ReadByte(state.pc + 1)); state.pc += 2; break;  // ACI d8
-        case 0xD0: op_RET_cond(!state.flags.cy); break;  // RNC
-        case 0xD2: op_JMP_cond(!state.flags.cy); break;  // JNC addr
-        case 0xD4: op_CALL_cond(!state.flags.cy); break;  // CNC addr
-        case 0xD6: op_SUI(memory.ReadByte(state.pc + 1)); state.pc += 2; break;  // SUI d8
-        case 0xDE: op_SBI(memory.ReadByte(state.pc + 1)); state.pc += 2; break;  // SBI d8
-        case 0xD8: op_RET_cond(state.flags.cy); break;  // RC
-        case 0xDA: op_JMP_cond(state.flags.cy); break;  // JC addr
-        case 0xDC: op_CALL_cond(state.flags.cy); break;  // CC addr
-        case 0xE0: op_RET_cond(!state.flags.p); break;  // RPO
-        case 0xE2: op_JMP_cond(!state.flags.p); break;  // JPO addr
-        case 0xE4: op_CALL_cond(!state.flags.p); break;  // CPO addr
-        case 0xE6: op_ANA(memory.ReadByte(state.pc + 1)); state.pc += 2; break; // ANI d8
-        case 0xE8: op_RET_cond(state.flags.p); break;  // RPE
-        case 0xEA: op_JMP_cond(state.flags.p); break;  // JPE addr
-        case 0xEC: op_CALL_cond(state.flags.p); break;  // CPE addr
-        case 0xEE: op_XRA(memory.ReadByte(state.pc + 1)); state.pc += 2; break; // XRI d8
-        case 0xF0: op_RET_cond(!state.flags.s); break;  // RP
-        case 0xF2: op_JMP_cond(!state.flags.s); break;  // JP addr
-        case 0xF4: op_CALL_cond(!state.flags.s); break;  // CP addr
-        case 0xF6: op_ORA(memory.ReadByte(state.pc + 1)); state.pc += 2; break; // ORI d8
-        case 0xC7: op_RST(0); break;  // RST 0 | Call address 0x00
-        case 0xCF: op_RST(1); break;  // RST 1 | Call address 0x08
-        case 0xD7: op_RST(2); break;  // RST 2 | Call address 0x10
-        case 0xDF: op_RST(3); break;  // RST 3 | Call address 0x18
-        case 0xE7: op_RST(4); break;  // RST 4 | Call address 0x20
-        case 0xEF: op_RST(5); break;  // RST 5 | Call address 0x28
-        case 0xF7: op_RST(6); break;  // RST 6 | Call address 0x30
-        case 0xFF: op_RST(7); break;  // RST 7 | Call address 0x38
-        case 0xF9: op_SPHL(); state.pc += 1; break;  // SPHL: SP ← HL
-        case 0xF8: op_RET_cond(state.flags.s); break;  // RM
-        case 0xFA: op_JMP_cond(state.flags.s); break;  // JM addr
-        case 0xFC: op_CALL_cond(state.flags.s); break;  // CM addr
-        case 0xFE: op_CMP(memory.ReadByte(state.pc + 1)); state.pc += 2; break;  // CPI d8
-        case 0xD3: op_OUT(); state.pc += 2; break;  // OUT d8
-        case 0xDB: op_IN(); state.pc += 2; break;  // IN d8
+        table[0xC0 | (cc << 3)] = entry<&Emulator::op_RET_cond, 1>(5, 11);
+        table[0xC2 | (cc << 3)] = entry<&Emulator::op_JMP_cond, 3>(10, 10);
+        table[0xC4 | (cc << 3)] = entry<&Emulator::op_CALL_cond, 3>(11, 17);
+        table[0xC7 | (cc << 3)] = entry<&Emulator::op_RST, 1>(11, 11);
+    }
 
-        default:
-            std::cerr << "Error: Unimplemented opcode " 
-                      << std::hex << static_cast<int>(opcode) 
-                      << " at address " << std::hex << (state.pc) 
-                      << std::endl;
-            state.pc++; // Advance past the unknown opcode
-            break;
+    // Stack, I/O, and Machine Control Group
+    table[0x00] = entry<&Emulator::op_NOP, 1>(4, 4);
+    table[0x76] = entry<&Emulator::op_HLT, 1>(7, 7);
+    table[0xC1] = entry<&Emulator::op_POP_B, 1>(10, 10);
+    table[0xC5] = entry<&Emulator::op_PUSH_B, 1>(11, 11);
+    table[0xD1] = entry<&Emulator::op_POP_D, 1>(10, 10);
+    table[0xD5] = entry<&Emulator::op_PUSH_D, 1>(11, 11);
+    table[0xE1] = entry<&Emulator::op_POP_H, 1>(10, 10);
+    table[0xE3] = entry<&Emulator::op_XTHL, 1>(18, 18);
+    table[0xE5] = entry<&Emulator::op_PUSH_H, 1>(11, 11);
+    table[0xF1] = entry<&Emulator::op_POP_PSW, 1>(10, 10);
+    table[0xF5] = entry<&Emulator::op_PUSH_PSW, 1>(11, 11);
+    table[0xF9] = entry<&Emulator::op_SPHL, 1>(5, 5);
+    table[0xFB] = entry<&Emulator::op_EI, 1>(4, 4);
+    table[0xD3] = entry<&Emulator::op_OUT, 2>(10, 10);
+    table[0xDB] = entry<&Emulator::op_IN, 2>(10, 10);
+
+    // Opcodes that can leave straight-line code end a basic block.
+    for (int op = 0xC0; op <= 0xFF; ++op)
+    {
+        uint8_t low = op & 0x07;
+        table[op].ends_block = (low == 0x00 || low == 0x02 || low == 0x04 || low == 0x07);
     }
+    table[0xC3].ends_block = true;
+    table[0xC9].ends_block = true;
+    table[0xCD].ends_block = true;
+    table[0xE9].ends_block = true;
+    table[0x76].ends_block = true;
+
+    return table;
 }
 
+const std::array<Emulator::OpcodeInfo, 256> Emulator::OPCODE_TABLE = Emulator::buildOpcodeTable();
+
 // --- Opcode Implementations ---
 
 // Data Transfer Group
 // 0x01: LXI B,d16
-void Emulator::op_LXI_B()
+void Emulator::op_LXI_B(uint8_t, uint16_t operand)
 { 
-    state.c = memory.ReadByte(state.pc + 1);
-    state.b = memory.ReadByte(state.pc + 2);
+    state.c = operand & 0xFF;
+    state.b = operand >> 8;
 }
 // 0x02: STAX B
-void Emulator::op_STAX_B()
+void Emulator::op_STAX_B(uint8_t, uint16_t)
 {
     uint16_t addr = (state.b << 8) | state.c;
     memory.WriteByte(addr, state.a);
 }
 // 0x06: MVI B,d8
-void Emulator::op_MVI_B()
+void Emulator::op_MVI_B(uint8_t, uint16_t operand)
 {
-    state.b = memory.ReadByte(state.pc + 1);
+    state.b = operand & 0xFF;
 }
 // 0x0A: LDAX B
-void Emulator::op_LDAX_B()
+void Emulator::op_LDAX_B(uint8_t, uint16_t)
 {
     uint16_t addr = (state.b << 8) | state.c;
     state.a = memory.ReadByte(addr);
 }
 // 0x0E: MVI C,d8
-void Emulator::op_MVI_C()
+void Emulator::op_MVI_C(uint8_t, uint16_t operand)
 {
-    state.c = memory.ReadByte(state.pc + 1);
+    state.c = operand & 0xFF;
 }
 // 0x11: LXI D,d16
-void Emulator::op_LXI_D()
+void Emulator::op_LXI_D(uint8_t, uint16_t operand)
 {
-    state.e = memory.ReadByte(state.pc + 1); 
-    state.d = memory.ReadByte(state.pc + 2); 
+    state.e = operand & 0xFF;
+    state.d = operand >> 8;
 }
 // 0x12: STAX D
-void Emulator::op_STAX_D()
+void Emulator::op_STAX_D(uint8_t, uint16_t)
 {
     uint16_t addr = (state.d << 8) | state.e;
     memory.WriteByte(addr, state.a); 
 }
 // 0x16: MVI D,d8
-void Emulator::op_MVI_D()
+void Emulator::op_MVI_D(uint8_t, uint16_t operand)
 {
-    state.d = memory.ReadByte(state.pc + 1);
+    state.d = operand & 0xFF;
 }
 // 0x1A: LDAX D
-void Emulator::op_LDAX_D()
+void Emulator::op_LDAX_D(uint8_t, uint16_t)
 {
     uint16_t addr = (state.d << 8) | state.e;
     state.a = memory.ReadByte(addr); 
 }
 // 0x1E: MVI E,d8
-void Emulator::op_MVI_E()
+void Emulator::op_MVI_E(uint8_t, uint16_t operand)
 {
-    state.e = memory.ReadByte(state.pc + 1);
+    state.e = operand & 0xFF;
 }
 // 0x21: LXI H,d16
-void Emulator::op_LXI_H()
+void Emulator::op_LXI_H(uint8_t, uint16_t operand)
 {
-    state.l = memory.ReadByte(state.pc + 1); 
-    state.h = memory.ReadByte(state.pc + 2);
+    state.l = operand & 0xFF;
+    state.h = operand >> 8;
 }
 // 0x22: SHLD addr
-void Emulator::op_SHLD()
+void Emulator::op_SHLD(uint8_t, uint16_t operand)
 {
-    uint16_t addr = (memory.ReadByte(state.pc + 2) << 8) | memory.ReadByte(state.pc + 1); 
-    memory.WriteByte(addr, state.l);           
-    memory.WriteByte(addr + 1, state.h);
+    memory.WriteWord(operand, (state.h << 8) | state.l);
 }
 // 0x26: MVI H,d8
-void Emulator::op_MVI_H()
+void Emulator::op_MVI_H(uint8_t, uint16_t operand)
 {
-    state.h = memory.ReadByte(state.pc + 1);
+    state.h = operand & 0xFF;
 }
 // 0x2A: LHLD addr
-void Emulator::op_LHLD()
+void Emulator::op_LHLD(uint8_t, uint16_t operand)
 {
-    uint16_t addr = (memory.ReadByte(state.pc + 2) << 8) | memory.ReadByte(state.pc + 1); 
-    state.l = memory.ReadByte(addr);              
-    state.h = memory.ReadByte(addr + 1); 
+    uint16_t value = memory.ReadWord(operand);
+    state.l = value & 0xFF;
+    state.h = value >> 8;
 }
 // 0x2E: MVI L,d8
-void Emulator::op_MVI_L()
+void Emulator::op_MVI_L(uint8_t, uint16_t operand)
 {
-    state.l = memory.ReadByte(state.pc + 1);
+    state.l = operand & 0xFF;
 }
 // 0x31: LXI SP,d16
-void Emulator::op_LXI_SP()
+void Emulator::op_LXI_SP(uint8_t, uint16_t operand)
 {
-    state.sp = (memory.ReadByte(state.pc + 2) << 8) | memory.ReadByte(state.pc + 1);
+    state.sp = operand;
 }
 // 0x32: STA addr
-void Emulator::op_STA()
+void Emulator::op_STA(uint8_t, uint16_t operand)
 {
-    uint16_t addr = (memory.ReadByte(state.pc + 2) << 8) | memory.ReadByte(state.pc + 1); 
+    uint16_t addr = operand;
     memory.WriteByte(addr, state.a);
 }
 // 0x36: MVI M,d8
-void Emulator::op_MVI_M()
+void Emulator::op_MVI_M(uint8_t, uint16_t operand)
 {
     uint16_t addr = (state.h << 8) | state.l;
-    memory.WriteByte(addr, memory.ReadByte(state.pc + 1)); 
+    memory.WriteByte(addr, operand & 0xFF);
 }
 // 0x3A: LDA addr
-void Emulator::op_LDA()
+void Emulator::op_LDA(uint8_t, uint16_t operand)
 {
-    uint16_t addr = (memory.ReadByte(state.pc + 2) << 8) | memory.ReadByte(state.pc + 1); 
+    uint16_t addr = operand;
     state.a = memory.ReadByte(addr); 
 }
 // 0x3E: MVI A,d8
-void Emulator::op_MVI_A()
+void Emulator::op_MVI_A(uint8_t, uint16_t operand)
 {
-    state.a = memory.ReadByte(state.pc + 1);
+    state.a = operand & 0xFF;
 }
 // 0xEB: XCHG
-void Emulator::op_XCHG()
+void Emulator::op_XCHG(uint8_t, uint16_t)
 {
     std::swap(state.h, state.d);
     std::swap(state.l, state.e);
@@ -395,7 +530,7 @@ void Emulator::op_XCHG()
 
 // Arithmetic Group
 // 0x03: INX B
-void Emulator::op_INX_B()
+void Emulator::op_INX_B(uint8_t, uint16_t)
 {
     uint16_t bc = (state.b << 8) | state.c;
     bc++;
@@ -403,38 +538,24 @@ void Emulator::op_INX_B()
     state.c = bc & 0xFF;
 }
 // 0x04: INR B
-void Emulator::op_INR_B()
+void Emulator::op_INR_B(uint8_t, uint16_t)
 {
-    uint8_t result = state.b + 1;
-    state.flags.z = (result == 0);
-    state.flags.s = ((result & 0x80) != 0);
-    state.flags.p = __builtin_parity(result);
-    state.flags.ac = ((state.b & 0x0F) + 1) > 0x0F;
-    state.b = result;
+    state.b = alu_inr(lazy_flags, state.b);
 }
 // 0x05: DCR B
-void Emulator::op_DCR_B()
+void Emulator::op_DCR_B(uint8_t, uint16_t)
 {
-    uint8_t result = state.b - 1;
-    state.flags.z = (result == 0);
-    state.flags.s = ((result & 0x80) != 0);
-    state.flags.p = __builtin_parity(result);
-    state.flags.ac = ((state.b & 0x0F) != 0x00);
-    state.b = result;
+    state.b = alu_dcr(lazy_flags, state.b);
 }
 // 0x09: DAD B
-void Emulator::op_DAD_B()
+void Emulator::op_DAD_B(uint8_t, uint16_t)
 {
-    uint16_t hl = (state.h << 8) | state.l;
-    uint16_t bc = (state.b << 8) | state.c;
-    uint32_t result = hl + bc;
-    state.flags.cy = (result > 0xFFFF);
-    hl = result & 0xFFFF;
-    state.h = (hl >> 8) & 0xFF;
-    state.l = hl & 0xFF;
+    uint16_t result = alu_dad(state.flags, hl(), (state.b << 8) | state.c);
+    state.h = (result >> 8) & 0xFF;
+    state.l = result & 0xFF;
 }
 // 0x0B: DCX B
-void Emulator::op_DCX_B()
+void Emulator::op_DCX_B(uint8_t, uint16_t)
 {
     uint16_t bc = (state.b << 8) | state.c;
     bc--;
@@ -442,27 +563,17 @@ void Emulator::op_DCX_B()
     state.c = bc & 0xFF;
 }
 // 0x0C: INR C
-void Emulator::op_INR_C()
+void Emulator::op_INR_C(uint8_t, uint16_t)
 {
-    uint8_t result = state.c + 1;
-    state.flags.z = (result == 0);
-    state.flags.s = ((result & 0x80) != 0);
-    state.flags.p = __builtin_parity(result);
-    state.flags.ac = ((state.c & 0x0F) + 1) > 0x0F;
-    state.c = result;
+    state.c = alu_inr(lazy_flags, state.c);
 }
 // 0x0D: DCR C
-void Emulator::op_DCR_C()
+void Emulator::op_DCR_C(uint8_t, uint16_t)
 {
-    uint8_t result = state.c - 1;
-    state.flags.z = (result == 0);
-    state.flags.s = ((result & 0x80) != 0);
-    state.flags.p = __builtin_parity(result);
-    state.flags.ac = ((state.c & 0x0F) != 0x00);
-    state.c = result;
+    state.c = alu_dcr(lazy_flags, state.c);
 }
 // 0x13: INX D
-void Emulator::op_INX_D()
+void Emulator::op_INX_D(uint8_t, uint16_t)
 {
     uint16_t de = (state.d << 8) | state.e;
     de++;
@@ -470,38 +581,24 @@ void Emulator::op_INX_D()
     state.e = de & 0xFF;
 }
 // 0x14: INR D
-void Emulator::op_INR_D()
+void Emulator::op_INR_D(uint8_t, uint16_t)
 {
-    uint8_t result = state.d + 1;
-    state.flags.z = (result == 0);
-    state.flags.s = ((result & 0x80) != 0);
-    state.flags.p = __builtin_parity(result);
-    state.flags.ac = ((state.d & 0x0F) + 1) > 0x0F;
-    state.d = result;
+    state.d = alu_inr(lazy_flags, state.d);
 }
 // 0x15: DCR D
-void Emulator::op_DCR_D()
+void Emulator::op_DCR_D(uint8_t, uint16_t)
 {
-    uint8_t result = state.d - 1;
-    state.flags.z = (result == 0);
-    state.flags.s = ((result & 0x80) != 0);
-    state.flags.p = __builtin_parity(result);
-    state.flags.ac = ((state.d & 0x0F) != 0x00);
-    state.d = result;
+    state.d = alu_dcr(lazy_flags, state.d);
 }
 // 0x19: DAD D
-void Emulator::op_DAD_D()
+void Emulator::op_DAD_D(uint8_t, uint16_t)
 {
-    uint16_t hl = (state.h << 8) | state.l;
-    uint16_t de = (state.d << 8) | state.e;
-    uint32_t result = hl + de;
-    state.flags.cy = (result > 0xFFFF);
-    hl = result & 0xFFFF;
-    state.h = (hl >> 8) & 0xFF;
-    state.l = hl & 0xFF;
+    uint16_t result = alu_dad(state.flags, hl(), (state.d << 8) | state.e);
+    state.h = (result >> 8) & 0xFF;
+    state.l = result & 0xFF;
 }
 // 0x1B: DCX D
-void Emulator::op_DCX_D()
+void Emulator::op_DCX_D(uint8_t, uint16_t)
 {
     uint16_t de = (state.d << 8) | state.e;
     de--;
@@ -509,27 +606,17 @@ void Emulator::op_DCX_D()
     state.e = de & 0xFF;
 }
 // 0x1C: INR E
-void Emulator::op_INR_E()
+void Emulator::op_INR_E(uint8_t, uint16_t)
 {
-    uint8_t result = state.e + 1;
-    state.flags.z = (result == 0);
-    state.flags.s = ((result & 0x80) != 0);
-    state.flags.p = __builtin_parity(result);
-    state.flags.ac = ((state.e & 0x0F) + 1) > 0x0F;
-    state.e = result;
+    state.e = alu_inr(lazy_flags, state.e);
 }
 // 0x1D: DCR E
-void Emulator::op_DCR_E()
+void Emulator::op_DCR_E(uint8_t, uint16_t)
 {
-    uint8_t result = state.e - 1;
-    state.flags.z = (result == 0);
-    state.flags.s = ((result & 0x80) != 0);
-    state.flags.p = __builtin_parity(result);
-    state.flags.ac = ((state.e & 0x0F) != 0x00);
-    state.e = result;
+    state.e = alu_dcr(lazy_flags, state.e);
 }
 // 0x23: INX H
-void Emulator::op_INX_H()
+void Emulator::op_INX_H(uint8_t, uint16_t)
 {
     uint16_t hl = (state.h << 8) | state.l;
     hl++;
@@ -537,62 +624,29 @@ void Emulator::op_INX_H()
     state.l = hl & 0xFF;
 }
 // 0x24: INR H
-void Emulator::op_INR_H()
+void Emulator::op_INR_H(uint8_t, uint16_t)
 {
-    uint8_t result = state.h + 1;
-    state.flags.z = (result == 0);
-    state.flags.s = ((result & 0x80) != 0);
-    state.flags.p = __builtin_parity(result);
-    state.flags.ac = ((state.h & 0x0F) + 1) > 0x0F;
-    state.h = result;
+    state.h = alu_inr(lazy_flags, state.h);
 }
 // 0x25: DCR H
-void Emulator::op_DCR_H()
+void Emulator::op_DCR_H(uint8_t, uint16_t)
 {
-    uint8_t result = state.h - 1;
-    state.flags.z = (result == 0);
-    state.flags.s = ((result & 0x80) != 0);
-    state.flags.p = __builtin_parity(result);
-    state.flags.ac = ((state.h & 0x0F) != 0x00);
-    state.h = result;
+    state.h = alu_dcr(lazy_flags, state.h);
 }
 // 0x27: DAA
-void Emulator::op_DAA()
+void Emulator::op_DAA(uint8_t, uint16_t)
 {
-    uint8_t lsb = state.a & 0x0F;
-    uint8_t msb = state.a >> 4;
-    uint8_t correction = 0;
-
-    if (state.flags.ac || lsb > 9)
-    {
-        correction += 0x06;
-    }
-
-    if (state.flags.cy || msb > 9 || (msb >= 9 && lsb > 9))
-    {
-        correction += 0x60;
-        state.flags.cy = true;
-    }
-
-    uint16_t result = state.a + correction;
-    state.a = result & 0xFF;
-    state.flags.z = (state.a == 0);
-    state.flags.s = ((state.a & 0x80) != 0);
-    state.flags.p = __builtin_parity(state.a);
-    state.flags.ac = ((state.a & 0x0F) < (lsb & 0x0F));
+    alu_daa(state.a, state.flags, lazy_flags);
 }
 // 0x29: DAD H
-void Emulator::op_DAD_H()
+void Emulator::op_DAD_H(uint8_t, uint16_t)
 {
-    uint16_t hl = (state.h << 8) | state.l;
-    uint32_t result = hl + hl;
-    state.flags.cy = (result > 0xFFFF);
-    hl = result & 0xFFFF;
-    state.h = (hl >> 8) & 0xFF;
-    state.l = hl & 0xFF;
+    uint16_t result = alu_dad(state.flags, hl(), hl());
+    state.h = (result >> 8) & 0xFF;
+    state.l = result & 0xFF;
 }
 // 0x2B: DCX H
-void Emulator::op_DCX_H()
+void Emulator::op_DCX_H(uint8_t, uint16_t)
 {
     uint16_t hl = (state.h << 8) | state.l;
     hl--;
@@ -600,78 +654,43 @@ void Emulator::op_DCX_H()
     state.l = hl & 0xFF;
 }
 // 0x2C: INR L
-void Emulator::op_INR_L()
+void Emulator::op_INR_L(uint8_t, uint16_t)
 {
-    uint8_t result = state.l + 1;
-    state.flags.z = (result == 0);
-    state.flags.s = ((result & 0x80) != 0);
-    state.flags.p = __builtin_parity(result);
-    state.flags.ac = ((state.l & 0x0F) + 1) > 0x0F;
-    state.l = result;
+    state.l = alu_inr(lazy_flags, state.l);
 }
 // 0x2D: DCR L
-void Emulator::op_DCR_L()
+void Emulator::op_DCR_L(uint8_t, uint16_t)
 {
-    uint8_t result = state.l - 1;
-    state.flags.z = (result == 0);
-    state.flags.s = ((result & 0x80) != 0);
-    state.flags.p = __builtin_parity(result);
-    state.flags.ac = ((state.l & 0x0F) != 0x00);
-    state.l = result;
+    state.l = alu_dcr(lazy_flags, state.l);
 }
 // 0x34: INR M
-void Emulator::op_INR_M()
+void Emulator::op_INR_M(uint8_t, uint16_t)
 {
     uint16_t addr = (state.h << 8) | state.l;
-    uint8_t original = memory.ReadByte(addr); 
-    uint8_t result = original + 1;
-    state.flags.z = (result == 0);
-    state.flags.s = ((result & 0x80) != 0);
-    state.flags.p = __builtin_parity(result);
-    state.flags.ac = ((original & 0x0F) + 1) > 0x0F;
-    memory.WriteByte(addr, result); 
+    memory.WriteByte(addr, alu_inr(lazy_flags, memory.ReadByte(addr)));
 }
 // 0x35: DCR M
-void Emulator::op_DCR_M()
+void Emulator::op_DCR_M(uint8_t, uint16_t)
 {
     uint16_t addr = (state.h << 8) | state.l;
-    uint8_t original = memory.ReadByte(addr);
-    uint8_t result = original - 1;
-    state.flags.z = (result == 0);
-    state.flags.s = ((result & 0x80) != 0);
-    state.flags.p = __builtin_parity(result);
-    state.flags.ac = ((original & 0x0F) != 0x00);
-    memory.WriteByte (addr, result);
+    memory.WriteByte(addr, alu_dcr(lazy_flags, memory.ReadByte(addr)));
 }
 // 0x39: DAD SP
-void Emulator::op_DAD_SP()
+void Emulator::op_DAD_SP(uint8_t, uint16_t)
 {
-    uint16_t hl = (state.h << 8) | state.l;
-    uint32_t result = hl + state.sp;
-    state.flags.cy = (result > 0xFFFF);
-    hl = result & 0xFFFF;
-    state.h = (hl >> 8) & 0xFF;
-    state.l = hl & 0xFF;
+    uint16_t result = alu_dad(state.flags, hl(), state.sp);
+    state.h = (result >> 8) & 0xFF;
+    state.l = result & 0xFF;
 }
 // 0x3C: INR A
-void Emulator::op_INR_A()
+void Emulator::op_INR_A(uint8_t, uint16_t)
 {
-    uint8_t result = state.a + 1;
-    state.flags.z = (result == 0);
-    state.flags.s = ((result & 0x80) != 0);
-    state.flags.p = __builtin_parity(result);
-    state.flags.ac = ((state.a & 0x0F) + 1) > 0x0F;
-    state.a = result;
+    state.a = alu_inr(lazy_flags, state.a);
 }
 // 0x3D: DCR A
-void Emulator::op_DCR_A()
+void Emulator::op_DCR_A(uint8_t, uint16_t)
 {
-    uint8_t result = state.a - 1;
-    state.flags.z = (result == 0);
-    state.flags.s = ((result & 0x80) != 0);
-    state.flags.p = __builtin_parity(result);
-    state.flags.ac = ((state.a & 0x0F) != 0x00);
-    state.a = result;
+    state.a = alu_dcr(lazy_flags, state.a);
 }
 
 // =========================== Opcode: ADI d8 ================================
@@ -681,16 +700,9 @@ void Emulator::op_DCR_A()
 // Adds the immediate 8-bit value (d8) to the accumulator A.
 // A <- A + d8
 // Affects all flags: Z, S, P, CY, AC
-void Emulator::op_ADI(uint8_t val)
+void Emulator::op_ADI(uint8_t, uint16_t operand)
 {
-    uint8_t originalA = state.a;
-    uint16_t result = static_cast<uint16_t>(state.a) + val;
-
-    state.flags.cy = result > 0xFF;
-    state.flags.ac = ((originalA & 0x0F) + (val & 0x0F)) > 0x0F;
-
-    state.a = static_cast<uint8_t>(result);
-    setFlags(state.a);
+    alu_add(state.a, state.flags, lazy_flags, operand & 0xFF, 0);
 }
 // =========================== Opcode: SUI d8 ================================
 // Opcode      : 0xD6
@@ -699,15 +711,8 @@ void Emulator::op_ADI(uint8_t val)
 // Subtract immediate 8-bit value from A.
 // A <- A - d8
 // Affects all flags: Z, S, P, CY, AC
-void Emulator::op_SUI(uint8_t val) {
-    uint8_t originalA = state.a;
-    uint16_t result = static_cast<uint16_t>(state.a) - val;
-
-    state.flags.cy = (val > originalA);
-    state.flags.ac = ((originalA & 0x0F) < (val & 0x0F));
-
-    state.a = static_cast<uint8_t>(result);
-    setFlags(state.a);
+void Emulator::op_SUI(uint8_t, uint16_t operand) {
+    alu_sub(state.a, state.flags, lazy_flags, operand & 0xFF, 0);
 }
 
 // =========================== Opcode: SBI d8 ================================
@@ -717,16 +722,8 @@ void Emulator::op_SUI(uint8_t val) {
 // Subtract immediate 8-bit value and borrow (CY) from A.
 // A <- A - d8 - CY
 // Affects all flags: Z, S, P, CY, AC
-void Emulator::op_SBI(uint8_t val) {
-    uint8_t originalA = state.a;
-    uint8_t borrow = state.flags.cy ? 1 : 0;
-    uint16_t result = static_cast<uint16_t>(state.a) - val - borrow;
-
-    state.flags.cy = (val + borrow > originalA);
-    state.flags.ac = ((originalA & 0x0F) < ((val & 0x0F) + borrow));
-
-    state.a = static_cast<uint8_t>(result);
-    setFlags(state.a);
+void Emulator::op_SBI(uint8_t, uint16_t operand) {
+    alu_sub(state.a, state.flags, lazy_flags, operand & 0xFF, state.flags.cy);
 }
 
 // =========================== Opcode: ACI d8 ================================
@@ -736,18 +733,8 @@ void Emulator::op_SBI(uint8_t val) {
 // Adds immediate 8-bit value and Carry flag to accumulator A.
 // A <- A + d8 + CY
 // Affects all flags: Z, S, P, CY, AC
-void Emulator::op_ACI(uint8_t val) {
-    uint8_t originalA = state.a;
-    uint8_t carryIn = state.flags.cy ? 1 : 0;
-
-    uint16_t result = static_cast<uint16_t>(state.a) + val + carryIn;
-
-    // Calculate AC before modifying flags
-    state.flags.ac = ((originalA & 0x0F) + (val & 0x0F) + carryIn) > 0x0F;
-    state.flags.cy = result > 0xFF;
-
-    state.a = static_cast<uint8_t>(result);
-    setFlags(state.a);
+void Emulator::op_ACI(uint8_t, uint16_t operand) {
+    alu_add(state.a, state.flags, lazy_flags, operand & 0xFF, state.flags.cy);
 }
 
 
@@ -755,98 +742,52 @@ void Emulator::op_ACI(uint8_t val) {
 // 80 to 87: ADD
 void Emulator::op_ADD(uint8_t val)
 {
-    // Pointers to register A and to flags CY and AC
-    uint8_t *a = &state.a;  // Register A
-    bool *cy = &state.flags.cy;  // Carry flag
-    bool *ac = &state.flags.ac;  // Auxiliary carry flag
-
-    uint16_t result = *a + val;
-    *cy = result > 0xFF;
-    *ac = ((*a & 0x0F) + (val & 0x0F) + (*cy ? 1 : 0)) > 0x0F;
-    *a = result & 0xFF;  // Ensures that new value fits within 8-bits
-
-    setFlags(*a);
+    alu_add(state.a, state.flags, lazy_flags, val, 0);
 }
 
 // 88 to 8F: ADC
 void Emulator::op_ADC(uint8_t val)
 {
-    // Pointers to register A and to flags CY and AC
-    uint8_t *a = &state.a;  // Register A
-    bool *cy = &state.flags.cy;  // Carry flag
-    bool *ac = &state.flags.ac;  // Auxiliary flag
-
-    uint16_t result = *a + val + (*cy ? 1 : 0);
-    *cy = result > 0xFF;
-    *ac = ((*a & 0x0F) + (val & 0x0F) + (*cy ? 1 : 0)) > 0x0F;
-    *a = result & 0xFF;  // Ensures that new value fits within 8-bits
-
-    setFlags(*a);
+    alu_add(state.a, state.flags, lazy_flags, val, state.flags.cy);
 }
 // 90 to 97 SUB
 void Emulator::op_SUB(uint8_t val) 
 {
-    // Pointers to register A and to flags CY and AC
-    uint8_t *a = &state.a;  // Register A
-    bool *cy = &state.flags.cy;  // Carry flag
-    bool *ac = &state.flags.ac;  // Auxiliary carry flag
-
-    uint16_t result = *a - val;
-    *cy = (*a < val);
-    *ac = ((*a & 0x0F) < (val & 0x0F));
-    *a = result & 0xFF;  // Ensures that new value fits within 8-bits
-
-    setFlags(*a);
+    alu_sub(state.a, state.flags, lazy_flags, val, 0);
 }
 // 98 to 9F SBB
 void Emulator::op_SBB(uint8_t val)
 {
-    // Pointers to register A and to flags CY and AC
-    uint8_t *a = &state.a;  // Register A
-    bool *cy = &state.flags.cy;  // Carry flag
-    bool *ac = &state.flags.ac;  // Auxiliary carry flag
-
-    uint16_t borrow = *cy ? 1 : 0;  // Sets the borrow value based on status of the carry flag
-    uint16_t result = *a - val - borrow;
-
-    *cy = (*a < (val + borrow));
-    *ac = ((*a & 0x0F) < ((val & 0x0F) + borrow));
-
-    *a = result & 0xFF;  // Ensures that new value fits within 8-bits
-    setFlags(*a);
+    alu_sub(state.a, state.flags, lazy_flags, val, state.flags.cy);
 }
 // Logical Group
 // 0x07: RLC
-void Emulator::op_RLC()
+void Emulator::op_RLC(uint8_t, uint16_t)
 {
-    state.flags.cy = (state.a & 0x80) != 0;
-    state.a = (state.a << 1) | (state.a >> 7);
+    alu_rlc(state.a, state.flags);
 }
 // 0x0F: RRC
-void Emulator::op_RRC()
+void Emulator::op_RRC(uint8_t, uint16_t)
 {
-    state.flags.cy = (state.a & 0x01) != 0;
-    state.a = (state.a >> 1) | (state.a << 7);
+    alu_rrc(state.a, state.flags);
 }
 // 0x1F: RAR
-void Emulator::op_RAR()
+void Emulator::op_RAR(uint8_t, uint16_t)
 {
-    bool old_cy = state.flags.cy;
-    state.flags.cy = (state.a & 0x01) != 0;
-    state.a = (state.a >> 1) | (old_cy ? 0x80 : 0x00);
+    alu_rar(state.a, state.flags);
 }
 // 0x2F: CMA
-void Emulator::op_CMA()
+void Emulator::op_CMA(uint8_t, uint16_t)
 {
     state.a = ~state.a;
 }
 // 0x37: STC
-void Emulator::op_STC()
+void Emulator::op_STC(uint8_t, uint16_t)
 {
     state.flags.cy = true;
 }
 // 0x3F: CMC
-void Emulator::op_CMC()
+void Emulator::op_CMC(uint8_t, uint16_t)
 {
     state.flags.cy = !state.flags.cy;
 }
@@ -867,148 +808,143 @@ void Emulator::op_CMC()
 // - No effect on PC other than in the calling opcode handler.
 void Emulator::op_ANA(uint8_t val)
 {
-    state.flags.ac = ((state.a | val) & 0x08) != 0;  
-    state.a = state.a & val;
-    state.flags.cy = 0;
-    setFlags(state.a);
+    alu_ana(state.a, state.flags, lazy_flags, val);
 }
 // A8 to AF XRA
 void Emulator::op_XRA(uint8_t val)
 {
-    state.a = state.a ^ val;  // XOR operation
-    state.flags.cy = 0;
-    state.flags.ac = 0;
-    setFlags(state.a);
+    alu_xra(state.a, state.flags, lazy_flags, val);
 }
 // B0 to B7 ORA
 void Emulator::op_ORA(uint8_t val)
 {
-    state.a = state.a | val;  // OR operation
-    state.flags.cy = 0;
-    state.flags.ac = 0;
-    setFlags(state.a);
+    alu_ora(state.a, state.flags, lazy_flags, val);
 }
 // B8 to B12 CMP
 void Emulator::op_CMP(uint8_t val)
 {
-    uint8_t *a = &state.a;
-    bool *cy = &state.flags.cy;
-    bool *ac = &state.flags.ac;
-
-    uint16_t result = *a - val;
-    *cy = (*a < val);
-    *ac = ((*a & 0x0F) < (val & 0x0F));
-    setFlags(result);
+    alu_cmp(state.a, state.flags, lazy_flags, val);
+}
+// 80 to BF: ALU A,r. One instantiation per operation and source register.
+template <Emulator::AluOp Op, Emulator::RegisterCode Src>
+void Emulator::op_ALU(uint8_t, uint16_t)
+{
+    uint8_t val = get_reg<Src>();
+    if constexpr (Op == AluOp::ADD) { op_ADD(val); }
+    else if constexpr (Op == AluOp::ADC) { op_ADC(val); }
+    else if constexpr (Op == AluOp::SUB) { op_SUB(val); }
+    else if constexpr (Op == AluOp::SBB) { op_SBB(val); }
+    else if constexpr (Op == AluOp::ANA) { op_ANA(val); }
+    else if constexpr (Op == AluOp::XRA) { op_XRA(val); }
+    else if constexpr (Op == AluOp::ORA) { op_ORA(val); }
+    else { op_CMP(val); }
 }
+// E6, EE, F6, FE: ANI/XRI/ORI/CPI d8
+void Emulator::op_ANI(uint8_t, uint16_t operand) { op_ANA(operand & 0xFF); }
+void Emulator::op_XRI(uint8_t, uint16_t operand) { op_XRA(operand & 0xFF); }
+void Emulator::op_ORI(uint8_t, uint16_t operand) { op_ORA(operand & 0xFF); }
+void Emulator::op_CPI(uint8_t, uint16_t operand) { op_CMP(operand & 0xFF); }
 
 // Branch Group
 // 0xC3: JMP addr
-void Emulator::op_JMP()
+void Emulator::op_JMP(uint8_t, uint16_t operand)
 {
-    // The 16-bit address is at PC+1 and PC+2
-    uint8_t low_byte = memory.ReadByte(state.pc + 1);
-    uint8_t high_byte = memory.ReadByte(state.pc + 2);
-    state.pc = (high_byte << 8) | low_byte;
+    state.pc = operand;
 }
 // 0xC9: RET
-void Emulator::op_RET()
+void Emulator::op_RET(uint8_t, uint16_t)
 {
-    state.pc = (memory.ReadByte(state.sp + 1) << 8) | memory.ReadByte(state.sp);
+    state.pc = memory.ReadWord(state.sp);
     state.sp += 2;
 }
 // 0xCD: CALL addr
-void Emulator::op_CALL()
+void Emulator::op_CALL(uint8_t, uint16_t operand)
 {
-    uint16_t ret_addr = state.pc + 3;
-    memory.WriteByte(state.sp - 1, (ret_addr >> 8) & 0xFF);
-    memory.WriteByte(state.sp - 2, ret_addr & 0xFF); 
+    // PC already points past the CALL, which is the return address.
     state.sp -= 2;
-    state.pc = (memory.ReadByte(state.pc + 2) << 8) | memory.ReadByte(state.pc + 1);
+    memory.WriteWord(state.sp, state.pc);
+    state.pc = operand;
 }
 // 0xE9: PCHL
-void Emulator::op_PCHL()
+void Emulator::op_PCHL(uint8_t, uint16_t)
 {
     state.pc = (state.h << 8) | state.l;
 }
 // Handles return conditionals
-void Emulator::op_RET_cond(bool condition)
+void Emulator::op_RET_cond(uint8_t opcode, uint16_t operand)
 {
-    if (condition)
-    {
-        op_RET();
-    }
-    else
+    if (condition(opcode))
     {
-        state.pc += 1;
+        op_RET(opcode, operand);
     }
 }
 // Handles jump conditionals
-void Emulator::op_JMP_cond(bool condition)
+void Emulator::op_JMP_cond(uint8_t opcode, uint16_t operand)
 {
-     uint16_t addr = (memory.ReadByte(state.pc + 2) << 8) | memory.ReadByte(state.pc + 1);
-    if (condition)
-        state.pc = addr;
-    else
-        state.pc += 3;
+    if (condition(opcode))
+    {
+        state.pc = operand;
+    }
 }
 // Handles call conditionals
-void Emulator::op_CALL_cond(bool condition)
+void Emulator::op_CALL_cond(uint8_t opcode, uint16_t operand)
 {
-    if (condition)
+    if (condition(opcode))
     {
-        uint16_t ret_addr = state.pc + 3;
-        memory.WriteByte(state.sp - 1, (ret_addr >> 8) & 0xFF);
-        memory.WriteByte(state.sp - 2, ret_addr & 0xFF);
-        state.sp -= 2;
-        state.pc = (memory.ReadByte(state.pc + 2) << 8) | memory.ReadByte(state.pc + 1);
-    }
-    else
-    {
-        state.pc += 3;
+        op_CALL(opcode, operand);
     }
 }
 
 // Stack, I/O, and Machine Control Group
 // 0x00: NOP
-void Emulator::op_NOP() { }
+void Emulator::op_NOP(uint8_t, uint16_t) { }
 // 0x76: HLT
-void Emulator::op_HLT()
+void Emulator::op_HLT(uint8_t, uint16_t)
+{
+    // PC already points past HLT, where an interrupt returns to.
+    // emulateCycles() idles the rest of every batch until then.
+    state.halted = true;
+}
+// 0x40 to 0x7F (except 0x76): MOV dst,src
+template <Emulator::RegisterCode Dst, Emulator::RegisterCode Src>
+void Emulator::op_MOV(uint8_t, uint16_t)
 {
-    // For this emulator, HLT is a NOP
+    set_reg<Dst>(get_reg<Src>());
 }
 // 0xC1: POP B
-void Emulator::op_POP_B()
+void Emulator::op_POP_B(uint8_t, uint16_t)
 {
-    state.c = memory.ReadByte(state.sp);       
-    state.b = memory.ReadByte(state.sp + 1); 
+    uint16_t value = memory.ReadWord(state.sp);
+    state.c = value & 0xFF;
+    state.b = value >> 8;
     state.sp += 2;
 }
 // 0xC5: PUSH B
-void Emulator::op_PUSH_B()
+void Emulator::op_PUSH_B(uint8_t, uint16_t)
 {
-    memory.WriteByte(state.sp - 1, state.b); 
-    memory.WriteByte(state.sp - 2, state.c); 
     state.sp -= 2;
+    memory.WriteWord(state.sp, (state.b << 8) | state.c);
 }
 // 0xD1: POP D
-void Emulator::op_POP_D()
+void Emulator::op_POP_D(uint8_t, uint16_t)
 {
-    state.e = memory.ReadByte(state.sp);         
-    state.d = memory.ReadByte(state.sp + 1);
+    uint16_t value = memory.ReadWord(state.sp);
+    state.e = value & 0xFF;
+    state.d = value >> 8;
     state.sp += 2;
 }
 // 0xD5: PUSH D
-void Emulator::op_PUSH_D()
+void Emulator::op_PUSH_D(uint8_t, uint16_t)
 {
-    memory.WriteByte(state.sp - 1, state.d);  
-    memory.WriteByte(state.sp - 2, state.e);  
     state.sp -= 2;
+    memory.WriteWord(state.sp, (state.d << 8) | state.e);
 }
 // 0xE1: POP H
-void Emulator::op_POP_H()
+void Emulator::op_POP_H(uint8_t, uint16_t)
 {
-    state.l = memory.ReadByte(state.sp);         
-    state.h = memory.ReadByte(state.sp + 1); 
+    uint16_t value = memory.ReadWord(state.sp);
+    state.l = value & 0xFF;
+    state.h = value >> 8;
     state.sp += 2;
 }
 
@@ -1020,18 +956,16 @@ void Emulator::op_POP_H()
 // the top of the stack (i.e., memory at address SP and SP+1).
 // L <-> [SP] | H <-> [SP+1]
 // This is a direct, in-place swap with no flags affected.
-void Emulator::op_XTHL() {
+void Emulator::op_XTHL(uint8_t, uint16_t) {
     // Save stack contents before overwriting
-    uint8_t temp_l = memory.ReadByte(state.sp);       
-    uint8_t temp_h = memory.ReadByte(state.sp + 1);   
+    uint16_t top = memory.ReadWord(state.sp);
 
     // Write HL into stack
-    memory.WriteByte(state.sp,     state.l);          
-    memory.WriteByte(state.sp + 1, state.h);
+    memory.WriteWord(state.sp, (state.h << 8) | state.l);
 
     // Load original stack contents into HL
-    state.l = temp_l;
-    state.h = temp_h;
+    state.l = top & 0xFF;
+    state.h = top >> 8;
 }
 
 
@@ -1043,53 +977,44 @@ void Emulator::op_XTHL() {
 // L is written to SP, H to SP+1. Program counter is advanced.
 //
 // Stack Effect: SP = SP - 2 || [SP]   = L || [SP+1] = H
-void Emulator::op_PUSH_H() {
+void Emulator::op_PUSH_H(uint8_t, uint16_t) {
     // Decrement SP before writing
     state.sp -= 2;
 
     // Write HL into stack (low at SP, high at SP+1)
-    memory.WriteByte(state.sp,     state.l);  
-    memory.WriteByte(state.sp + 1, state.h);
+    memory.WriteWord(state.sp, (state.h << 8) | state.l);
 }
 
 
 // 0xF1: POP PSW
-void Emulator::op_POP_PSW()
-{
-    uint8_t psw = memory.ReadByte(state.sp);
-    state.flags.cy = (psw & 0x01) != 0;
-    state.flags.p = (psw & 0x04) != 0;
-    state.flags.ac = (psw & 0x10) != 0;
-    state.flags.z = (psw & 0x40) != 0;
-    state.flags.s = (psw & 0x80) != 0;
-    state.a = memory.ReadByte(state.sp + 1); 
+void Emulator::op_POP_PSW(uint8_t, uint16_t)
+{
+    uint16_t value = memory.ReadWord(state.sp);
+    alu_unpack_psw(state.flags, lazy_flags, value & 0xFF);
+    state.a = value >> 8;
     state.sp += 2;
 }
 // 0xF5: PUSH PSW
-void Emulator::op_PUSH_PSW()
+void Emulator::op_PUSH_PSW(uint8_t, uint16_t)
 {
-    memory.WriteByte(state.sp - 1, state.a);            
-    uint8_t psw = (state.flags.s << 7) | (state.flags.z << 6) |
-                  (state.flags.ac << 4) | (state.flags.p << 2) |
-                  (state.flags.cy << 0) | 0x02;
-    memory.WriteByte(state.sp - 2, psw); 
     state.sp -= 2;
+    memory.WriteWord(state.sp, (state.a << 8) | alu_pack_psw(state.flags, lazy_flags));
 }
 // 0xFB: EI
-void Emulator::op_EI()
+void Emulator::op_EI(uint8_t, uint16_t)
 {
     state.interrupts_enabled = true;
 }
 // 0xDB: IN d8
-void Emulator::op_IN()
+void Emulator::op_IN(uint8_t, uint16_t operand)
 {
-    uint8_t port = memory.ReadByte(state.pc + 1);
+    uint8_t port = operand & 0xFF;
     state.a = io_read(static_cast<InPortNum>(port));
 }
 // 0xD3: OUT d8 
-void Emulator::op_OUT()
+void Emulator::op_OUT(uint8_t, uint16_t operand)
 {
-    uint8_t port = memory.ReadByte(state.pc + 1);
+    uint8_t port = operand & 0xFF;
     io_write(static_cast<OutPortNum>(port), state.a);
 }
 
@@ -1102,17 +1027,15 @@ void Emulator::op_OUT()
 // (7)0xFF = 0x38 
 // Mnemonic    : RST
 // Simulates a restart instruction by pushing the return address 
-// (PC + 1) onto the stack and jumping to a hardcoded address n * 8
+// (PC, already advanced past the RST) onto the stack and jumping to a hardcoded address n * 8
 // n - The restart number (0 to 7), corresponding to address 0x00 to 0x38
 // SP is decremented by 2, and the return address is stored on stack.
 // Return address is the instruction following the RST call
-void Emulator::op_RST(int n) {
-    uint16_t returnAddr = state.pc + 1;  
-    state.sp -= 1;
-    memory.WriteByte(state.sp, (returnAddr >> 8) & 0xFF);
-    state.sp -= 1;
-    memory.WriteByte(state.sp, returnAddr & 0xFF);
-    state.pc = n * 8;
+void Emulator::op_RST(uint8_t opcode, uint16_t) {
+    uint16_t returnAddr = state.pc;  
+    state.sp -= 2;
+    memory.WriteWord(state.sp, returnAddr);
+    state.pc = opcode & 0x38; // n * 8, n is encoded in bits 3-5.
 }
 
 // ====================== Opcode: SPHL (0xF9) ==========================
@@ -1123,7 +1046,7 @@ void Emulator::op_RST(int n) {
 // for stack operations or function calls.
 // 
 // SP <- HL
-void Emulator::op_SPHL() {
+void Emulator::op_SPHL(uint8_t, uint16_t) {
     state.sp = (static_cast<uint16_t>(state.h) << 8) | state.l;
 }
 
@@ -1136,16 +1059,15 @@ void Emulator::requestInterrupt(uint8_t interrupt_num)
     if (state.interrupts_enabled)
     {
         // Push PC onto stack
-        memory.WriteByte(state.sp - 1, (state.pc >> 8) & 0xFF); 
-        memory.WriteByte(state.sp - 2, state.pc & 0xFF);        
-
         state.sp -= 2;
+        memory.WriteWord(state.sp, state.pc);
 
         // Jump to interrupt service routine
         state.pc = 8 * interrupt_num;
 
         // Disable interrupts
         state.interrupts_enabled = false;
+        state.halted = false;
     }
 }
 
@@ -1167,29 +1089,106 @@ void Emulator::setInputState(GameInput input, bool isPressed)
     }
 }
 
+bool Emulator::setCpuBackend(CpuBackend newBackend)
+{
+    if (newBackend == CpuBackend::Threaded && !threadedBackendAvailable())
+    {
+        return false;
+    }
+    if (newBackend == CpuBackend::Jit && !jitInit())
+    {
+        return false;
+    }
+    if (newBackend == CpuBackend::Aot && AOT_ROM.block_count == 0)
+    {
+        return false;
+    }
+    backend = newBackend;
+    return true;
+}
+
+CpuBackend Emulator::getCpuBackend() const
+{
+    return backend;
+}
+
+void Emulator::setMemoryAccessPolicy(Memory::AccessPolicy policy)
+{
+    memory.SetAccessPolicy(policy);
+}
+
+void Emulator::setMemoryLayout(Memory::Layout layout)
+{
+    memory.SetLayout(layout);
+}
+
+void Emulator::logMemoryAccessCounts(const std::string& filename) const
+{
+    memory.LogAccessCounts(filename);
+}
+
 CPUState Emulator::getCPUState() const
 {
     return state;
 }
 
+void Emulator::saveState(EmulatorState& out) const
+{
+    out.cpu = state;
+    out.lazy_flags = lazy_flags;
+    out.cycle_count = cycle_count;
+    out.scheduler = scheduler; // Reuses the vector's capacity.
+    memory.SaveState(out.memory);
+}
+
+bool Emulator::loadState(const EmulatorState& in)
+{
+    if (!memory.LoadState(in.memory))
+    {
+        return false;
+    }
+
+    // Keys are host state: keep what is held now, not what was held then.
+    port1_t port_in_1 = state.port_in_1;
+    port2_t port_in_2 = state.port_in_2;
+    state = in.cpu;
+    state.port_in_1 = port_in_1;
+    state.port_in_2 = port_in_2;
+
+    lazy_flags = in.lazy_flags;
+    cycle_count = in.cycle_count;
+    scheduler = in.scheduler;
+    return true;
+}
+
 const uint8_t* Emulator::getFrameBuffer() const
 {
     // The framebuffer for Space Invaders starts at 0x2400
     return memory.GetVRAMPointer();
 }
 
-void Emulator::setFlags(uint8_t result)
+
+uint16_t Emulator::hl() const
 {
-    // Flags Z, S and P get set based on final result of operation
-    state.flags.z = (result == 0);
-    state.flags.s = (result & 0x80);
-    state.flags.p = !__builtin_parity(result);
+    return (state.h << 8) | state.l;
 }
 
+bool Emulator::condition(uint8_t opcode) const
+{
+    // Bits 4-5 select the flag (Z, CY, P, S), bit 3 selects
+    // whether the condition is the flag being set or clear.
+    // alu_test() also sees Z, P and S that are still pending.
+    static constexpr uint8_t COND_MASKS[4] = {FLAG_Z, FLAG_CY, FLAG_P, FLAG_S};
+    uint8_t cc = (opcode >> 3) & 0x07;
+    return alu_test(state.flags, lazy_flags, COND_MASKS[cc >> 1]) == static_cast<bool>(cc & 0x01);
+}
 
-uint16_t Emulator::hl() const
+void Emulator::op_UNIMPLEMENTED(uint8_t opcode, uint16_t)
 {
-    return (state.h << 8) | state.l;
+    std::cerr << "Error: Unimplemented opcode " 
+              << std::hex << static_cast<int>(opcode) 
+              << " at address " << std::hex << (state.pc - 1) 
+              << std::endl;
 }
 
 uint8_t Emulator::io_read(InPortNum port)
@@ -1234,33 +1233,28 @@ void Emulator::io_write(OutPortNum port, uint8_t val)
     }
 }
 
-uint8_t Emulator::get_reg(uint8_t code)
+template <Emulator::RegisterCode Code>
+uint8_t Emulator::get_reg()
 {
-    switch (code) 
+    if constexpr (Code == REG_M)
     {
-        case REG_B: return state.b;
-        case REG_C: return state.c;
-        case REG_D: return state.d;
-        case REG_E: return state.e;
-        case REG_H: return state.h;
-        case REG_L: return state.l;
-        case REG_M: return memory.ReadByte(hl());
-        case REG_A: return state.a;
-        default: return 0;
+        return memory.ReadByte(hl());
+    }
+    else
+    {
+        return state.*REGISTER_FIELDS[Code];
     }
 }
 
-void Emulator::set_reg(uint8_t code, uint8_t val)
+template <Emulator::RegisterCode Code>
+void Emulator::set_reg(uint8_t val)
 {
-    switch (code)
+    if constexpr (Code == REG_M)
     {
-        case REG_B: state.b = val; break;
-        case REG_C: state.c = val; break;
-        case REG_D: state.d = val; break;
-        case REG_E: state.e = val; break;
-        case REG_H: state.h = val; break;
-        case REG_L: state.l = val; break;
-        case REG_M: memory.WriteByte(hl(), val); break;
-        case REG_A: state.a = val; break;
+        memory.WriteByte(hl(), val);
     }
-}
\ No newline at end of file
+    else
+    {
+        state.*REGISTER_FIELDS[Code] = val;
+    }
+}
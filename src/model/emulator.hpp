@@ -13,9 +13,14 @@
 
 /***************** Include files. ***********************/
 #include "memory.hpp"
+#include "scheduler.hpp"
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include <string>
+#include <utility>
 
 /***************** Macros and defines. ***********************/
 // The size of the Space Invaders Video RAM in bytes. (256x224 pixels / 8 bits per byte)
@@ -80,6 +85,29 @@ typedef union
     uint8_t byte;
 } port2_t;
 
+/**
+ * @brief The 8080 flag register, stored in the PSW byte layout
+ *        pushed by PUSH PSW: S Z 0 AC 0 P 1 CY.
+ *        The bitfields keep single flags readable/writable for
+ *        debugging and tests, the CPU core works on the psw byte.
+ */
+typedef union
+{
+    struct
+    {
+        bool cy:1;                 // Carry.
+        uint8_t bit_1_reserved:1;  // Reserved, always 1 in a pushed PSW.
+        bool p:1;                  // Parity (set on even parity).
+        uint8_t bit_3_reserved:1;  // Reserved, always 0.
+        bool ac:1;                 // Auxiliary carry (carry out of bit 3).
+        uint8_t bit_5_reserved:1;  // Reserved, always 0.
+        bool z:1;                  // Zero.
+        bool s:1;                  // Sign.
+    };
+    uint8_t psw;
+} flags_t;
+static_assert(sizeof(flags_t) == 1, "flags_t must pack into the PSW byte");
+
 /**
  * @brief Input port enumeration.
  */
@@ -103,6 +131,20 @@ enum class OutPortNum : uint8_t
     WATCHDOG = 6,   // Watchdog controller (Unused by emulation).
 };
 
+/**
+ * @brief CPU execution backends, selectable at runtime.
+ */
+enum class CpuBackend
+{
+    Interpreter, // Opcode dispatch table (portable, default).
+    Threaded,    // Computed-goto threaded interpreter (GCC/Clang only).
+    BlockCache,  // Dispatch table over pre-decoded ROM basic blocks.
+    Jit,         // ROM blocks recompiled to x86-64 code (x86-64 Linux only).
+    Aot,         // ROM blocks recompiled to C++ at build time (rom_recompiler).
+};
+
+struct AotBlock;
+
 /**
  * @brief A plain data structure to hold a snapshot of the CPU's state for debugging.
  */
@@ -115,13 +157,11 @@ struct CPUState
     uint16_t sp; // Stack Pointer
     uint16_t pc; // Program Counter
 
-    // Condition flags
-    struct
-    {
-        bool z, s, p, cy, ac; // Zero, Sign, Parity, Carry, Aux Carry
-    } flags;
+    // Condition flags (packed PSW byte).
+    flags_t flags;
 
     bool interrupts_enabled;
+    bool halted = false; // Set by HLT, cleared by an accepted interrupt.
 
     // I/O ports for Space Invaders hardware
     // Port 0 is unused.
@@ -133,6 +173,50 @@ struct CPUState
     uint8_t shift_offset = 0;
 };
 
+/**
+ * @brief Flag results that have not been written to CPUState::flags yet.
+ *        ALU ops record their result and operands here instead of
+ *        computing Z, S, P and AC; readers resolve them on demand.
+ *        CY is cheap and read often, so it is always written directly.
+ */
+struct LazyFlags
+{
+    /**
+     * @brief How AC is derived from ac_lhs, ac_rhs and ac_carry.
+     */
+    enum class AcKind : uint8_t
+    {
+        None, // flags.ac is current.
+        Add,  // Carry out of bit 3 of lhs + rhs + carry.
+        Sub,  // Borrow into bit 3 of lhs - rhs - carry.
+        Dcr,  // DCR: set unless the low nibble of lhs was 0.
+    };
+
+    uint8_t result = 0;       // Result Z, S and P are derived from.
+    bool zsp_pending = false; // True while flags.z/s/p are stale.
+
+    AcKind ac_kind = AcKind::None;
+    uint8_t ac_lhs = 0;
+    uint8_t ac_rhs = 0;
+    uint8_t ac_carry = 0;
+};
+
+/**
+ * @brief In-memory snapshot of everything a frame can change: registers,
+ *        pending flags, the cycle clock with its scheduled interrupts,
+ *        and the RAM of the memory layout. Saving and loading copy into
+ *        existing storage, so a reused instance only allocates on its
+ *        first save.
+ */
+struct EmulatorState
+{
+    CPUState cpu = {};
+    LazyFlags lazy_flags;
+    uint64_t cycle_count = 0;
+    EventScheduler scheduler;
+    Memory::State memory;
+};
+
 /**
  * @brief The main class for the 8080 emulation model.
  */
@@ -177,6 +261,11 @@ public:
      */
     bool loadROM(const std::string& romFilePath);
 
+    /**
+     * @brief Time the last successful loadROM() took, in microseconds.
+     */
+    uint64_t getRomLoadTimeUs() const;
+
     /**
      * @brief Resets the emulator to its initial power-on state.
      */
@@ -184,9 +273,42 @@ public:
 
     /**
      * @brief Executes CPU instructions for a given number of clock cycles.
+     *        Instructions run while part of the budget is left, so the
+     *        last one can overshoot it; callers carry the overshoot
+     *        into their next budget. A budget of 1 runs one instruction.
      * @param cycles The number of 2MHz clock cycles to emulate.
+     *
+     * @returns The cycles actually executed (>= cycles unless PC ran
+     *          off the end of memory).
+     */
+    int emulateCycles(int cycles);
+
+    /**
+     * @brief Runs to the end of the current video frame: executes
+     *        straight to each scheduled event deadline, fires the
+     *        mid-screen (RST 1) and vblank (RST 2) interrupts at their
+     *        exact cycle positions and returns after vblank.
+     * @param frame If not null, receives a VRAM copy as the beam scans
+     *        it out: the top half at mid-screen, the bottom half at
+     *        vblank (FRAME_BUFFER_LEN bytes). Only the rows written
+     *        since the last copy are copied, so frame must keep the
+     *        previous contents; a different buffer gets a full copy.
+     *
+     * @returns The cycles executed.
+     */
+    int runUntilFrameEnd(uint8_t* frame = nullptr);
+
+    /**
+     * @brief Rows (32 bytes each, 224 in all) that runUntilFrameEnd()
+     *        changed in the frame buffer since the last call, then
+     *        clears them. None set means the frame is unchanged.
+     */
+    Memory::DirtyRows consumeDirtyRows();
+
+    /**
+     * @brief Total cycles emulated since reset().
      */
-    void emulateCycles(int cycles);
+    uint64_t getCycleCount() const;
 
     /**
      * @brief Requests a hardware interrupt (RST instruction).
@@ -201,6 +323,42 @@ public:
      */
     void setInputState(GameInput input, bool isPressed);
 
+    /**
+     * @brief Selects the CPU core used by emulateCycles().
+     * @param backend The backend to use.
+     *
+     * @returns false if the backend is not available on this
+     *          compiler, the current backend is kept in that case.
+     */
+    bool setCpuBackend(CpuBackend backend);
+
+    /**
+     * @brief Gets the CPU core used by emulateCycles().
+     */
+    CpuBackend getCpuBackend() const;
+
+    /**
+     * @brief Selects how memory accesses are tracked. NoTracking (the
+     *        default) runs every backend at full speed; Counting keeps
+     *        per-address read/write counters; Watching only slows the
+     *        pages that hold a watchpoint. Switchable at any time.
+     */
+    void setMemoryAccessPolicy(Memory::AccessPolicy policy);
+
+    /**
+     * @brief Selects the memory layout. Compact16K keeps only the 16 KB
+     *        the arcade board decodes (ROM, work RAM, VRAM), mirrored
+     *        above 0x3FFF, so states, resets and snapshots touch 8 KB of
+     *        RAM instead of 56 KB. Clears RAM and VRAM; the ROM is kept.
+     */
+    void setMemoryLayout(Memory::Layout layout);
+
+    /**
+     * @brief Writes the per-address access counters gathered while
+     *        Counting to a tab-separated file.
+     */
+    void logMemoryAccessCounts(const std::string& filename) const;
+
     // --- Data Output to Controller ---
 
     /**
@@ -209,6 +367,27 @@ public:
      */
     CPUState getCPUState() const;
 
+    // --- Save States ---
+
+    /**
+     * @brief Copies the whole machine state into out. Takes a few
+     *        microseconds: only RAM above the ROM is copied.
+     */
+    void saveState(EmulatorState& out) const;
+
+    /**
+     * @brief Restores a state from saveState(). The input ports keep
+     *        their live values, so keys pressed since the save are not lost.
+     *
+     * @returns false, leaving the emulator untouched, if the ROM was
+     *          reloaded or changed after the state was saved.
+     */
+    bool loadState(const EmulatorState& in);
+
+    // The original arcade machine had a 2MHz CPU and a 60Hz refresh rate.
+    // This gives us approximately 33,333 cycles per frame.
+    static constexpr int CYCLES_PER_FRAME = 33333;
+
     /**
      * @brief Provides direct, read-only access to the video RAM for rendering.
      * @return A constant pointer to the start of the 7KB video RAM buffer.
@@ -230,6 +409,182 @@ public:
     };
 
 private:
+    // --- Opcode Dispatch ---
+
+    /**
+     * @brief Signature of the opcode member functions.
+     *        Handlers receive the opcode byte (for handlers that decode
+     *        register or condition fields from it) and the pre-fetched
+     *        immediate operand (d8 or little-endian d16, 0 if none).
+     */
+    using OpHandler = void (Emulator::*)(uint8_t opcode, uint16_t operand);
+
+    /**
+     * @brief ALU operations of the 0x80-0xBF group, in opcode order
+     *        (bits 3-5 of the opcode).
+     */
+    enum class AluOp : uint8_t
+    {
+        ADD, ADC, SUB, SBB, ANA, XRA, ORA, CMP
+    };
+
+    /**
+     * @brief Signature of a dispatch table entry point.
+     */
+    using OpDispatch = void (*)(Emulator& cpu, uint8_t opcode);
+
+    /**
+     * @brief Signature of a pre-decoded entry point: the operand was
+     *        fetched at decode time and PC is already advanced.
+     */
+    using OpExecute = void (*)(Emulator& cpu, uint8_t opcode, uint16_t operand);
+
+    /**
+     * @brief One entry of the 256-entry opcode dispatch table.
+     */
+    struct OpcodeInfo
+    {
+        OpDispatch execute;   // Fetches the operand, advances PC, runs the handler.
+        OpExecute run;        // Runs the handler with a pre-decoded operand.
+        uint8_t length;       // Instruction length in bytes (1-3).
+        uint8_t cycles;       // Clock cycles when not taken / unconditional.
+        uint8_t cycles_taken; // Clock cycles for a taken conditional CALL/RET.
+        bool ends_block;      // May change PC (branch, RST, HLT): ends a basic block.
+    };
+
+    /**
+     * @brief Table entry point for an opcode of a given length.
+     *        Length is a template argument, so operand fetch and the
+     *        PC update compile to straight-line code for every opcode.
+     *        PC points to the next instruction before the handler runs,
+     *        branch handlers simply overwrite it.
+     */
+    template <OpHandler Handler, uint8_t Length>
+    static void dispatch(Emulator& cpu, uint8_t opcode)
+    {
+        uint16_t operand = 0;
+        if constexpr (Length == 2)
+        {
+            operand = cpu.memory.ReadByte(cpu.state.pc + 1);
+        }
+        if constexpr (Length == 3)
+        {
+            operand = cpu.memory.ReadWord(cpu.state.pc + 1);
+        }
+        cpu.state.pc += Length;
+        (cpu.*Handler)(opcode, operand);
+    }
+
+    /**
+     * @brief Pre-decoded entry point, used by the basic-block cache.
+     */
+    template <OpHandler Handler>
+    static void invoke(Emulator& cpu, uint8_t opcode, uint16_t operand)
+    {
+        (cpu.*Handler)(opcode, operand);
+    }
+
+    /**
+     * @brief Creates a dispatch table entry.
+     */
+    template <OpHandler Handler, uint8_t Length>
+    static constexpr OpcodeInfo entry(uint8_t cycles, uint8_t cycles_taken)
+    {
+        return {&dispatch<Handler, Length>, &invoke<Handler>, Length, cycles, cycles_taken, false};
+    }
+
+    /**
+     * @brief Fills 0x40-0x7F with op_MOV<Dst, Src> instantiations.
+     */
+    template <std::size_t... I>
+    static constexpr void fillMovGroup(std::array<OpcodeInfo, 256>& table, std::index_sequence<I...>);
+
+    /**
+     * @brief Fills 0x80-0xBF with op_ALU<Op, Src> instantiations.
+     */
+    template <std::size_t... I>
+    static constexpr void fillAluGroup(std::array<OpcodeInfo, 256>& table, std::index_sequence<I...>);
+
+    /**
+     * @brief Builds the opcode dispatch table at compile time.
+     */
+    static constexpr std::array<OpcodeInfo, 256> buildOpcodeTable();
+
+    /**
+     * @brief The opcode dispatch table, indexed by opcode.
+     */
+    static const std::array<OpcodeInfo, 256> OPCODE_TABLE;
+
+    // --- Basic-Block Cache ---
+
+    /**
+     * @brief One instruction of a pre-decoded basic block.
+     */
+    struct DecodedOp
+    {
+        OpExecute run;    // OPCODE_TABLE[opcode].run.
+        uint16_t operand; // Immediate operand (d8 or d16, 0 if none).
+        uint16_t next_pc; // Address of the following instruction.
+        uint8_t opcode;
+    };
+
+    /**
+     * @brief A straight-line run of instructions in ROM, ending at the
+     *        first branch. Its ops are block_ops[first, first + ops).
+     *        Idioms fused into superinstructions make ops < count.
+     */
+    struct BasicBlock
+    {
+        uint32_t first = 0;
+        uint16_t count = 0;   // Instructions, 0 if the first one cannot be cached.
+        uint16_t ops = 0;     // DecodedOps after superinstruction fusion.
+        uint16_t cycles = 0;  // Sum of the base cycles of every instruction.
+        uint16_t lead_cycles = 0; // Cycles before the last instruction starts.
+        uint8_t taken_extra = 0;  // Extra cycles if a final CALL/RET cc is taken.
+        bool decoded = false;
+    };
+
+    /**
+     * @brief Only the write-protected ROM (0x0000-0x1FFF) is cached,
+     *        code running from RAM uses the per-instruction loop.
+     */
+    static constexpr uint16_t BLOCK_CACHE_END = 0x2000;
+
+    /**
+     * @brief Upper bound on the instructions of one block.
+     */
+    static constexpr uint16_t MAX_BLOCK_OPS = 64;
+
+    // --- JIT ---
+
+    /**
+     * @brief Executable arena, compiled blocks and chaining state of the
+     *        JIT backend (emulator_jit.cpp). Created by the first
+     *        setCpuBackend(CpuBackend::Jit).
+     */
+    struct JitCache;
+
+    /**
+     * @brief Deletes a JitCache where its type is complete.
+     */
+    struct JitCacheDeleter
+    {
+        void operator()(JitCache* cache) const;
+    };
+
+    /**
+     * @brief Owns the JitCache. Native code embeds the address of its
+     *        Emulator, so copies and moves start empty and recompile.
+     */
+    struct JitHandle
+    {
+        std::unique_ptr<JitCache, JitCacheDeleter> cache;
+
+        JitHandle() = default;
+        JitHandle(const JitHandle&) {}
+        JitHandle& operator=(const JitHandle&) { cache.reset(); return *this; }
+    };
+
     // --- Internal CPU State ---
     
     /**
@@ -237,30 +592,232 @@ private:
      */
     CPUState state;
 
+    /**
+     * @brief Z/S/P/AC not yet written to state.flags.
+     *        Resolved by readers and at the end of every emulateCycles().
+     */
+    LazyFlags lazy_flags;
+
+    /**
+     * @brief The CPU core used by emulateCycles().
+     */
+    CpuBackend backend = CpuBackend::Interpreter;
+
+    /**
+     * @brief Cycles emulated since reset(); the scheduler's clock.
+     */
+    uint64_t cycle_count = 0;
+
+    /**
+     * @brief Wall time of the last successful ROM load, in microseconds.
+     */
+    uint64_t rom_load_time_us = 0;
+
+    /**
+     * @brief Pending hardware events, keyed on cycle_count.
+     */
+    EventScheduler scheduler;
+
+    /**
+     * @brief Basic block starting at every ROM address, decoded on first use.
+     */
+    std::vector<BasicBlock> blocks;
+
+    /**
+     * @brief Storage for the ops of every cached block.
+     */
+    std::vector<DecodedOp> block_ops;
+
+    /**
+     * @brief Memory::GetRomGeneration() the cache was decoded from.
+     */
+    uint32_t block_generation = 0;
+
+    /**
+     * @brief The JIT backend state, null until the JIT is selected.
+     */
+    JitHandle jit;
+
+    /**
+     * @brief Recompiled block starting at every ROM address, empty when
+     *        the loaded ROM is not the one AOT_ROM was generated from.
+     */
+    std::vector<const AotBlock*> aot_blocks;
+
+    /**
+     * @brief Memory::GetRomGeneration() aot_blocks was bound for.
+     */
+    uint32_t aot_generation = 0;
+
+    /**
+     * @brief True once aot_blocks has been bound at least once.
+     */
+    bool aot_bound = false;
+
+    /**
+     * @brief Idle loop classification of every ROM address: 0 not yet
+     *        classified, IDLE_NONE if not a loop head, else the byte
+     *        length of the loop body.
+     */
+    std::vector<uint8_t> idle_loops;
+
+    /**
+     * @brief Memory::GetRomGeneration() idle_loops was classified for.
+     */
+    uint32_t idle_generation = 0;
+
+    static constexpr uint8_t IDLE_NONE = 0xFF;
+
     /**
      * @brief The 64KB memory space of the 8080.
      * 64KB RAM - Includes ROM, WAM, VRAM and Debugging support.
      */
     Memory memory;
 
+    /**
+     * @brief Frame buffer the last rows were copied into, and the rows
+     *        copied into it since consumeDirtyRows().
+     */
+    const uint8_t* frame_target = nullptr;
+    Memory::DirtyRows frame_dirty_rows;
+
     
     // --- Helper Functions ---
 
     /**
      * @brief Fetches, decodes, and executes a single instruction from memory.
+     * @returns Its cycle cost (cycles_taken for a taken conditional CALL/RET).
+     */
+    int executeInstruction();
+
+    /**
+     * @brief Dispatch table loop behind emulateCycles() for the
+     *        Interpreter backend.
+     */
+    int runTable(int cycles);
+
+    /**
+     * @brief Ends a batch of cycles (every backend).
+     * @returns The cycles the batch used.
+     */
+    int endBatch(int cycles, int remaining);
+
+    /**
+     * @brief Batch loop of the block backends (emulator_batch.hpp).
+     * @param refresh Drops blocks made stale by a ROM change.
+     * @param find    Returns the block at a ROM pc, or null.
+     * @param run     Runs a block whole, returns the cycles it used.
+     */
+    template <class Refresh, class Find, class Run>
+    int runBlockBatch(int cycles, Refresh refresh, Find find, Run run);
+
+    /**
+     * @brief Handles one due event and schedules its next occurrence.
+     * @param frame See runUntilFrameEnd().
+     *
+     * @returns true if the event ends the frame (vblank).
+     */
+    bool dispatchEvent(const ScheduledEvent& event, uint8_t* frame);
+
+    /**
+     * @brief Copies the dirty VRAM rows in [first, last) into frame, or
+     *        every row of the range if frame is a new buffer.
+     */
+    void copyDirtyRows(uint8_t* frame, uint32_t first, uint32_t last);
+
+    /**
+     * @brief Threaded interpreter loop (emulator_threaded.cpp).
+     *        Same contract as the table loop in emulateCycles().
+     */
+    int runThreaded(int cycles);
+
+    /**
+     * @brief True if the compiler supports the threaded backend.
+     */
+    static bool threadedBackendAvailable();
+
+    /**
+     * @brief Block-cache loop (emulator_blocks.cpp). Runs whole ROM
+     *        blocks per dispatch, same contract as the table loop.
+     */
+    int runBlocks(int cycles);
+
+    /**
+     * @brief Decodes the basic block starting at ROM address start.
+     */
+    void decodeBlock(uint16_t start);
+
+    /**
+     * @brief Drops every cached block (the ROM changed).
+     */
+    void flushBlocks();
+
+    /**
+     * @brief Replaces known idioms in block_ops[first, first + count)
+     *        with superinstructions, in place.
+     * @returns The number of DecodedOps left.
      */
-    void executeInstruction();
+    uint16_t fuseBlockOps(uint32_t first, uint16_t count);
 
-        /**
-     * @brief Sets flags based on result of executing instruction
+    /**
+     * @brief JIT dispatcher loop (emulator_jit.cpp). Enters native code
+     *        for ROM blocks and interprets everything else, same
+     *        contract as the table loop.
+     */
+    int runJit(int cycles);
+
+    /**
+     * @brief Creates the JIT arena on first use.
+     * @returns false if the host cannot run the JIT backend.
      */
-    void setFlags(uint8_t result);
+    bool jitInit();
+
+    /**
+     * @brief AOT dispatcher loop (emulator_aot.cpp). Runs recompiled
+     *        ROM blocks and interprets everything else, same contract
+     *        as the table loop.
+     */
+    int runAot(int cycles);
+
+    /**
+     * @brief Fills aot_blocks if the loaded ROM matches AOT_ROM.
+     */
+    void bindAotRom();
+
+    /**
+     * @brief True if pc is the head of a side-effect-free self loop
+     *        (see emulator_idle.cpp). Classified on first use per ROM
+     *        address, reset when the ROM changes.
+     */
+    bool idleLoopHead(uint16_t pc);
+
+    /**
+     * @brief Interprets one iteration of the idle loop at state.pc and,
+     *        if it left the CPU state unchanged, skips the whole
+     *        iterations the rest of the budget would have spun.
+     * @param remaining Cycles left in the batch.
+     *
+     * @returns The cycles consumed, run and skipped.
+     */
+    int skipIdleLoop(int remaining);
+
+    /**
+     * @brief True if an iteration of the idle loop [head, end) reads a
+     *        page on the memory slow path (its code or the polled data).
+     */
+    bool idleLoopReadsSlowPage(uint16_t head, uint16_t end) const;
 
     /**
      * @brief Returns the value of the 16 bit register pair for registers H and L
      */
     uint16_t hl() const;
 
+    /**
+     * @brief Evaluates the condition field (bits 3-5) of a conditional
+     *        JMP/CALL/RET opcode against the current flags.
+     */
+    bool condition(uint8_t opcode) const;
+
     /**
      * @brief Handles input into the system
      */
@@ -272,116 +829,120 @@ private:
     void io_write(OutPortNum port, uint8_t val);
 
     /**
-     * @brief Gets value stored in register
+     * @brief Gets value stored in register, or memory at HL for REG_M.
+     *        The register is a template argument, so each instantiation
+     *        is a plain field access or a single memory read.
      */
-    uint8_t get_reg(uint8_t code);
+    template <RegisterCode Code>
+    uint8_t get_reg();
 
     /**
-     * @brief Sets value in register
+     * @brief Sets value in register, or memory at HL for REG_M.
      */
-    void set_reg(uint8_t code, uint8_t val);
+    template <RegisterCode Code>
+    void set_reg(uint8_t val);
 
     // --- Opcode Functions ---
 
     // Data Transfer Group
     /** @brief 0x01: Load Immediate into register pair B and C */
-    void op_LXI_B(); 
+    void op_LXI_B(uint8_t opcode, uint16_t operand); 
     /** @brief 0x02: Store accumulator indirect */
-    void op_STAX_B();
+    void op_STAX_B(uint8_t opcode, uint16_t operand);
     /** @brief 0x06: Move immediate to register B */
-    void op_MVI_B();
+    void op_MVI_B(uint8_t opcode, uint16_t operand);
     /** @brief 0x0A: Load accumulator indirect */
-    void op_LDAX_B();
+    void op_LDAX_B(uint8_t opcode, uint16_t operand);
     /** @brief 0x0E: Move immediate to register C */
-    void op_MVI_C();
+    void op_MVI_C(uint8_t opcode, uint16_t operand);
     /** @brief 0x11: Load immediate into register pair D and E */
-    void op_LXI_D();
+    void op_LXI_D(uint8_t opcode, uint16_t operand);
     /** @brief 0x12: Store accumulator indirect */
-    void op_STAX_D();
+    void op_STAX_D(uint8_t opcode, uint16_t operand);
     /** @brief 0x16: Move immediate to register D */
-    void op_MVI_D();
+    void op_MVI_D(uint8_t opcode, uint16_t operand);
     /** @brief 0x1A: Load accumulator indirect */
-    void op_LDAX_D();
+    void op_LDAX_D(uint8_t opcode, uint16_t operand);
     /** @brief 0x1E: Move immediate to register E */
-    void op_MVI_E();
+    void op_MVI_E(uint8_t opcode, uint16_t operand);
     /** @brief 0x21: Load immediate into register pair H and L */
-    void op_LXI_H();
+    void op_LXI_H(uint8_t opcode, uint16_t operand);
     /** @brief 0x22: Store H and L direct */
-    void op_SHLD();
+    void op_SHLD(uint8_t opcode, uint16_t operand);
     /** @brief 0x26: Move immediate to register H */
-    void op_MVI_H();
+    void op_MVI_H(uint8_t opcode, uint16_t operand);
     /** @brief 0x2A: Load H and L direct */
-    void op_LHLD();
+    void op_LHLD(uint8_t opcode, uint16_t operand);
     /** @brief 0x2E: Move immediate to register L */
-    void op_MVI_L();
+    void op_MVI_L(uint8_t opcode, uint16_t operand);
     /** @brief 0x31: Load immediate into stack pointer */
-    void op_LXI_SP();
+    void op_LXI_SP(uint8_t opcode, uint16_t operand);
     /** @brief 0x32: Store accumulator direct */
-    void op_STA();
+    void op_STA(uint8_t opcode, uint16_t operand);
     /** @brief 0x36: Move immediate to memory */
-    void op_MVI_M();
+    void op_MVI_M(uint8_t opcode, uint16_t operand);
     /** @brief 0x3A: Load accumulator direct */
-    void op_LDA();
+    void op_LDA(uint8_t opcode, uint16_t operand);
     /** @brief 0x3E: Move immediate to accumulator */
-    void op_MVI_A();
+    void op_MVI_A(uint8_t opcode, uint16_t operand);
     /** @brief 0xEB: Exchange H and L with D and E */
-    void op_XCHG();
+    void op_XCHG(uint8_t opcode, uint16_t operand);
 
     // Arithmetic Group
     /** @brief 0x03: Increment register pair B and C */
-    void op_INX_B();
+    void op_INX_B(uint8_t opcode, uint16_t operand);
     /** @brief 0x04: Increment register B */
-    void op_INR_B();
+    void op_INR_B(uint8_t opcode, uint16_t operand);
     /** @brief 0x05: Decrement register B */
-    void op_DCR_B();
+    void op_DCR_B(uint8_t opcode, uint16_t operand);
     /** @brief 0x09: Add register pair B and C to H and L */
-    void op_DAD_B();
+    void op_DAD_B(uint8_t opcode, uint16_t operand);
     /** @brief 0x0B: Decrement register pair B and C */
-    void op_DCX_B();
+    void op_DCX_B(uint8_t opcode, uint16_t operand);
     /** @brief 0x0C: Increment register C */
-    void op_INR_C();
+    void op_INR_C(uint8_t opcode, uint16_t operand);
     /** @brief 0x0D: Decrement register C */
-    void op_DCR_C();
+    void op_DCR_C(uint8_t opcode, uint16_t operand);
     /** @brief 0x13: Increment register pair D and E */
-    void op_INX_D();
+    void op_INX_D(uint8_t opcode, uint16_t operand);
     /** @brief 0x14: Increment register D */
-    void op_INR_D();
+    void op_INR_D(uint8_t opcode, uint16_t operand);
     /** @brief 0x15: Decrement register D */
-    void op_DCR_D();
+    void op_DCR_D(uint8_t opcode, uint16_t operand);
     /** @brief 0x19: Add register pair D and E to H and L */
-    void op_DAD_D();
+    void op_DAD_D(uint8_t opcode, uint16_t operand);
     /** @brief 0x1B: Decrement register pair D and E */
-    void op_DCX_D();
+    void op_DCX_D(uint8_t opcode, uint16_t operand);
     /** @brief 0x1C: Increment register E */
-    void op_INR_E();
+    void op_INR_E(uint8_t opcode, uint16_t operand);
     /** @brief 0x1D: Decrement register E */
-    void op_DCR_E();
+    void op_DCR_E(uint8_t opcode, uint16_t operand);
     /** @brief 0x23: Increment register pair H and L */
-    void op_INX_H();
+    void op_INX_H(uint8_t opcode, uint16_t operand);
     /** @brief 0x24: Increment register H */
-    void op_INR_H();
+    void op_INR_H(uint8_t opcode, uint16_t operand);
     /** @brief 0x25: Decrement register H */
-    void op_DCR_H();
+    void op_DCR_H(uint8_t opcode, uint16_t operand);
     /** @brief 0x27: Decimal adjust accumulator */
-    void op_DAA();
+    void op_DAA(uint8_t opcode, uint16_t operand);
     /** @brief 0x29: Add register pair H and L to H and L */
-    void op_DAD_H();
+    void op_DAD_H(uint8_t opcode, uint16_t operand);
     /** @brief 0x2B: Decrement register pair H and L */
-    void op_DCX_H();
+    void op_DCX_H(uint8_t opcode, uint16_t operand);
     /** @brief 0x2C: Increment register L */
-    void op_INR_L();
+    void op_INR_L(uint8_t opcode, uint16_t operand);
     /** @brief 0x2D: Decrement register L */
-    void op_DCR_L();
+    void op_DCR_L(uint8_t opcode, uint16_t operand);
     /** @brief 0x34: Increment memory */
-    void op_INR_M();
+    void op_INR_M(uint8_t opcode, uint16_t operand);
     /** @brief 0x35: Decrement memory */
-    void op_DCR_M();
+    void op_DCR_M(uint8_t opcode, uint16_t operand);
     /** @brief 0x39: Add stack pointer to H and L */
-    void op_DAD_SP();
+    void op_DAD_SP(uint8_t opcode, uint16_t operand);
     /** @brief 0x3C: Increment accumulator */
-    void op_INR_A();
+    void op_INR_A(uint8_t opcode, uint16_t operand);
     /** @brief 0x3D: Decrement accumulator */
-    void op_DCR_A();
+    void op_DCR_A(uint8_t opcode, uint16_t operand);
     /** @brief Executes the ADD instruction */
     void op_ADD(uint8_t val);
      /** @brief Executes the ADC instruction */
@@ -393,17 +954,17 @@ private:
 
     // Logical Group
     /** @brief 0x07: Rotate accumulator left */
-    void op_RLC();
+    void op_RLC(uint8_t opcode, uint16_t operand);
     /** @brief 0x0F: Rotate accumulator right */
-    void op_RRC();
+    void op_RRC(uint8_t opcode, uint16_t operand);
     /** @brief 0x1F: Rotate accumulator right through carry */
-    void op_RAR();
+    void op_RAR(uint8_t opcode, uint16_t operand);
     /** @brief 0x2F: Complement accumulator */
-    void op_CMA();
+    void op_CMA(uint8_t opcode, uint16_t operand);
     /** @brief 0x37: Set carry */
-    void op_STC();
+    void op_STC(uint8_t opcode, uint16_t operand);
     /** @brief 0x3F: Complement carry */
-    void op_CMC();
+    void op_CMC(uint8_t opcode, uint16_t operand);
     /** @brief Executes the ANA instruction (AND accumulator) */
     void op_ANA(uint8_t val);
     /** @brief Executes the XRA Instruction (XOR accumulator) */
@@ -412,68 +973,91 @@ private:
     void op_ORA(uint8_t val);
     /** @brief Executes the CMP instruction (compare accumulator) */
     void op_CMP(uint8_t val);
+    /** @brief 0x80-0xBF: ADD/ADC/SUB/SBB/ANA/XRA/ORA/CMP r */
+    template <AluOp Op, RegisterCode Src>
+    void op_ALU(uint8_t opcode, uint16_t operand);
+    /** @brief 0xE6: AND immediate with accumulator */
+    void op_ANI(uint8_t opcode, uint16_t operand);
+    /** @brief 0xEE: XOR immediate with accumulator */
+    void op_XRI(uint8_t opcode, uint16_t operand);
+    /** @brief 0xF6: OR immediate with accumulator */
+    void op_ORI(uint8_t opcode, uint16_t operand);
+    /** @brief 0xFE: Compare immediate with accumulator */
+    void op_CPI(uint8_t opcode, uint16_t operand);
 
     // Branch Group
     /** @brief 0xC3: Jump */
-    void op_JMP();
+    void op_JMP(uint8_t opcode, uint16_t operand);
     /** @brief 0xC9: Return */
-    void op_RET();
+    void op_RET(uint8_t opcode, uint16_t operand);
     /** @brief 0xCD: Call */
-    void op_CALL();
+    void op_CALL(uint8_t opcode, uint16_t operand);
     /** @brief 0xE9: Load program counter from H and L */
-    void op_PCHL();
+    void op_PCHL(uint8_t opcode, uint16_t operand);
     /** @brief Executes return conditional instructions */
-    void op_RET_cond(bool condition);
+    void op_RET_cond(uint8_t opcode, uint16_t operand);
     /** @brief Executes jump conditional instructions */
-    void op_JMP_cond(bool condition);
+    void op_JMP_cond(uint8_t opcode, uint16_t operand);
     /** @brief Executes call conditional instructions */
-    void op_CALL_cond(bool condition);
+    void op_CALL_cond(uint8_t opcode, uint16_t operand);
 
     // Stack, I/O, and Machine Control Group
     /** @brief 0x00: No operation */
-    void op_NOP();
+    void op_NOP(uint8_t opcode, uint16_t operand);
     /** @brief 0x76: Halt */
-    void op_HLT();
+    void op_HLT(uint8_t opcode, uint16_t operand);
     /** @brief 0xC1: Pop register pair B and C off stack */
-    void op_POP_B();
+    void op_POP_B(uint8_t opcode, uint16_t operand);
     /** @brief 0xC5: Push register pair B and C onto stack */
-    void op_PUSH_B();
+    void op_PUSH_B(uint8_t opcode, uint16_t operand);
     /** @brief 0xD1: Pop register pair D and E off stack */
-    void op_POP_D();
+    void op_POP_D(uint8_t opcode, uint16_t operand);
     /** @brief 0xD5: Push register pair D and E onto stack */
-    void op_PUSH_D();
+    void op_PUSH_D(uint8_t opcode, uint16_t operand);
     /** @brief 0xE1: Pop register pair H and L off stack */
-    void op_POP_H();
+    void op_POP_H(uint8_t opcode, uint16_t operand);
     /** @brief 0xE3: Exchange top of stack with H and L */
-    void op_XTHL();
+    void op_XTHL(uint8_t opcode, uint16_t operand);
     /** @brief 0xE5: Push register pair H and L onto stack */
-    void op_PUSH_H();
+    void op_PUSH_H(uint8_t opcode, uint16_t operand);
     /** @brief 0xF1: Pop processor status word off stack */
-    void op_POP_PSW();
+    void op_POP_PSW(uint8_t opcode, uint16_t operand);
     /** @brief 0xF5: Push processor status word onto stack */
-    void op_PUSH_PSW();
+    void op_PUSH_PSW(uint8_t opcode, uint16_t operand);
     /** @brief 0xFB: Enable interrupts */
-    void op_EI();
+    void op_EI(uint8_t opcode, uint16_t operand);
     /** @brief Handles the input to the system */
-    void op_IN();
+    void op_IN(uint8_t opcode, uint16_t operand);
     /** @brief Handles output from the system */
-    void op_OUT();
-    /** @brief Executes MOV instruction */
-    void op_MOV(uint8_t opcode);
+    void op_OUT(uint8_t opcode, uint16_t operand);
+    /** @brief 0x40-0x7F (except 0x76): MOV dst,src */
+    template <RegisterCode Dst, RegisterCode Src>
+    void op_MOV(uint8_t opcode, uint16_t operand);
     /** @brief Handles RST 0-7 Opcodes */
-    void op_RST(int index);
+    void op_RST(uint8_t opcode, uint16_t operand);
     /** @brief  Handles Opcode 0xF9 */
-    void op_SPHL();  // SP ← HL
+    void op_SPHL(uint8_t opcode, uint16_t operand);  // SP ← HL
     /** @brief Handles Opcode 0xC6 (ADI) */
-    void op_ADI(uint8_t immediateVal); // ADI d8
+    void op_ADI(uint8_t opcode, uint16_t operand); // ADI d8
     /** @brief Handles Opcode 0xCE (ACI) */
-    void op_ACI(uint8_t immediateVal); // ACI d8
+    void op_ACI(uint8_t opcode, uint16_t operand); // ACI d8
     /** @brief Hanldes Opcode 0xD6 */
-    void op_SUI(uint8_t val); // SUI d8
+    void op_SUI(uint8_t opcode, uint16_t operand); // SUI d8
     /** @brief Handles Opcode 0xDE */
-    void op_SBI(uint8_t val); // SBI d8
-
+    void op_SBI(uint8_t opcode, uint16_t operand); // SBI d8
+    /** @brief Any opcode without an implementation */
+    void op_UNIMPLEMENTED(uint8_t opcode, uint16_t operand);
 
+    // Superinstructions (emulator_blocks.cpp), only built by the block decoder.
+    /** @brief LDAX D / MOV M,A / INX H / INX D / DCR B / JNZ a16: one step of a block copy */
+    void op_FUSED_COPY(uint8_t opcode, uint16_t operand);
+    /** @brief DCX rp / MOV A,r / ORA r' / JNZ a16: 16-bit countdown, Pair 0-2 = B, D, H */
+    template <uint8_t Pair, bool HighFirst>
+    void op_FUSED_COUNTDOWN(uint8_t opcode, uint16_t operand);
+    /** @brief 2-4 PUSHes in a row: opcode = count, operand = pair codes (opcode bits 4-5), 2 bits each */
+    void op_FUSED_PUSH(uint8_t opcode, uint16_t operand);
+    /** @brief 2-4 POPs in a row, same encoding as op_FUSED_PUSH */
+    void op_FUSED_POP(uint8_t opcode, uint16_t operand);
 
 };
 
@@ -0,0 +1,56 @@
+/**********************************************************
+ * @file emulator_aot.cpp
+ *
+ * @brief Ahead-of-time recompiled backend.
+ *        tools/rom_recompiler translates the ROM into one C++
+ *        function per basic block at build time (see aot_rom.hpp).
+ *        This loop calls the block at state.pc when there is one and
+ *        interprets through OPCODE_TABLE otherwise: RAM code, I/O,
+ *        unimplemented opcodes and indirect targets (RET, PCHL) the
+ *        recompiler could not discover.
+ *
+ * @author Jese/Arnav (CPU Core)
+ *
+ *********************************************************/
+
+/***************** Include files. ***********************/
+#include "emulator.hpp"
+#include "emulator_batch.hpp"
+#include "alu.hpp"
+#include "aot_rom.hpp"
+#include "memory.hpp"
+
+/***************** Global Class Functions. ***********************/
+
+void Emulator::bindAotRom()
+{
+    aot_generation = memory.GetRomGeneration();
+    aot_bound = true;
+    aot_blocks.clear();
+
+    // Blocks are only valid for the exact ROM they were generated from.
+    if (AOT_ROM.block_count == 0 || aot_rom_hash(memory) != AOT_ROM.rom_hash)
+    {
+        return;
+    }
+
+    aot_blocks.assign(BLOCK_CACHE_END, nullptr);
+    for (size_t i = 0; i < AOT_ROM.block_count; ++i)
+    {
+        aot_blocks[AOT_ROM.blocks[i].start] = &AOT_ROM.blocks[i];
+    }
+}
+
+int Emulator::runAot(int cycles)
+{
+    return runBlockBatch(
+        cycles,
+        [this] {
+            if (!aot_bound || aot_generation != memory.GetRomGeneration())
+            {
+                bindAotRom();
+            }
+        },
+        [this](uint16_t pc) { return aot_blocks.empty() ? nullptr : aot_blocks[pc]; },
+        [this](const AotBlock& block, int) { return block.run(state, lazy_flags, memory); });
+}
@@ -0,0 +1,51 @@
+/**********************************************************
+ * @file emulator_batch.hpp
+ *
+ * @brief Batch driver shared by the backends that run whole ROM
+ *        blocks (BlockCache, Jit and Aot). Each backend only supplies
+ *        how to refresh its blocks, find the block at a PC and run it;
+ *        idle loops, the per-block budget check and the interpreter
+ *        fallback are the same for all of them.
+ *
+ * @author Jese/Arnav (CPU Core)
+ *
+ *********************************************************/
+#ifndef EMULATOR_BATCH_HPP_
+#define EMULATOR_BATCH_HPP_
+
+/***************** Include files. ***********************/
+#include "emulator.hpp"
+
+/***************** Global Class Functions. ***********************/
+
+template <class Refresh, class Find, class Run>
+int Emulator::runBlockBatch(int cycles, Refresh refresh, Find find, Run run)
+{
+    // ROM writes (loadROM, reset, test setup) happen between batches only.
+    refresh();
+
+    int remaining = cycles;
+    while (remaining > 0 && state.pc < 0xFFFF && !state.halted)
+    {
+        if (idleLoopHead(state.pc))
+        {
+            remaining -= skipIdleLoop(remaining);
+            continue;
+        }
+
+        // A block only runs whole, and only if the table loop would
+        // still start its last instruction, so batches stop at the
+        // same instruction.
+        const auto* block = (state.pc < BLOCK_CACHE_END) ? find(state.pc) : nullptr;
+        if (block != nullptr && block->lead_cycles < remaining)
+        {
+            remaining -= run(*block, remaining);
+            continue;
+        }
+
+        remaining -= executeInstruction();
+    }
+    return endBatch(cycles, remaining);
+}
+
+#endif /* EMULATOR_BATCH_HPP_ */
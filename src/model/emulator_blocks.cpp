@@ -0,0 +1,266 @@
+/**********************************************************
+ * @file emulator_blocks.cpp
+ *
+ * @brief Basic-block cache backend.
+ *        The ROM (0x0000-0x1FFF) cannot be written by the CPU, so
+ *        its code is decoded once into straight-line blocks of
+ *        pre-resolved handlers and operands, ending at the first
+ *        branch. A block then runs without any opcode or operand
+ *        fetch. Code in RAM uses the per-instruction table loop.
+ *
+ *        Hot idioms of the Space Invaders ROM (block copy loops,
+ *        16-bit countdowns, register save/restore) are fused into
+ *        one superinstruction at decode time. A fused op does the
+ *        work of every instruction it replaces, with the same flags,
+ *        and the block keeps its instruction count and cycle cost.
+ *
+ * @author Jese/Arnav (CPU Core)
+ *
+ *********************************************************/
+
+/***************** Include files. ***********************/
+#include "emulator.hpp"
+#include "emulator_batch.hpp"
+#include "alu.hpp"
+#include "memory.hpp"
+
+/***************** Local Functions. ***********************/
+
+// High/low registers of the pairs B, D and H (pair code 0-2).
+static constexpr uint8_t CPUState::* PAIR_FIELDS[3][2] = {
+    {&CPUState::b, &CPUState::c},
+    {&CPUState::d, &CPUState::e},
+    {&CPUState::h, &CPUState::l},
+};
+
+/***************** Global Class Functions. ***********************/
+
+// LDAX D / MOV M,A / INX H / INX D / DCR B / JNZ: copies one byte
+// from (DE) to (HL), the inner loop of the ROM's sprite/block copies.
+void Emulator::op_FUSED_COPY(uint8_t, uint16_t operand)
+{
+    state.a = memory.ReadByte((state.d << 8) | state.e);
+    memory.WriteByte(hl(), state.a);
+
+    uint16_t dst = hl() + 1;
+    uint16_t src = ((state.d << 8) | state.e) + 1;
+    state.h = dst >> 8;
+    state.l = dst & 0xFF;
+    state.d = src >> 8;
+    state.e = src & 0xFF;
+
+    state.b = alu_dcr(lazy_flags, state.b);
+    if (!alu_test(state.flags, lazy_flags, FLAG_Z))
+    {
+        state.pc = operand;
+    }
+}
+
+// DCX rp / MOV A,hi / ORA lo / JNZ (or MOV A,lo / ORA hi): loops
+// until the 16-bit register pair reaches zero.
+template <uint8_t Pair, bool HighFirst>
+void Emulator::op_FUSED_COUNTDOWN(uint8_t, uint16_t operand)
+{
+    uint8_t& hi = state.*PAIR_FIELDS[Pair][0];
+    uint8_t& lo = state.*PAIR_FIELDS[Pair][1];
+    uint16_t value = ((hi << 8) | lo) - 1;
+    hi = value >> 8;
+    lo = value & 0xFF;
+
+    state.a = HighFirst ? hi : lo;
+    alu_ora(state.a, state.flags, lazy_flags, HighFirst ? lo : hi);
+    if (!alu_test(state.flags, lazy_flags, FLAG_Z))
+    {
+        state.pc = operand;
+    }
+}
+
+// PUSH B/D/H/PSW runs, e.g. the register save on interrupt entry.
+void Emulator::op_FUSED_PUSH(uint8_t count, uint16_t pairs)
+{
+    for (uint8_t i = 0; i < count; ++i, pairs >>= 2)
+    {
+        uint8_t pair = pairs & 0x03;
+        uint8_t high = pair == 3 ? state.a : state.*PAIR_FIELDS[pair][0];
+        uint8_t low = pair == 3 ? alu_pack_psw(state.flags, lazy_flags) : state.*PAIR_FIELDS[pair][1];
+        state.sp -= 2;
+        memory.WriteWord(state.sp, (high << 8) | low);
+    }
+}
+
+// POP B/D/H/PSW runs, the matching register restore.
+void Emulator::op_FUSED_POP(uint8_t count, uint16_t pairs)
+{
+    for (uint8_t i = 0; i < count; ++i, pairs >>= 2)
+    {
+        uint8_t pair = pairs & 0x03;
+        uint16_t value = memory.ReadWord(state.sp);
+        uint8_t low = value & 0xFF;
+        uint8_t high = value >> 8;
+        state.sp += 2;
+        if (pair == 3)
+        {
+            alu_unpack_psw(state.flags, lazy_flags, low);
+            state.a = high;
+        }
+        else
+        {
+            state.*PAIR_FIELDS[pair][0] = high;
+            state.*PAIR_FIELDS[pair][1] = low;
+        }
+    }
+}
+
+uint16_t Emulator::fuseBlockOps(uint32_t first, uint16_t count)
+{
+    // Countdown entry points by pair (B, D, H) and MOV/ORA order.
+    static constexpr OpExecute COUNTDOWNS[3][2] = {
+        {&invoke<&Emulator::op_FUSED_COUNTDOWN<0, false>>, &invoke<&Emulator::op_FUSED_COUNTDOWN<0, true>>},
+        {&invoke<&Emulator::op_FUSED_COUNTDOWN<1, false>>, &invoke<&Emulator::op_FUSED_COUNTDOWN<1, true>>},
+        {&invoke<&Emulator::op_FUSED_COUNTDOWN<2, false>>, &invoke<&Emulator::op_FUSED_COUNTDOWN<2, true>>},
+    };
+    static constexpr uint8_t PAIR_REGS[3][2] = {{REG_B, REG_C}, {REG_D, REG_E}, {REG_H, REG_L}};
+
+    DecodedOp* ops = &block_ops[first];
+    uint16_t in = 0;
+    uint16_t out = 0;
+    while (in < count)
+    {
+        const DecodedOp* op = ops + in;
+        uint16_t left = count - in;
+        DecodedOp fused = *op;
+        uint16_t length = 1;
+
+        if (left >= 6 && op[0].opcode == 0x1A && op[1].opcode == 0x77 &&
+            ((op[2].opcode == 0x23 && op[3].opcode == 0x13) || (op[2].opcode == 0x13 && op[3].opcode == 0x23)) &&
+            op[4].opcode == 0x05 && op[5].opcode == 0xC2)
+        {
+            fused = {&invoke<&Emulator::op_FUSED_COPY>, op[5].operand, op[5].next_pc, 0};
+            length = 6;
+        }
+        else if (left >= 4 && (op[0].opcode == 0x0B || op[0].opcode == 0x1B || op[0].opcode == 0x2B) &&
+                 op[3].opcode == 0xC2)
+        {
+            // MOV A,x (0x78 | x) then ORA y (0xB0 | y), {x, y} = the pair.
+            uint8_t pair = op[0].opcode >> 4;
+            uint8_t hi = PAIR_REGS[pair][0];
+            uint8_t lo = PAIR_REGS[pair][1];
+            bool highFirst = op[1].opcode == (0x78 | hi) && op[2].opcode == (0xB0 | lo);
+            bool lowFirst = op[1].opcode == (0x78 | lo) && op[2].opcode == (0xB0 | hi);
+            if (highFirst || lowFirst)
+            {
+                fused = {COUNTDOWNS[pair][highFirst], op[3].operand, op[3].next_pc, 0};
+                length = 4;
+            }
+        }
+        else if ((op[0].opcode & 0xCF) == 0xC5 || (op[0].opcode & 0xCF) == 0xC1)
+        {
+            // Up to 4 PUSHes (0xC5 | pair << 4) or POPs (0xC1 | pair << 4) in a row.
+            uint8_t kind = op[0].opcode & 0xCF;
+            uint16_t pairs = 0;
+            uint16_t run = 0;
+            while (run < left && run < 4 && (op[run].opcode & 0xCF) == kind)
+            {
+                pairs |= ((op[run].opcode >> 4) & 0x03) << (2 * run);
+                ++run;
+            }
+            if (run > 1)
+            {
+                OpExecute entry = kind == 0xC5 ? &invoke<&Emulator::op_FUSED_PUSH> : &invoke<&Emulator::op_FUSED_POP>;
+                fused = {entry, pairs, op[run - 1].next_pc, static_cast<uint8_t>(run)};
+                length = run;
+            }
+        }
+
+        ops[out++] = fused;
+        in += length;
+    }
+    return out;
+}
+
+void Emulator::flushBlocks()
+{
+    blocks.assign(BLOCK_CACHE_END, BasicBlock{});
+    block_ops.clear();
+    block_generation = memory.GetRomGeneration();
+}
+
+void Emulator::decodeBlock(uint16_t start)
+{
+    BasicBlock block;
+    block.first = static_cast<uint32_t>(block_ops.size());
+    block.decoded = true;
+
+    uint16_t pc = start;
+    while (block.count < MAX_BLOCK_OPS)
+    {
+        uint8_t opcode = memory.ReadByte(pc);
+        const OpcodeInfo& info = OPCODE_TABLE[opcode];
+
+        // Operands that reach into RAM may change, stop before them.
+        if (pc + info.length > BLOCK_CACHE_END)
+        {
+            break;
+        }
+
+        uint16_t operand = 0;
+        if (info.length == 2)
+        {
+            operand = memory.ReadByte(pc + 1);
+        }
+        if (info.length == 3)
+        {
+            operand = memory.ReadWord(pc + 1);
+        }
+
+        pc += info.length;
+        block_ops.push_back({info.run, operand, pc, opcode});
+        block.count++;
+        block.lead_cycles = block.cycles;
+        block.cycles += info.cycles;
+        block.taken_extra = info.cycles_taken - info.cycles;
+
+        if (info.ends_block)
+        {
+            break;
+        }
+    }
+
+    block.ops = fuseBlockOps(block.first, block.count);
+    block_ops.resize(block.first + block.ops);
+    blocks[start] = block;
+}
+
+int Emulator::runBlocks(int cycles)
+{
+    return runBlockBatch(
+        cycles,
+        [this] {
+            if (blocks.empty() || block_generation != memory.GetRomGeneration())
+            {
+                flushBlocks();
+            }
+        },
+        [this](uint16_t pc) -> const BasicBlock* {
+            if (!blocks[pc].decoded)
+            {
+                decodeBlock(pc);
+            }
+            return (blocks[pc].count != 0) ? &blocks[pc] : nullptr;
+        },
+        [this](const BasicBlock& block, int) {
+            const DecodedOp* op = &block_ops[block.first];
+            const DecodedOp* last = op + block.ops - 1;
+            for (; op != last; ++op)
+            {
+                state.pc = op->next_pc;
+                op->run(*this, op->opcode, op->operand);
+            }
+
+            // A conditional CALL/RET only moves SP when it is taken.
+            uint16_t sp = state.sp;
+            state.pc = last->next_pc;
+            last->run(*this, last->opcode, last->operand);
+            return block.cycles + (state.sp != sp ? block.taken_extra : 0);
+        });
+}
@@ -0,0 +1,198 @@
+/**********************************************************
+ * @file emulator_idle.cpp
+ *
+ * @brief Idle loop fast-forward shared by the CPU backends.
+ *        Space Invaders spends most of its time polling RAM flags
+ *        that only the interrupt handlers change, in short loops
+ *        such as "LDA flag / ANA A / JZ loop". Interrupts are only
+ *        delivered between emulateCycles() batches, so once one
+ *        iteration of such a loop leaves every register and flag as
+ *        it found them, every further iteration in the batch does too,
+ *        and the batch can skip them instead of interpreting the spin.
+ *        Skipped iterations do no memory reads, so loops are never
+ *        skipped while accesses are counted or watched.
+ *
+ * @author Jese/Arnav (CPU Core)
+ *
+ *********************************************************/
+
+/***************** Include files. ***********************/
+#include "emulator.hpp"
+#include "alu.hpp"
+#include "memory.hpp"
+
+/***************** Macros and defines. ***********************/
+
+// Longest loop body considered, in instructions.
+static constexpr int IDLE_LOOP_MAX_OPS = 8;
+
+/***************** Local Functions. ***********************/
+
+// True for opcodes that only read memory and change registers or
+// flags: no memory writes, stack, I/O, interrupt control or HLT.
+static bool idlePure(uint8_t op)
+{
+    if (op >= 0x40 && op <= 0x7F)
+    {
+        return op < 0x70 || op > 0x77; // MOV, except MOV M,r and HLT.
+    }
+    if (op >= 0x80 && op <= 0xBF)
+    {
+        return true; // ALU A,r / A,M
+    }
+    switch (op)
+    {
+        case 0x00:                                     // NOP
+        case 0x01: case 0x11: case 0x21: case 0x31:    // LXI
+        case 0x03: case 0x13: case 0x23:               // INX
+        case 0x0B: case 0x1B: case 0x2B:               // DCX
+        case 0x04: case 0x0C: case 0x14: case 0x1C:    // INR r
+        case 0x24: case 0x2C: case 0x3C:
+        case 0x05: case 0x0D: case 0x15: case 0x1D:    // DCR r
+        case 0x25: case 0x2D: case 0x3D:
+        case 0x06: case 0x0E: case 0x16: case 0x1E:    // MVI r
+        case 0x26: case 0x2E: case 0x3E:
+        case 0x09: case 0x19: case 0x29: case 0x39:    // DAD
+        case 0x0A: case 0x1A: case 0x2A: case 0x3A:    // LDAX, LHLD, LDA
+        case 0x07: case 0x0F: case 0x1F:               // RLC, RRC, RAR
+        case 0x27: case 0x2F: case 0x37: case 0x3F:    // DAA, CMA, STC, CMC
+        case 0xEB:                                     // XCHG
+        case 0xC6: case 0xCE: case 0xD6: case 0xDE:    // ALU A,d8
+        case 0xE6: case 0xEE: case 0xF6: case 0xFE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// JMP and the conditional jumps.
+static bool isJump(uint8_t op)
+{
+    return op == 0xC3 || (op >= 0xC0 && (op & 0x07) == 0x02);
+}
+
+/***************** Global Class Functions. ***********************/
+
+bool Emulator::idleLoopHead(uint16_t pc)
+{
+    // Counted or watched reads must all happen: nothing is skipped.
+    if (pc >= BLOCK_CACHE_END || memory.GetAccessPolicy() != Memory::AccessPolicy::NoTracking)
+    {
+        return false;
+    }
+    if (idle_loops.empty() || idle_generation != memory.GetRomGeneration())
+    {
+        idle_loops.assign(BLOCK_CACHE_END, 0);
+        idle_generation = memory.GetRomGeneration();
+    }
+
+    uint8_t& mark = idle_loops[pc];
+    if (mark == 0)
+    {
+        // A loop head starts a run of pure instructions that ends with a
+        // jump back to it.
+        mark = IDLE_NONE;
+        uint32_t addr = pc;
+        for (int i = 0; i < IDLE_LOOP_MAX_OPS && addr + 3 <= BLOCK_CACHE_END; ++i)
+        {
+            uint8_t op = memory.ReadByte(addr);
+            if (isJump(op))
+            {
+                uint16_t target = memory.ReadByte(addr + 1) | (memory.ReadByte(addr + 2) << 8);
+                if (target == pc)
+                {
+                    mark = static_cast<uint8_t>(addr + 3 - pc);
+                }
+                break;
+            }
+            if (!idlePure(op))
+            {
+                break;
+            }
+            addr += OPCODE_TABLE[op].length;
+        }
+    }
+    return mark != IDLE_NONE;
+}
+
+// The loop's registers are the same on every iteration, so the current
+// HL/BC/DE are the addresses it reads through.
+bool Emulator::idleLoopReadsSlowPage(uint16_t head, uint16_t end) const
+{
+    auto slow = [this](uint32_t addr) {
+        return (memory.GetPageFlags(static_cast<uint16_t>(addr)) & Memory::PAGE_SLOW) != 0;
+    };
+    for (uint32_t addr = head; addr < end; addr += OPCODE_TABLE[memory.ReadByte(addr)].length)
+    {
+        const uint8_t op = memory.ReadByte(addr);
+        const uint16_t operand = memory.ReadByte(addr + 1) | (memory.ReadByte(addr + 2) << 8);
+        const bool readsM = op >= 0x40 && op <= 0xBF && (op & 0x07) == 0x06; // MOV r,M / ALU M
+        if (slow(addr) || slow(addr + 2) ||
+            (readsM && slow(hl())) ||
+            (op == 0x0A && slow((state.b << 8) | state.c)) ||      // LDAX B
+            (op == 0x1A && slow((state.d << 8) | state.e)) ||      // LDAX D
+            (op == 0x3A && slow(operand)) ||                       // LDA
+            (op == 0x2A && (slow(operand) || slow(operand + 1u)))) // LHLD
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int Emulator::skipIdleLoop(int remaining)
+{
+    const uint16_t head = state.pc;
+    const uint16_t end = head + idle_loops[head];
+
+    // Interpret up to two iterations with the table loop's budget rules:
+    // the first one may still change flags set before the loop.
+    int spent = 0;
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        alu_resolve(state.flags, lazy_flags);
+        const CPUState before = state;
+        const int start = spent;
+        while (remaining - spent > 0)
+        {
+            spent += executeInstruction();
+            if (state.pc <= head || state.pc >= end)
+            {
+                break;
+            }
+        }
+        if (state.pc != head)
+        {
+            // Left the loop, or the budget ran out mid-iteration.
+            return spent;
+        }
+
+        alu_resolve(state.flags, lazy_flags);
+        bool unchanged = state.a == before.a && state.b == before.b && state.c == before.c &&
+                         state.d == before.d && state.e == before.e && state.h == before.h &&
+                         state.l == before.l && state.sp == before.sp &&
+                         state.flags.psw == before.flags.psw;
+        if (unchanged && idleLoopReadsSlowPage(head, end))
+        {
+            // Same loop, but its reads are trapped: let them all run.
+            return spent;
+        }
+        if (unchanged)
+        {
+            // Every further iteration is identical. Skip the whole
+            // iterations that still leave some budget, so the batch ends
+            // at the same instruction the table loop would stop at.
+            const int iteration = spent - start;
+            const int left = remaining - spent;
+            if (left > 0)
+            {
+                spent += ((left - 1) / iteration) * iteration;
+            }
+            return spent;
+        }
+    }
+
+    // A counting loop (DCR / JNZ): never idle, stop checking it.
+    idle_loops[head] = IDLE_NONE;
+    return spent;
+}
@@ -0,0 +1,932 @@
+/**********************************************************
+ * @file emulator_jit.cpp
+ *
+ * @brief x86-64 dynamic recompiler (JIT) backend.
+ *        ROM basic blocks are translated into native code in an
+ *        executable arena the first time they run. While native code
+ *        runs, A, BC, DE, HL and SP live in host registers and the
+ *        flags stay in CPUState::flags in PSW layout, which is what
+ *        the x86 LAHF instruction produces.
+ *
+ *        Blocks with a constant successor (JMP, Jcc, CALL, RST, fall
+ *        through) are chained: the exit jump is patched to the target
+ *        block once it is compiled. RET, PCHL, IN/OUT and code in RAM
+ *        leave native code and go through the dispatcher in runJit(),
+ *        which interprets with the dispatch table. Opcodes without a
+ *        native translation call their op_* handler in place.
+ *        Each block charges its base cycles to the budget on entry.
+ *
+ * @author Jese/Arnav (CPU Core)
+ *
+ *********************************************************/
+
+/***************** Include files. ***********************/
+#include "emulator.hpp"
+#include "emulator_batch.hpp"
+#include "alu.hpp"
+#include "memory.hpp"
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+/***************** Macros and defines. ***********************/
+#if defined(__x86_64__) && defined(__linux__)
+#define JIT_X64 1
+#include <sys/mman.h>
+#endif
+
+#ifdef JIT_X64
+
+/***************** Local Classes. ***********************/
+
+namespace
+{
+
+// x86-64 register numbers.
+enum HostReg : uint8_t
+{
+    RAX = 0, RCX = 1, RDX = 2, RBX = 3, RSP = 4, RBP = 5, RSI = 6, RDI = 7,
+    R8 = 8, R12 = 12, R13 = 13, R14 = 14, R15 = 15,
+};
+
+// 8080 registers in callee-saved host registers, so helper calls keep them.
+// Register pairs hold the zero-extended 16-bit value (high byte in bits 8-15).
+constexpr uint8_t HOST_A = RBX;
+constexpr uint8_t HOST_BC = R13;
+constexpr uint8_t HOST_DE = R14;
+constexpr uint8_t HOST_HL = R15;
+constexpr uint8_t HOST_SP = RBP;
+constexpr uint8_t HOST_STATE = R12; // CPUState*.
+
+// Condition codes for Jcc.
+constexpr uint8_t CC_Z = 0x4;
+constexpr uint8_t CC_NZ = 0x5;
+constexpr uint8_t CC_L = 0xC;
+
+// Group-1 opcode extensions (0x81 /ext, 0x80 /ext) and shifts (0xC1 /ext).
+constexpr uint8_t EXT_ADD = 0, EXT_OR = 1, EXT_AND = 4, EXT_XOR = 6;
+constexpr uint8_t EXT_SHL = 4, EXT_SHR = 5;
+
+// CPUState field offsets, addressed as [r12 + disp32].
+constexpr int32_t OFF_A = offsetof(CPUState, a);
+constexpr int32_t OFF_B = offsetof(CPUState, b);
+constexpr int32_t OFF_C = offsetof(CPUState, c);
+constexpr int32_t OFF_D = offsetof(CPUState, d);
+constexpr int32_t OFF_E = offsetof(CPUState, e);
+constexpr int32_t OFF_H = offsetof(CPUState, h);
+constexpr int32_t OFF_L = offsetof(CPUState, l);
+constexpr int32_t OFF_SP = offsetof(CPUState, sp);
+constexpr int32_t OFF_PC = offsetof(CPUState, pc);
+constexpr int32_t OFF_PSW = offsetof(CPUState, flags);
+constexpr int32_t OFF_HALTED = offsetof(CPUState, halted);
+
+/**
+ * @brief Minimal x86-64 machine code writer for the JIT.
+ *        Only the encodings the translator needs: 32-bit register
+ *        ALU ops, 8-bit ops on AL/CL/DL/BL, byte/word accesses to
+ *        CPUState through r12 and rel32 jumps that can be patched.
+ */
+class X64Emitter
+{
+public:
+    void reset(uint8_t* base, size_t capacity) { code = base; cap = capacity; len = 0; }
+    size_t pos() const { return len; }
+    void rewind(size_t position) { len = position; }
+    size_t space() const { return cap - len; }
+    uint8_t* at(size_t position) const { return code + position; }
+
+    void u8(uint8_t v) { code[len++] = v; }
+    void u32(uint32_t v) { std::memcpy(code + len, &v, 4); len += 4; }
+    void u64(uint64_t v) { std::memcpy(code + len, &v, 8); len += 8; }
+
+    // REX prefix, only emitted when a field needs it.
+    void rex(bool w, uint8_t reg, uint8_t rm)
+    {
+        uint8_t prefix = 0x40 | (w ? 0x08 : 0) | ((reg & 0x08) >> 1) | ((rm & 0x08) >> 3);
+        if (prefix != 0x40) { u8(prefix); }
+    }
+    void modrm(uint8_t mod, uint8_t reg, uint8_t rm) { u8((mod << 6) | ((reg & 7) << 3) | (rm & 7)); }
+
+    // op r/m32, r32 (0x01 add, 0x09 or, 0x21 and, 0x89 mov, ...).
+    void rr(uint8_t opc, uint8_t dst, uint8_t src) { rex(false, src, dst); u8(opc); modrm(3, src, dst); }
+    // op r/m8, r8 on AL/CL/DL/BL (0x00 add, 0x10 adc, 0x38 cmp, ...).
+    void rr8(uint8_t opc, uint8_t dst, uint8_t src) { u8(opc); modrm(3, src, dst); }
+    // op r/m32, imm32.
+    void ri(uint8_t ext, uint8_t dst, uint32_t imm) { rex(false, 0, dst); u8(0x81); modrm(3, ext, dst); u32(imm); }
+    void shift(uint8_t ext, uint8_t dst, uint8_t n) { rex(false, 0, dst); u8(0xC1); modrm(3, ext, dst); u8(n); }
+    void movImm(uint8_t dst, uint32_t imm) { rex(false, 0, dst); u8(0xB8 + (dst & 7)); u32(imm); }
+    void movImm64(uint8_t dst, uint64_t imm) { rex(true, 0, dst); u8(0xB8 + (dst & 7)); u64(imm); }
+    // movzx r32, r8 (source AL/CL/DL/BL or R8B-R15B).
+    void movzx8(uint8_t dst, uint8_t src) { rex(false, dst, src); u8(0x0F); u8(0xB6); modrm(3, dst, src); }
+
+    // CPUState accesses: [r12 + disp32].
+    void state(uint8_t reg, int32_t disp) { modrm(2, reg, 4); u8(0x24); u32(disp); }
+    void loadU8(uint8_t dst, int32_t disp) { rex(false, dst, HOST_STATE); u8(0x0F); u8(0xB6); state(dst, disp); }
+    void loadU16(uint8_t dst, int32_t disp) { rex(false, dst, HOST_STATE); u8(0x0F); u8(0xB7); state(dst, disp); }
+    void store8(uint8_t src, int32_t disp) { rex(false, src, HOST_STATE); u8(0x88); state(src, disp); }
+    void store16(uint8_t src, int32_t disp) { u8(0x66); rex(false, src, HOST_STATE); u8(0x89); state(src, disp); }
+    // 0x80 /ext ib (and/or/xor byte) and 0xF6 /0 ib (test byte).
+    void state8Imm(uint8_t opc, uint8_t ext, int32_t disp, uint8_t imm) { rex(false, 0, HOST_STATE); u8(opc); state(ext, disp); u8(imm); }
+    // op byte [state + disp], r8.
+    void state8Reg(uint8_t opc, uint8_t src, int32_t disp) { rex(false, src, HOST_STATE); u8(opc); state(src, disp); }
+
+    // Cycle budget in the dword at [rsp].
+    void cmpBudget(uint32_t n) { u8(0x81); u8(0x3C); u8(0x24); u32(n); }
+    void subBudget(uint32_t n) { u8(0x81); u8(0x2C); u8(0x24); u32(n); }
+
+    // Jumps return the offset of their rel32 field for patch().
+    size_t jmp() { u8(0xE9); u32(0); return len - 4; }
+    size_t jcc(uint8_t cc) { u8(0x0F); u8(0x80 | cc); u32(0); return len - 4; }
+    void patch(size_t site, size_t target)
+    {
+        int32_t rel = static_cast<int32_t>(static_cast<int64_t>(target) - static_cast<int64_t>(site + 4));
+        std::memcpy(code + site, &rel, 4);
+    }
+
+    void call(const void* fn) { movImm64(RAX, reinterpret_cast<uint64_t>(fn)); u8(0xFF); u8(0xD0); }
+    void push(uint8_t r) { rex(false, 0, r); u8(0x50 + (r & 7)); }
+    void pop(uint8_t r) { rex(false, 0, r); u8(0x58 + (r & 7)); }
+    // lahf; movzx ecx, ah: ECX = S Z 0 AC 0 P 1 CY of the last x86 op.
+    void flagsToEcx() { u8(0x9F); u8(0x0F); u8(0xB6); u8(0xCC); }
+
+private:
+    uint8_t* code = nullptr;
+    size_t cap = 0;
+    size_t len = 0;
+};
+
+} // namespace
+
+/***************** Local Classes. ***********************/
+
+struct Emulator::JitCache
+{
+    /**
+     * @brief Native entry: runs from block until the budget or a
+     *        dynamic exit, returns the cycles left.
+     */
+    using Entry = int (*)(CPUState* state, int remaining, const uint8_t* block);
+
+    struct Block
+    {
+        const uint8_t* code = nullptr; // Null if the block starts with I/O or cannot be cached.
+        uint16_t lead_cycles = 0;      // Cycles before its last instruction starts.
+        bool compiled = false;
+    };
+
+    // A static exit whose rel32 jumps to target, patched when it is compiled.
+    struct Exit
+    {
+        size_t site;
+        uint16_t target;
+    };
+
+    static constexpr size_t ARENA_SIZE = 4 * 1024 * 1024;
+    static constexpr size_t MAX_BLOCK_BYTES = 16 * 1024; // Upper bound for one block and its stubs.
+
+    Emulator* cpu = nullptr;
+    uint8_t* arena = nullptr;
+    X64Emitter emit;
+    Entry enter = nullptr;
+    size_t epilogue = 0;
+    size_t code_start = 0;
+    std::vector<Block> blocks;
+    std::vector<std::vector<size_t>> links; // Exit sites waiting for each ROM address.
+    std::vector<Exit> exits;                 // Exits of the block being compiled.
+    uint32_t generation = 0;
+
+    ~JitCache()
+    {
+        if (arena != nullptr)
+        {
+            munmap(arena, ARENA_SIZE);
+        }
+    }
+
+    // --- Helpers called from native code ---
+
+    static uint32_t read(Emulator* cpu, uint32_t address)
+    {
+        return cpu->memory.ReadByte(static_cast<uint16_t>(address));
+    }
+
+    static void write(Emulator* cpu, uint32_t address, uint32_t value)
+    {
+        cpu->memory.WriteByte(static_cast<uint16_t>(address), static_cast<uint8_t>(value));
+    }
+
+    static uint32_t readWord(Emulator* cpu, uint32_t address)
+    {
+        return cpu->memory.ReadWord(static_cast<uint16_t>(address));
+    }
+
+    static void writeWord(Emulator* cpu, uint32_t address, uint32_t value)
+    {
+        cpu->memory.WriteWord(static_cast<uint16_t>(address), static_cast<uint16_t>(value));
+    }
+
+    // Runs an opcode without a native translation through its handler.
+    static void interpret(Emulator* cpu, uint32_t opcode, uint32_t operand, uint32_t next_pc, OpExecute run)
+    {
+        cpu->state.pc = static_cast<uint16_t>(next_pc);
+        run(*cpu, static_cast<uint8_t>(opcode), static_cast<uint16_t>(operand));
+        alu_resolve(cpu->state.flags, cpu->lazy_flags);
+    }
+
+    // --- Arena ---
+
+    bool init(Emulator* owner)
+    {
+        cpu = owner;
+        void* mem = mmap(nullptr, ARENA_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mem == MAP_FAILED)
+        {
+            return false;
+        }
+        arena = static_cast<uint8_t*>(mem);
+        emit.reset(arena, ARENA_SIZE);
+        emitTrampoline();
+        code_start = emit.pos();
+        flush();
+        return true;
+    }
+
+    // Drops every compiled block, keeping the trampoline.
+    void flush()
+    {
+        emit.rewind(code_start);
+        blocks.assign(BLOCK_CACHE_END, Block{});
+        links.assign(BLOCK_CACHE_END, {});
+        generation = cpu->memory.GetRomGeneration();
+    }
+
+    // --- Register moves between CPUState and host registers ---
+
+    void loadPair(uint8_t pair, int32_t hi, int32_t lo)
+    {
+        emit.loadU8(pair, hi);
+        emit.shift(EXT_SHL, pair, 8);
+        emit.loadU8(RAX, lo);
+        emit.rr(0x09, pair, RAX);
+    }
+
+    void storePair(uint8_t pair, int32_t hi, int32_t lo)
+    {
+        emit.store8(pair, lo);
+        emit.rr(0x89, RAX, pair);
+        emit.shift(EXT_SHR, RAX, 8);
+        emit.store8(RAX, hi);
+    }
+
+    void reload()
+    {
+        emit.loadU8(HOST_A, OFF_A);
+        loadPair(HOST_BC, OFF_B, OFF_C);
+        loadPair(HOST_DE, OFF_D, OFF_E);
+        loadPair(HOST_HL, OFF_H, OFF_L);
+        emit.loadU16(HOST_SP, OFF_SP);
+    }
+
+    void spill()
+    {
+        emit.store8(HOST_A, OFF_A);
+        storePair(HOST_BC, OFF_B, OFF_C);
+        storePair(HOST_DE, OFF_D, OFF_E);
+        storePair(HOST_HL, OFF_H, OFF_L);
+        emit.store16(HOST_SP, OFF_SP);
+    }
+
+    // Entry and exit code shared by every block.
+    void emitTrampoline()
+    {
+        enter = reinterpret_cast<Entry>(emit.at(emit.pos()));
+        for (uint8_t r : {RBX, RBP, R12, R13, R14, R15})
+        {
+            emit.push(r);
+        }
+        emit.u8(0x48); emit.u8(0x83); emit.u8(0xEC); emit.u8(0x08); // sub rsp, 8 (keeps calls 16-byte aligned)
+        emit.u8(0x49); emit.u8(0x89); emit.u8(0xFC);                // mov r12, rdi
+        emit.u8(0x89); emit.u8(0x34); emit.u8(0x24);                // mov [rsp], esi (budget)
+        reload();
+        emit.u8(0xFF); emit.u8(0xE2);                               // jmp rdx
+
+        epilogue = emit.pos();
+        spill();
+        emit.u8(0x8B); emit.u8(0x04); emit.u8(0x24);                // mov eax, [rsp]
+        emit.u8(0x48); emit.u8(0x83); emit.u8(0xC4); emit.u8(0x08); // add rsp, 8
+        for (uint8_t r : {R15, R14, R13, R12, RBP, RBX})
+        {
+            emit.pop(r);
+        }
+        emit.u8(0xC3);                                              // ret
+    }
+
+    // --- 8080 operand access, values in EAX ---
+
+    void callRead()
+    {
+        emit.movImm64(RDI, reinterpret_cast<uint64_t>(cpu));
+        emit.call(reinterpret_cast<const void*>(&read));
+    }
+
+    // Writes EAX to the address in ESI.
+    void callWrite()
+    {
+        emit.rr(0x89, RDX, RAX);
+        emit.movImm64(RDI, reinterpret_cast<uint64_t>(cpu));
+        emit.call(reinterpret_cast<const void*>(&write));
+    }
+
+    static uint8_t pairOf(uint8_t code)
+    {
+        return code < REG_D ? HOST_BC : (code < REG_H ? HOST_DE : HOST_HL);
+    }
+
+    void loadReg(uint8_t code)
+    {
+        if (code == REG_A)
+        {
+            emit.rr(0x89, RAX, HOST_A);
+        }
+        else if (code == REG_M)
+        {
+            emit.rr(0x89, RSI, HOST_HL);
+            callRead();
+        }
+        else if ((code & 1) == 0) // B, D, H: high byte.
+        {
+            emit.rr(0x89, RAX, pairOf(code));
+            emit.shift(EXT_SHR, RAX, 8);
+        }
+        else
+        {
+            emit.movzx8(RAX, pairOf(code));
+        }
+    }
+
+    void storeReg(uint8_t code)
+    {
+        if (code == REG_A)
+        {
+            emit.movzx8(HOST_A, RAX);
+        }
+        else if (code == REG_M)
+        {
+            emit.rr(0x89, RSI, HOST_HL);
+            callWrite();
+        }
+        else
+        {
+            uint8_t pair = pairOf(code);
+            bool high = (code & 1) == 0;
+            emit.movzx8(RAX, RAX);
+            if (high)
+            {
+                emit.shift(EXT_SHL, RAX, 8);
+            }
+            emit.ri(EXT_AND, pair, high ? 0x00FF : 0xFF00);
+            emit.rr(0x09, pair, RAX);
+        }
+    }
+
+    // --- Stack ---
+
+    // Pushes the bytes loadHi()/loadLo() set up in EDX as one word:
+    // SP - 1 gets the high byte, SP - 2 the low byte.
+    template <typename LoadHi, typename LoadLo>
+    void push16(LoadHi loadHi, LoadLo loadLo)
+    {
+        loadHi();
+        emit.rr(0x89, RCX, RDX);
+        emit.shift(EXT_SHL, RCX, 8);
+        loadLo();
+        emit.rr(0x09, RDX, RCX);
+        emit.ri(EXT_ADD, HOST_SP, 0xFFFFFFFE);
+        emit.ri(EXT_AND, HOST_SP, 0xFFFF);
+        emit.rr(0x89, RSI, HOST_SP);
+        emit.movImm64(RDI, reinterpret_cast<uint64_t>(cpu));
+        emit.call(reinterpret_cast<const void*>(&writeWord));
+    }
+
+    void pushImm(uint16_t value)
+    {
+        push16([&] { emit.movImm(RDX, value >> 8); },
+               [&] { emit.movImm(RDX, value & 0xFF); });
+    }
+
+    // Pops one word into the two bytes written by storeLo()/storeHi()
+    // from EAX. ECX keeps the word while storeLo() runs.
+    template <typename StoreLo, typename StoreHi>
+    void pop16(StoreLo storeLo, StoreHi storeHi)
+    {
+        emit.rr(0x89, RSI, HOST_SP);
+        emit.movImm64(RDI, reinterpret_cast<uint64_t>(cpu));
+        emit.call(reinterpret_cast<const void*>(&readWord));
+        emit.rr(0x89, RCX, RAX);
+        emit.movzx8(RAX, RAX);
+        storeLo();
+        emit.rr(0x89, RAX, RCX);
+        emit.shift(EXT_SHR, RAX, 8);
+        storeHi();
+        emit.ri(EXT_ADD, HOST_SP, 2);
+        emit.ri(EXT_AND, HOST_SP, 0xFFFF);
+    }
+
+    // --- Flags ---
+
+    // Stores the S Z AC P CY captured by flagsToEcx(), keeping keep_mask bits.
+    void storeFlags(uint8_t keep_mask)
+    {
+        if (keep_mask != 0xFF)
+        {
+            emit.ri(EXT_AND, RCX, keep_mask);
+        }
+        emit.store8(RCX, OFF_PSW);
+    }
+
+    // Sets x86 CF from the 8080 CY bit (shr ecx, 1).
+    void loadCarry()
+    {
+        emit.loadU8(RCX, OFF_PSW);
+        emit.shift(EXT_SHR, RCX, 1);
+    }
+
+    // A = A op EAX with the flags of alu.hpp.
+    void emitAlu(AluOp op)
+    {
+        switch (op)
+        {
+            case AluOp::ADD: emit.rr8(0x00, RBX, RAX); emit.flagsToEcx(); storeFlags(0xFF); break;
+            case AluOp::ADC: loadCarry(); emit.rr8(0x10, RBX, RAX); emit.flagsToEcx(); storeFlags(0xFF); break;
+            case AluOp::SUB: emit.rr8(0x28, RBX, RAX); emit.flagsToEcx(); storeFlags(0xFF); break;
+            case AluOp::SBB: loadCarry(); emit.rr8(0x18, RBX, RAX); emit.flagsToEcx(); storeFlags(0xFF); break;
+            case AluOp::CMP: emit.rr8(0x38, RBX, RAX); emit.flagsToEcx(); storeFlags(0xFF); break;
+            case AluOp::ANA:
+                // AC = bit 3 of (A | value), moved to bit 4.
+                emit.rr(0x89, RDX, RBX);
+                emit.rr(0x09, RDX, RAX);
+                emit.ri(EXT_AND, RDX, 0x08);
+                emit.shift(EXT_SHL, RDX, 1);
+                emit.rr8(0x20, RBX, RAX);
+                emit.flagsToEcx();
+                emit.ri(EXT_AND, RCX, FLAG_ZSP | PSW_FIXED_ONES);
+                emit.rr(0x09, RCX, RDX);
+                storeFlags(0xFF);
+                break;
+            case AluOp::XRA: emit.rr8(0x30, RBX, RAX); emit.flagsToEcx(); storeFlags(FLAG_ZSP | PSW_FIXED_ONES); break;
+            case AluOp::ORA: emit.rr8(0x08, RBX, RAX); emit.flagsToEcx(); storeFlags(FLAG_ZSP | PSW_FIXED_ONES); break;
+        }
+    }
+
+    // INR/DCR on EAX. CY is kept, x86 AF of DEC is the inverse of the 8080 AC.
+    void emitIncDec(bool dec)
+    {
+        emit.u8(0xFE);
+        emit.u8(dec ? 0xC8 : 0xC0); // dec al / inc al
+        emit.flagsToEcx();
+        emit.ri(EXT_AND, RCX, FLAG_ZSP | FLAG_AC | PSW_FIXED_ONES);
+        if (dec)
+        {
+            emit.ri(EXT_XOR, RCX, FLAG_AC);
+        }
+        emit.loadU8(RDX, OFF_PSW);
+        emit.ri(EXT_AND, RDX, FLAG_CY);
+        emit.rr(0x09, RCX, RDX);
+        storeFlags(0xFF);
+    }
+
+    // Tests the condition in bits 3-5 of a conditional opcode.
+    // Returns the Jcc code that jumps when the condition holds.
+    uint8_t testCondition(uint8_t opcode)
+    {
+        static constexpr uint8_t COND_MASKS[4] = {FLAG_Z, FLAG_CY, FLAG_P, FLAG_S};
+        uint8_t cc = (opcode >> 3) & 0x07;
+        emit.state8Imm(0xF6, 0, OFF_PSW, COND_MASKS[cc >> 1]);
+        return (cc & 1) ? CC_NZ : CC_Z;
+    }
+
+    // Cycles a taken conditional CALL/RET costs on top of its base cycles.
+    static uint32_t takenExtra(uint8_t opcode)
+    {
+        return OPCODE_TABLE[opcode].cycles_taken - OPCODE_TABLE[opcode].cycles;
+    }
+
+    // --- Exits ---
+
+    void exitTo(uint16_t target) { exits.push_back({emit.jmp(), target}); }
+    void exitIf(uint8_t cc, uint16_t target) { exits.push_back({emit.jcc(cc), target}); }
+
+    // Leaves native code with state.pc already stored.
+    void exitDynamic() { emit.patch(emit.jmp(), epilogue); }
+
+    // Stores a constant PC and leaves native code.
+    size_t emitStub(uint16_t target)
+    {
+        size_t stub = emit.pos();
+        emit.movImm(RAX, target);
+        emit.store16(RAX, OFF_PC);
+        emit.patch(emit.jmp(), epilogue);
+        return stub;
+    }
+
+    // --- Translation ---
+
+    // Calls the handler of an opcode on a synced CPUState.
+    void emitInterpret(uint8_t opcode, uint16_t operand, uint16_t next_pc)
+    {
+        spill();
+        emit.movImm64(RDI, reinterpret_cast<uint64_t>(cpu));
+        emit.movImm(RSI, opcode);
+        emit.movImm(RDX, operand);
+        emit.movImm(RCX, next_pc);
+        emit.movImm64(R8, reinterpret_cast<uint64_t>(OPCODE_TABLE[opcode].run));
+        emit.call(reinterpret_cast<const void*>(&interpret));
+        reload();
+    }
+
+    // Translates one non-branch instruction.
+    void emitOp(uint8_t opcode, uint16_t operand, uint16_t next_pc)
+    {
+        // Opcodes the interpreter does not implement keep its behaviour.
+        if (OPCODE_TABLE[opcode].run == &invoke<&Emulator::op_UNIMPLEMENTED>)
+        {
+            emitInterpret(opcode, operand, next_pc);
+            return;
+        }
+        if (opcode >= 0x40 && opcode <= 0x7F) // MOV (0x76 HLT ends the block)
+        {
+            uint8_t dst = (opcode >> 3) & 0x07;
+            uint8_t src = opcode & 0x07;
+            if (dst != src)
+            {
+                loadReg(src);
+                storeReg(dst);
+            }
+            return;
+        }
+        if (opcode >= 0x80 && opcode <= 0xBF) // ALU A,r
+        {
+            loadReg(opcode & 0x07);
+            emitAlu(static_cast<AluOp>((opcode >> 3) & 0x07));
+            return;
+        }
+        if ((opcode & 0xC7) == 0xC6) // ALU A,d8
+        {
+            emit.movImm(RAX, operand & 0xFF);
+            emitAlu(static_cast<AluOp>((opcode >> 3) & 0x07));
+            return;
+        }
+        if (opcode < 0x40 && (opcode & 0x07) == 0x06) // MVI
+        {
+            emit.movImm(RAX, operand & 0xFF);
+            storeReg((opcode >> 3) & 0x07);
+            return;
+        }
+        if (opcode < 0x40 && (opcode & 0x06) == 0x04) // INR / DCR
+        {
+            uint8_t reg = (opcode >> 3) & 0x07;
+            loadReg(reg);
+            emitIncDec(opcode & 0x01);
+            storeReg(reg);
+            return;
+        }
+
+        static constexpr uint8_t PAIRS[4] = {HOST_BC, HOST_DE, HOST_HL, HOST_SP};
+        uint8_t pair = PAIRS[(opcode >> 4) & 0x03];
+        switch (opcode)
+        {
+            case 0x00: break; // NOP
+            case 0x01: case 0x11: case 0x21: case 0x31: // LXI
+                emit.movImm(pair, operand);
+                break;
+            case 0x03: case 0x13: case 0x23: case 0x33: // INX
+                emit.ri(EXT_ADD, pair, 1);
+                emit.ri(EXT_AND, pair, 0xFFFF);
+                break;
+            case 0x0B: case 0x1B: case 0x2B: case 0x3B: // DCX
+                emit.ri(EXT_ADD, pair, 0xFFFFFFFF);
+                emit.ri(EXT_AND, pair, 0xFFFF);
+                break;
+            case 0x09: case 0x19: case 0x29: case 0x39: // DAD: CY = carry out of bit 15
+                emit.rr(0x01, HOST_HL, pair);
+                emit.rr(0x89, RAX, HOST_HL);
+                emit.shift(EXT_SHR, RAX, 16);
+                emit.ri(EXT_AND, HOST_HL, 0xFFFF);
+                emit.state8Imm(0x80, EXT_AND, OFF_PSW, static_cast<uint8_t>(~FLAG_CY));
+                emit.state8Reg(0x08, RAX, OFF_PSW);
+                break;
+            case 0x02: case 0x12: // STAX
+                emit.rr(0x89, RSI, pair);
+                emit.rr(0x89, RAX, HOST_A);
+                callWrite();
+                break;
+            case 0x0A: case 0x1A: // LDAX
+                emit.rr(0x89, RSI, pair);
+                callRead();
+                emit.movzx8(HOST_A, RAX);
+                break;
+            case 0x32: // STA
+                emit.movImm(RSI, operand);
+                emit.rr(0x89, RAX, HOST_A);
+                callWrite();
+                break;
+            case 0x3A: // LDA
+                emit.movImm(RSI, operand);
+                callRead();
+                emit.movzx8(HOST_A, RAX);
+                break;
+            case 0x2F: // CMA
+                emit.ri(EXT_XOR, HOST_A, 0xFF);
+                break;
+            case 0x37: // STC
+                emit.state8Imm(0x80, EXT_OR, OFF_PSW, FLAG_CY);
+                break;
+            case 0x3F: // CMC
+                emit.state8Imm(0x80, EXT_XOR, OFF_PSW, FLAG_CY);
+                break;
+            case 0xEB: // XCHG
+                emit.rr(0x89, RAX, HOST_DE);
+                emit.rr(0x89, HOST_DE, HOST_HL);
+                emit.rr(0x89, HOST_HL, RAX);
+                break;
+            case 0xC5: case 0xD5: case 0xE5: // PUSH B/D/H
+                push16([&] { emit.rr(0x89, RDX, pair); emit.shift(EXT_SHR, RDX, 8); },
+                       [&] { emit.movzx8(RDX, pair); });
+                break;
+            case 0xF5: // PUSH PSW
+                push16([&] { emit.rr(0x89, RDX, HOST_A); },
+                       [&] {
+                           emit.loadU8(RDX, OFF_PSW);
+                           emit.ri(EXT_AND, RDX, PSW_VALID_BITS);
+                           emit.ri(EXT_OR, RDX, PSW_FIXED_ONES);
+                       });
+                break;
+            case 0xC1: case 0xD1: case 0xE1: // POP B/D/H
+            {
+                uint8_t hi = static_cast<uint8_t>(((opcode >> 4) & 0x03) * 2);
+                pop16([&] { storeReg(hi + 1); }, [&] { storeReg(hi); });
+                break;
+            }
+            case 0xF1: // POP PSW
+                pop16([&] {
+                          emit.ri(EXT_AND, RAX, PSW_VALID_BITS);
+                          emit.ri(EXT_OR, RAX, PSW_FIXED_ONES);
+                          emit.store8(RAX, OFF_PSW);
+                      },
+                      [&] { storeReg(REG_A); });
+                break;
+            default:
+                // No native translation (DAA, rotates, SHLD, XTHL, EI, ...).
+                emitInterpret(opcode, operand, next_pc);
+                break;
+        }
+    }
+
+    // Translates the branch (or HLT) that ends a block.
+    void emitBranch(uint8_t opcode, uint16_t operand, uint16_t next_pc)
+    {
+        auto popPc = [&] {
+            pop16([&] { emit.store8(RAX, OFF_PC); }, [&] { emit.store8(RAX, OFF_PC + 1); });
+        };
+
+        switch (opcode)
+        {
+            case 0xC3: exitTo(operand); return;                  // JMP
+            case 0xCD: pushImm(next_pc); exitTo(operand); return; // CALL
+            case 0xC9: popPc(); exitDynamic(); return;           // RET
+            case 0xE9:                                            // PCHL
+                emit.store16(HOST_HL, OFF_PC);
+                exitDynamic();
+                return;
+            case 0x76:                                            // HLT
+                // runJit() idles out the batch once state.halted is set.
+                emit.movImm(RAX, 1);
+                emit.store8(RAX, OFF_HALTED);
+                emit.movImm(RAX, next_pc);
+                emit.store16(RAX, OFF_PC);
+                exitDynamic();
+                return;
+            default: break;
+        }
+
+        switch (opcode & 0x07)
+        {
+            case 0x00: // Rcc
+            {
+                size_t skip = emit.jcc(testCondition(opcode) ^ 1);
+                emit.subBudget(takenExtra(opcode));
+                popPc();
+                exitDynamic();
+                emit.patch(skip, emit.pos());
+                exitTo(next_pc);
+                return;
+            }
+            case 0x02: // Jcc
+                exitIf(testCondition(opcode), operand);
+                exitTo(next_pc);
+                return;
+            case 0x04: // Ccc
+            {
+                size_t skip = emit.jcc(testCondition(opcode) ^ 1);
+                emit.subBudget(takenExtra(opcode));
+                pushImm(next_pc);
+                exitTo(operand);
+                emit.patch(skip, emit.pos());
+                exitTo(next_pc);
+                return;
+            }
+            default: // RST
+                pushImm(next_pc);
+                exitTo(opcode & 0x38);
+                return;
+        }
+    }
+
+    // Compiles the block at start into blocks[start].
+    void compile(uint16_t start)
+    {
+        if (emit.space() < MAX_BLOCK_BYTES)
+        {
+            flush();
+        }
+
+        struct Insn
+        {
+            uint8_t opcode;
+            uint16_t operand;
+            uint16_t next_pc;
+        };
+        std::vector<Insn> insns;
+        bool branch = false;
+        uint16_t pc = start;
+        while (insns.size() < MAX_BLOCK_OPS)
+        {
+            uint8_t opcode = cpu->memory.ReadByte(pc);
+            const OpcodeInfo& info = OPCODE_TABLE[opcode];
+            // Operands in RAM may change, and I/O goes through the dispatcher.
+            if (pc + info.length > BLOCK_CACHE_END || opcode == 0xD3 || opcode == 0xDB)
+            {
+                break;
+            }
+            uint16_t operand = 0;
+            if (info.length == 2) { operand = cpu->memory.ReadByte(pc + 1); }
+            if (info.length == 3) { operand = cpu->memory.ReadWord(pc + 1); }
+            pc += info.length;
+            insns.push_back({opcode, operand, pc});
+            if (info.ends_block)
+            {
+                branch = true;
+                break;
+            }
+        }
+
+        Block& block = blocks[start];
+        block.compiled = true;
+        if (insns.empty())
+        {
+            return;
+        }
+
+        // The whole block runs only if the table loop would still start
+        // its last instruction, and is charged its base cycles up front.
+        uint32_t cycles = 0;
+        uint32_t lead_cycles = 0;
+        for (const Insn& insn : insns)
+        {
+            lead_cycles = cycles;
+            cycles += OPCODE_TABLE[insn.opcode].cycles;
+        }
+
+        exits.clear();
+        size_t entry = emit.pos();
+        emit.cmpBudget(lead_cycles + 1);
+        size_t bail = emit.jcc(CC_L);
+        emit.subBudget(cycles);
+
+        size_t body = branch ? insns.size() - 1 : insns.size();
+        for (size_t i = 0; i < body; ++i)
+        {
+            emitOp(insns[i].opcode, insns[i].operand, insns[i].next_pc);
+        }
+        if (branch)
+        {
+            emitBranch(insns.back().opcode, insns.back().operand, insns.back().next_pc);
+        }
+        else
+        {
+            exitTo(pc);
+        }
+
+        emit.patch(bail, emitStub(start));
+        block.code = emit.at(entry);
+        block.lead_cycles = static_cast<uint16_t>(lead_cycles);
+
+        // Chain to compiled targets, leave a stub for the others. Jumps
+        // back to an idle loop head go through runJit() so it can skip
+        // the spin.
+        for (const Exit& exit : exits)
+        {
+            if (exit.target == start && cpu->idleLoopHead(start))
+            {
+                emit.patch(exit.site, emitStub(exit.target));
+            }
+            else if (exit.target < BLOCK_CACHE_END && blocks[exit.target].code != nullptr)
+            {
+                emit.patch(exit.site, blocks[exit.target].code - arena);
+            }
+            else
+            {
+                emit.patch(exit.site, emitStub(exit.target));
+                if (exit.target < BLOCK_CACHE_END)
+                {
+                    links[exit.target].push_back(exit.site);
+                }
+            }
+        }
+
+        // Earlier blocks that exit to this one now jump straight in.
+        for (size_t site : links[start])
+        {
+            emit.patch(site, entry);
+        }
+        links[start].clear();
+    }
+
+    // The compiled block at pc, or null if it must be interpreted.
+    const Block* lookup(uint16_t pc)
+    {
+        if (!blocks[pc].compiled)
+        {
+            compile(pc);
+        }
+        return (blocks[pc].code != nullptr) ? &blocks[pc] : nullptr;
+    }
+};
+
+/***************** Global Class Functions. ***********************/
+
+bool Emulator::jitInit()
+{
+    if (jit.cache == nullptr)
+    {
+        std::unique_ptr<JitCache, JitCacheDeleter> cache(new JitCache());
+        if (!cache->init(this))
+        {
+            return false;
+        }
+        jit.cache = std::move(cache);
+    }
+    return true;
+}
+
+int Emulator::runJit(int cycles)
+{
+    // A copied Emulator starts without native code; the host already
+    // accepted the JIT once, so this only fails if mmap does.
+    if (!jitInit())
+    {
+        backend = CpuBackend::Interpreter;
+        return runTable(cycles);
+    }
+
+    JitCache& cache = *jit.cache;
+    return runBlockBatch(
+        cycles,
+        [this, &cache] {
+            if (cache.generation != memory.GetRomGeneration())
+            {
+                cache.flush();
+            }
+        },
+        [&cache](uint16_t pc) { return cache.lookup(pc); },
+        [this, &cache](const JitCache::Block& block, int remaining) {
+            // Native code keeps state.flags current, nothing may be pending.
+            alu_resolve(state.flags, lazy_flags);
+            return remaining - cache.enter(&state, remaining, block.code);
+        });
+}
+
+#else // !JIT_X64
+
+struct Emulator::JitCache
+{
+};
+
+bool Emulator::jitInit()
+{
+    return false;
+}
+
+int Emulator::runJit(int)
+{
+    // Unreachable: setCpuBackend() refuses CpuBackend::Jit on this host.
+    return 0;
+}
+
+#endif // JIT_X64
+
+void Emulator::JitCacheDeleter::operator()(JitCache* cache) const
+{
+    delete cache;
+}
@@ -58,18 +58,18 @@ int main (int argc, char * argv[])
     std::cout << "Initial State:" << std::endl;
     printCPUState(emulator.getCPUState());
 
-    // Emulate 3 instructions
-    std::cout << "\nEmulating 3 cycles (3 NOP instructions)..." << std::endl;
-    emulator.emulateCycles(3);
+    // Emulate 3 instructions (NOP takes 4 cycles)
+    std::cout << "\nEmulating 12 cycles (3 NOP instructions)..." << std::endl;
+    emulator.emulateCycles(12);
 
-    std::cout << "\nState after 3 cycles:" << std::endl;
+    std::cout << "\nState after 12 cycles:" << std::endl;
     printCPUState(emulator.getCPUState());
 
     // Emulate 2 more instructions
-    std::cout << "\nEmulating 2 more cycles (2 NOP instructions)..." << std::endl;
-    emulator.emulateCycles(2);
+    std::cout << "\nEmulating 8 more cycles (2 NOP instructions)..." << std::endl;
+    emulator.emulateCycles(8);
 
-    std::cout << "\nState after 5 cycles:" << std::endl;
+    std::cout << "\nState after 20 cycles:" << std::endl;
     printCPUState(emulator.getCPUState());
 
     std::cout << "\nTest complete. PC should be 5." << std::endl;
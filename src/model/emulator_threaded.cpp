@@ -0,0 +1,386 @@
+/**********************************************************
+ * @file emulator_threaded.cpp
+ *
+ * @brief Computed-goto (threaded) interpreter backend.
+ *        Keeps the registers, flags, PC and SP in local variables
+ *        for a whole emulateCycles() batch and jumps directly from
+ *        one opcode body to the next through a label table.
+ *        Each opcode is charged its OPCODE_TABLE cycles on dispatch,
+ *        taken conditional CALL/RET pay the difference on top.
+ *        Requires the GCC/Clang "labels as values" extension.
+ *
+ * @author Jese/Arnav (CPU Core)
+ *
+ *********************************************************/
+
+/***************** Include files. ***********************/
+#include "emulator.hpp"
+#include "alu.hpp"
+#include "memory.hpp"
+
+/***************** Macros and defines. ***********************/
+#if defined(__GNUC__)
+
+// Operand fetch, relative to the opcode at pc.
+#define IMM8()  mem.ReadByte(pc + 1)
+#define IMM16() mem.ReadWord(pc + 1)
+
+// Register pair helpers.
+#define PAIR(hi, lo) static_cast<uint16_t>(((hi) << 8) | (lo))
+#define SET_PAIR(hi, lo, val) do { uint16_t v_ = (val); hi = v_ >> 8; lo = v_ & 0xFF; } while (0)
+
+// Stack helpers.
+#define PUSH16(val) do { uint16_t v_ = (val); sp -= 2; mem.WriteWord(sp, v_); } while (0)
+#define POP16(dst)  do { dst = mem.ReadWord(sp); sp += 2; } while (0)
+
+// Moves the locals to/from CPUState. Pending flags are resolved first.
+#define SAVE_STATE() do { alu_resolve(f, lz); state.a = a; state.b = b; state.c = c; state.d = d; state.e = e; \
+                          state.h = h; state.l = l; state.sp = sp; state.pc = pc; state.flags = f; } while (0)
+#define LOAD_STATE() do { a = state.a; b = state.b; c = state.c; d = state.d; e = state.e; \
+                          h = state.h; l = state.l; sp = state.sp; pc = state.pc; f = state.flags; \
+                          lz = LazyFlags{}; } while (0)
+
+// PSW mask test for conditional branches (Z/S/P may still be pending).
+#define TEST(mask) alu_test(f, lz, mask)
+
+// Same stop conditions and cycle charges as the table interpreter loop.
+#define NEXT() do { if (remaining <= 0 || pc >= 0xFFFF) goto batch_exit; \
+                    uint8_t op_ = mem.ReadByte(pc); remaining -= OPCODE_TABLE[op_].cycles; \
+                    goto *LABELS[op_]; } while (0)
+#define TAKEN(op) (remaining -= OPCODE_TABLE[op].cycles_taken - OPCODE_TABLE[op].cycles)
+#define STEP(len) do { pc += (len); NEXT(); } while (0)
+
+// Jump to target; a jump back to an idle loop head skips the spin.
+// skipIdleLoop() may stop mid-iteration with flags pending in lazy_flags,
+// which LOAD_STATE() would drop, so they are resolved first.
+#define JUMP(target) do { uint16_t t_ = (target); bool back_ = t_ <= pc; pc = t_;            \
+                          if (back_ && remaining > 0 && idleLoopHead(pc)) {                \
+                              SAVE_STATE(); remaining -= skipIdleLoop(remaining);           \
+                              alu_resolve(state.flags, lazy_flags); LOAD_STATE(); }         \
+                          NEXT(); } while (0)
+
+// Opcode body generators.
+#define MOV_RR(op, dst, src) L_##op: dst = src; STEP(1);
+#define MOV_RM(op, dst)      L_##op: dst = mem.ReadByte(PAIR(h, l)); STEP(1);
+#define MOV_MR(op, src)      L_##op: mem.WriteByte(PAIR(h, l), src); STEP(1);
+#define ALU(op, expr)        L_##op: expr; STEP(1);
+#define RET_IF(op, cond)     L_##op: if (cond) { TAKEN(0x##op); POP16(pc); NEXT(); } STEP(1);
+#define JMP_IF(op, cond)     L_##op: if (cond) { JUMP(IMM16()); } STEP(3);
+#define CALL_IF(op, cond)    L_##op: if (cond) { TAKEN(0x##op); uint16_t t_ = IMM16(); PUSH16(pc + 3); pc = t_; NEXT(); } STEP(3);
+#define RST(op)              L_##op: PUSH16(pc + 1); pc = 0x##op & 0x38; NEXT();
+
+#endif // __GNUC__
+
+/***************** Global Class Functions. ***********************/
+
+bool Emulator::threadedBackendAvailable()
+{
+#if defined(__GNUC__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+int Emulator::runThreaded(int cycles)
+{
+#if defined(__GNUC__)
+    static void* const LABELS[256] = {
+        &&L_00, &&L_01, &&L_02, &&L_03, &&L_04, &&L_05, &&L_06, &&L_07, // 00-07
+        &&L_XX, &&L_09, &&L_0A, &&L_0B, &&L_0C, &&L_0D, &&L_0E, &&L_0F, // 08-0F
+        &&L_XX, &&L_11, &&L_12, &&L_13, &&L_14, &&L_15, &&L_16, &&L_XX, // 10-17
+        &&L_XX, &&L_19, &&L_1A, &&L_1B, &&L_1C, &&L_1D, &&L_1E, &&L_1F, // 18-1F
+        &&L_XX, &&L_21, &&L_22, &&L_23, &&L_24, &&L_25, &&L_26, &&L_27, // 20-27
+        &&L_XX, &&L_29, &&L_2A, &&L_2B, &&L_2C, &&L_2D, &&L_2E, &&L_2F, // 28-2F
+        &&L_XX, &&L_31, &&L_32, &&L_XX, &&L_34, &&L_35, &&L_36, &&L_37, // 30-37
+        &&L_XX, &&L_39, &&L_3A, &&L_XX, &&L_3C, &&L_3D, &&L_3E, &&L_3F, // 38-3F
+        &&L_40, &&L_41, &&L_42, &&L_43, &&L_44, &&L_45, &&L_46, &&L_47, // 40-47
+        &&L_48, &&L_49, &&L_4A, &&L_4B, &&L_4C, &&L_4D, &&L_4E, &&L_4F, // 48-4F
+        &&L_50, &&L_51, &&L_52, &&L_53, &&L_54, &&L_55, &&L_56, &&L_57, // 50-57
+        &&L_58, &&L_59, &&L_5A, &&L_5B, &&L_5C, &&L_5D, &&L_5E, &&L_5F, // 58-5F
+        &&L_60, &&L_61, &&L_62, &&L_63, &&L_64, &&L_65, &&L_66, &&L_67, // 60-67
+        &&L_68, &&L_69, &&L_6A, &&L_6B, &&L_6C, &&L_6D, &&L_6E, &&L_6F, // 68-6F
+        &&L_70, &&L_71, &&L_72, &&L_73, &&L_74, &&L_75, &&L_76, &&L_77, // 70-77
+        &&L_78, &&L_79, &&L_7A, &&L_7B, &&L_7C, &&L_7D, &&L_7E, &&L_7F, // 78-7F
+        &&L_80, &&L_81, &&L_82, &&L_83, &&L_84, &&L_85, &&L_86, &&L_87, // 80-87
+        &&L_88, &&L_89, &&L_8A, &&L_8B, &&L_8C, &&L_8D, &&L_8E, &&L_8F, // 88-8F
+        &&L_90, &&L_91, &&L_92, &&L_93, &&L_94, &&L_95, &&L_96, &&L_97, // 90-97
+        &&L_98, &&L_99, &&L_9A, &&L_9B, &&L_9C, &&L_9D, &&L_9E, &&L_9F, // 98-9F
+        &&L_A0, &&L_A1, &&L_A2, &&L_A3, &&L_A4, &&L_A5, &&L_A6, &&L_A7, // A0-A7
+        &&L_A8, &&L_A9, &&L_AA, &&L_AB, &&L_AC, &&L_AD, &&L_AE, &&L_AF, // A8-AF
+        &&L_B0, &&L_B1, &&L_B2, &&L_B3, &&L_B4, &&L_B5, &&L_B6, &&L_B7, // B0-B7
+        &&L_B8, &&L_B9, &&L_BA, &&L_BB, &&L_BC, &&L_BD, &&L_BE, &&L_BF, // B8-BF
+        &&L_C0, &&L_C1, &&L_C2, &&L_C3, &&L_C4, &&L_C5, &&L_C6, &&L_C7, // C0-C7
+        &&L_C8, &&L_C9, &&L_CA, &&L_XX, &&L_CC, &&L_CD, &&L_CE, &&L_CF, // C8-CF
+        &&L_D0, &&L_D1, &&L_D2, &&L_D3, &&L_D4, &&L_D5, &&L_D6, &&L_D7, // D0-D7
+        &&L_D8, &&L_XX, &&L_DA, &&L_DB, &&L_DC, &&L_XX, &&L_DE, &&L_DF, // D8-DF
+        &&L_E0, &&L_E1, &&L_E2, &&L_E3, &&L_E4, &&L_E5, &&L_E6, &&L_E7, // E0-E7
+        &&L_E8, &&L_E9, &&L_EA, &&L_EB, &&L_EC, &&L_XX, &&L_EE, &&L_EF, // E8-EF
+        &&L_F0, &&L_F1, &&L_F2, &&L_XX, &&L_F4, &&L_F5, &&L_F6, &&L_F7, // F0-F7
+        &&L_F8, &&L_F9, &&L_FA, &&L_FB, &&L_FC, &&L_XX, &&L_FE, &&L_FF, // F8-FF
+    };
+
+    uint8_t a, b, c, d, e, h, l;
+    uint16_t sp, pc;
+    CpuFlags f;
+    LazyFlags lz;
+    LOAD_STATE();
+
+    Memory& mem = memory;
+    int remaining = cycles;
+
+    NEXT();
+
+    // Data Transfer Group
+    L_01: SET_PAIR(b, c, IMM16()); STEP(3);                     // LXI B
+    L_02: mem.WriteByte(PAIR(b, c), a); STEP(1);                // STAX B
+    L_06: b = IMM8(); STEP(2);                                  // MVI B
+    L_0A: a = mem.ReadByte(PAIR(b, c)); STEP(1);                // LDAX B
+    L_0E: c = IMM8(); STEP(2);                                  // MVI C
+    L_11: SET_PAIR(d, e, IMM16()); STEP(3);                     // LXI D
+    L_12: mem.WriteByte(PAIR(d, e), a); STEP(1);                // STAX D
+    L_16: d = IMM8(); STEP(2);                                  // MVI D
+    L_1A: a = mem.ReadByte(PAIR(d, e)); STEP(1);                // LDAX D
+    L_1E: e = IMM8(); STEP(2);                                  // MVI E
+    L_21: SET_PAIR(h, l, IMM16()); STEP(3);                     // LXI H
+    L_22: mem.WriteWord(IMM16(), PAIR(h, l)); STEP(3);          // SHLD
+    L_26: h = IMM8(); STEP(2);                                  // MVI H
+    L_2A: SET_PAIR(h, l, mem.ReadWord(IMM16())); STEP(3);       // LHLD
+    L_2E: l = IMM8(); STEP(2);                                  // MVI L
+    L_31: sp = IMM16(); STEP(3);                                // LXI SP
+    L_32: mem.WriteByte(IMM16(), a); STEP(3);                   // STA
+    L_36: mem.WriteByte(PAIR(h, l), IMM8()); STEP(2);           // MVI M
+    L_3A: a = mem.ReadByte(IMM16()); STEP(3);                   // LDA
+    L_3E: a = IMM8(); STEP(2);                                  // MVI A
+    L_EB: { uint8_t t = h; h = d; d = t; t = l; l = e; e = t; } STEP(1); // XCHG
+
+    // MOV dst,src (0x76 is HLT)
+    MOV_RR(40, b, b)
+    MOV_RR(41, b, c)
+    MOV_RR(42, b, d)
+    MOV_RR(43, b, e)
+    MOV_RR(44, b, h)
+    MOV_RR(45, b, l)
+    MOV_RM(46, b)
+    MOV_RR(47, b, a)
+    MOV_RR(48, c, b)
+    MOV_RR(49, c, c)
+    MOV_RR(4A, c, d)
+    MOV_RR(4B, c, e)
+    MOV_RR(4C, c, h)
+    MOV_RR(4D, c, l)
+    MOV_RM(4E, c)
+    MOV_RR(4F, c, a)
+    MOV_RR(50, d, b)
+    MOV_RR(51, d, c)
+    MOV_RR(52, d, d)
+    MOV_RR(53, d, e)
+    MOV_RR(54, d, h)
+    MOV_RR(55, d, l)
+    MOV_RM(56, d)
+    MOV_RR(57, d, a)
+    MOV_RR(58, e, b)
+    MOV_RR(59, e, c)
+    MOV_RR(5A, e, d)
+    MOV_RR(5B, e, e)
+    MOV_RR(5C, e, h)
+    MOV_RR(5D, e, l)
+    MOV_RM(5E, e)
+    MOV_RR(5F, e, a)
+    MOV_RR(60, h, b)
+    MOV_RR(61, h, c)
+    MOV_RR(62, h, d)
+    MOV_RR(63, h, e)
+    MOV_RR(64, h, h)
+    MOV_RR(65, h, l)
+    MOV_RM(66, h)
+    MOV_RR(67, h, a)
+    MOV_RR(68, l, b)
+    MOV_RR(69, l, c)
+    MOV_RR(6A, l, d)
+    MOV_RR(6B, l, e)
+    MOV_RR(6C, l, h)
+    MOV_RR(6D, l, l)
+    MOV_RM(6E, l)
+    MOV_RR(6F, l, a)
+    MOV_MR(70, b)
+    MOV_MR(71, c)
+    MOV_MR(72, d)
+    MOV_MR(73, e)
+    MOV_MR(74, h)
+    MOV_MR(75, l)
+    MOV_MR(77, a)
+    MOV_RR(78, a, b)
+    MOV_RR(79, a, c)
+    MOV_RR(7A, a, d)
+    MOV_RR(7B, a, e)
+    MOV_RR(7C, a, h)
+    MOV_RR(7D, a, l)
+    MOV_RM(7E, a)
+    MOV_RR(7F, a, a)
+
+    // Arithmetic Group
+    L_03: SET_PAIR(b, c, PAIR(b, c) + 1); STEP(1);              // INX B
+    L_04: b = alu_inr(lz, b); STEP(1);                           // INR B
+    L_05: b = alu_dcr(lz, b); STEP(1);                           // DCR B
+    L_09: SET_PAIR(h, l, alu_dad(f, PAIR(h, l), PAIR(b, c))); STEP(1); // DAD B
+    L_0B: SET_PAIR(b, c, PAIR(b, c) - 1); STEP(1);              // DCX B
+    L_0C: c = alu_inr(lz, c); STEP(1);                           // INR C
+    L_0D: c = alu_dcr(lz, c); STEP(1);                           // DCR C
+    L_13: SET_PAIR(d, e, PAIR(d, e) + 1); STEP(1);              // INX D
+    L_14: d = alu_inr(lz, d); STEP(1);                           // INR D
+    L_15: d = alu_dcr(lz, d); STEP(1);                           // DCR D
+    L_19: SET_PAIR(h, l, alu_dad(f, PAIR(h, l), PAIR(d, e))); STEP(1); // DAD D
+    L_1B: SET_PAIR(d, e, PAIR(d, e) - 1); STEP(1);              // DCX D
+    L_1C: e = alu_inr(lz, e); STEP(1);                           // INR E
+    L_1D: e = alu_dcr(lz, e); STEP(1);                           // DCR E
+    L_23: SET_PAIR(h, l, PAIR(h, l) + 1); STEP(1);              // INX H
+    L_24: h = alu_inr(lz, h); STEP(1);                           // INR H
+    L_25: h = alu_dcr(lz, h); STEP(1);                           // DCR H
+    L_27: alu_daa(a, f, lz); STEP(1);                               // DAA
+    L_29: SET_PAIR(h, l, alu_dad(f, PAIR(h, l), PAIR(h, l))); STEP(1); // DAD H
+    L_2B: SET_PAIR(h, l, PAIR(h, l) - 1); STEP(1);              // DCX H
+    L_2C: l = alu_inr(lz, l); STEP(1);                           // INR L
+    L_2D: l = alu_dcr(lz, l); STEP(1);                           // DCR L
+    L_34: { uint16_t addr = PAIR(h, l);                         // INR M
+            mem.WriteByte(addr, alu_inr(lz, mem.ReadByte(addr))); } STEP(1);
+    L_35: { uint16_t addr = PAIR(h, l);                         // DCR M
+            mem.WriteByte(addr, alu_dcr(lz, mem.ReadByte(addr))); } STEP(1);
+    L_39: SET_PAIR(h, l, alu_dad(f, PAIR(h, l), sp)); STEP(1);  // DAD SP
+    L_3C: a = alu_inr(lz, a); STEP(1);                           // INR A
+    L_3D: a = alu_dcr(lz, a); STEP(1);                           // DCR A
+    L_C6: alu_add(a, f, lz, IMM8(), 0); STEP(2);                    // ADI
+    L_CE: alu_add(a, f, lz, IMM8(), f.cy); STEP(2);                 // ACI
+    L_D6: alu_sub(a, f, lz, IMM8(), 0); STEP(2);                    // SUI
+    L_DE: alu_sub(a, f, lz, IMM8(), f.cy); STEP(2);                 // SBI
+
+    // ALU A,r / A,M
+    ALU(80, alu_add(a, f, lz, b, 0))
+    ALU(81, alu_add(a, f, lz, c, 0))
+    ALU(82, alu_add(a, f, lz, d, 0))
+    ALU(83, alu_add(a, f, lz, e, 0))
+    ALU(84, alu_add(a, f, lz, h, 0))
+    ALU(85, alu_add(a, f, lz, l, 0))
+    ALU(86, alu_add(a, f, lz, mem.ReadByte(PAIR(h, l)), 0))
+    ALU(87, alu_add(a, f, lz, a, 0))
+    ALU(88, alu_add(a, f, lz, b, f.cy))
+    ALU(89, alu_add(a, f, lz, c, f.cy))
+    ALU(8A, alu_add(a, f, lz, d, f.cy))
+    ALU(8B, alu_add(a, f, lz, e, f.cy))
+    ALU(8C, alu_add(a, f, lz, h, f.cy))
+    ALU(8D, alu_add(a, f, lz, l, f.cy))
+    ALU(8E, alu_add(a, f, lz, mem.ReadByte(PAIR(h, l)), f.cy))
+    ALU(8F, alu_add(a, f, lz, a, f.cy))
+    ALU(90, alu_sub(a, f, lz, b, 0))
+    ALU(91, alu_sub(a, f, lz, c, 0))
+    ALU(92, alu_sub(a, f, lz, d, 0))
+    ALU(93, alu_sub(a, f, lz, e, 0))
+    ALU(94, alu_sub(a, f, lz, h, 0))
+    ALU(95, alu_sub(a, f, lz, l, 0))
+    ALU(96, alu_sub(a, f, lz, mem.ReadByte(PAIR(h, l)), 0))
+    ALU(97, alu_sub(a, f, lz, a, 0))
+    ALU(98, alu_sub(a, f, lz, b, f.cy))
+    ALU(99, alu_sub(a, f, lz, c, f.cy))
+    ALU(9A, alu_sub(a, f, lz, d, f.cy))
+    ALU(9B, alu_sub(a, f, lz, e, f.cy))
+    ALU(9C, alu_sub(a, f, lz, h, f.cy))
+    ALU(9D, alu_sub(a, f, lz, l, f.cy))
+    ALU(9E, alu_sub(a, f, lz, mem.ReadByte(PAIR(h, l)), f.cy))
+    ALU(9F, alu_sub(a, f, lz, a, f.cy))
+    ALU(A0, alu_ana(a, f, lz, b))
+    ALU(A1, alu_ana(a, f, lz, c))
+    ALU(A2, alu_ana(a, f, lz, d))
+    ALU(A3, alu_ana(a, f, lz, e))
+    ALU(A4, alu_ana(a, f, lz, h))
+    ALU(A5, alu_ana(a, f, lz, l))
+    ALU(A6, alu_ana(a, f, lz, mem.ReadByte(PAIR(h, l))))
+    ALU(A7, alu_ana(a, f, lz, a))
+    ALU(A8, alu_xra(a, f, lz, b))
+    ALU(A9, alu_xra(a, f, lz, c))
+    ALU(AA, alu_xra(a, f, lz, d))
+    ALU(AB, alu_xra(a, f, lz, e))
+    ALU(AC, alu_xra(a, f, lz, h))
+    ALU(AD, alu_xra(a, f, lz, l))
+    ALU(AE, alu_xra(a, f, lz, mem.ReadByte(PAIR(h, l))))
+    ALU(AF, alu_xra(a, f, lz, a))
+    ALU(B0, alu_ora(a, f, lz, b))
+    ALU(B1, alu_ora(a, f, lz, c))
+    ALU(B2, alu_ora(a, f, lz, d))
+    ALU(B3, alu_ora(a, f, lz, e))
+    ALU(B4, alu_ora(a, f, lz, h))
+    ALU(B5, alu_ora(a, f, lz, l))
+    ALU(B6, alu_ora(a, f, lz, mem.ReadByte(PAIR(h, l))))
+    ALU(B7, alu_ora(a, f, lz, a))
+    ALU(B8, alu_cmp(a, f, lz, b))
+    ALU(B9, alu_cmp(a, f, lz, c))
+    ALU(BA, alu_cmp(a, f, lz, d))
+    ALU(BB, alu_cmp(a, f, lz, e))
+    ALU(BC, alu_cmp(a, f, lz, h))
+    ALU(BD, alu_cmp(a, f, lz, l))
+    ALU(BE, alu_cmp(a, f, lz, mem.ReadByte(PAIR(h, l))))
+    ALU(BF, alu_cmp(a, f, lz, a))
+
+    // Logical Group
+    L_07: alu_rlc(a, f); STEP(1);                               // RLC
+    L_0F: alu_rrc(a, f); STEP(1);                               // RRC
+    L_1F: alu_rar(a, f); STEP(1);                               // RAR
+    L_2F: a = ~a; STEP(1);                                      // CMA
+    L_37: f.cy = true; STEP(1);                                 // STC
+    L_3F: f.cy = !f.cy; STEP(1);                                // CMC
+    L_E6: alu_ana(a, f, lz, IMM8()); STEP(2);                       // ANI
+    L_EE: alu_xra(a, f, lz, IMM8()); STEP(2);                       // XRI
+    L_F6: alu_ora(a, f, lz, IMM8()); STEP(2);                       // ORI
+    L_FE: alu_cmp(a, f, lz, IMM8()); STEP(2);                       // CPI
+
+    // Branch Group
+    L_C3: JUMP(IMM16());                                        // JMP
+    L_C9: POP16(pc); NEXT();                                    // RET
+    L_CD: { uint16_t target = IMM16();                          // CALL
+            PUSH16(pc + 3); pc = target; } NEXT();
+    L_E9: pc = PAIR(h, l); NEXT();                              // PCHL
+
+    RET_IF(C0, !TEST(FLAG_Z))  RET_IF(C8, TEST(FLAG_Z))  RET_IF(D0, !f.cy)  RET_IF(D8, f.cy)
+    RET_IF(E0, !TEST(FLAG_P))  RET_IF(E8, TEST(FLAG_P))  RET_IF(F0, !TEST(FLAG_S))  RET_IF(F8, TEST(FLAG_S))
+    JMP_IF(C2, !TEST(FLAG_Z))  JMP_IF(CA, TEST(FLAG_Z))  JMP_IF(D2, !f.cy)  JMP_IF(DA, f.cy)
+    JMP_IF(E2, !TEST(FLAG_P))  JMP_IF(EA, TEST(FLAG_P))  JMP_IF(F2, !TEST(FLAG_S))  JMP_IF(FA, TEST(FLAG_S))
+    CALL_IF(C4, !TEST(FLAG_Z)) CALL_IF(CC, TEST(FLAG_Z)) CALL_IF(D4, !f.cy) CALL_IF(DC, f.cy)
+    CALL_IF(E4, !TEST(FLAG_P)) CALL_IF(EC, TEST(FLAG_P)) CALL_IF(F4, !TEST(FLAG_S)) CALL_IF(FC, TEST(FLAG_S))
+    RST(C7) RST(CF) RST(D7) RST(DF) RST(E7) RST(EF) RST(F7) RST(FF)
+
+    // Stack, I/O, and Machine Control Group
+    L_00: STEP(1);                                              // NOP
+    L_76: pc += 1; state.halted = true; goto batch_exit;        // HLT
+    L_C1: { uint16_t bc; POP16(bc); SET_PAIR(b, c, bc); } STEP(1); // POP B
+    L_C5: PUSH16(PAIR(b, c)); STEP(1);                          // PUSH B
+    L_D1: { uint16_t de; POP16(de); SET_PAIR(d, e, de); } STEP(1); // POP D
+    L_D5: PUSH16(PAIR(d, e)); STEP(1);                          // PUSH D
+    L_E1: { uint16_t hl; POP16(hl); SET_PAIR(h, l, hl); } STEP(1); // POP H
+    L_E3: { uint16_t top = mem.ReadWord(sp);                    // XTHL
+            mem.WriteWord(sp, PAIR(h, l));
+            SET_PAIR(h, l, top); } STEP(1);
+    L_E5: PUSH16(PAIR(h, l)); STEP(1);                          // PUSH H
+    L_F1: { uint16_t psw; POP16(psw);                               // POP PSW
+            alu_unpack_psw(f, lz, psw & 0xFF); a = psw >> 8; } STEP(1);
+    L_F5: PUSH16(PAIR(a, alu_pack_psw(f, lz))); STEP(1);            // PUSH PSW
+    L_F9: sp = PAIR(h, l); STEP(1);                             // SPHL
+    L_FB: state.interrupts_enabled = true; STEP(1);             // EI
+
+    // I/O goes through CPUState, so the locals are written back first.
+    L_DB: SAVE_STATE();                                         // IN
+          a = io_read(static_cast<InPortNum>(IMM8())); STEP(2);
+    L_D3: SAVE_STATE();                                         // OUT
+          io_write(static_cast<OutPortNum>(IMM8()), a); STEP(2);
+
+    L_XX: { uint8_t opcode = mem.ReadByte(pc);
+            pc += 1;
+            SAVE_STATE();
+            op_UNIMPLEMENTED(opcode, 0); } NEXT();
+
+batch_exit:
+    SAVE_STATE();
+    return cycles - remaining;
+#else
+    (void)cycles;
+    return 0;
+#endif // __GNUC__
+}
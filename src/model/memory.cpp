@@ -9,6 +9,9 @@
 // Video RAM: 0x2400 – 0x3FFF | Video RAM for QT
 // Expansion / Stack:0x4000 – 0xFFFF | Emulation Core and I/O
 //
+// Accesses go through a table of 256-byte pages: plain pages are one
+// indexed load/store, flagged pages (watched, tracked) take a slow path.
+//
 //Provides memory access for: RAM/ROM access, VRAM, Debugging
 // Author: Fredo | Date: 7/19/25
 // ============================================================
@@ -19,56 +22,330 @@
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+// ================= Shared ROM Registry ======================
+// Process-wide images by hash | Weak: an image lives as long as an instance uses it
+namespace {
+struct RomRegistry {
+    std::mutex mutex;
+    std::unordered_map<uint64_t, std::weak_ptr<const Memory::RomImage>> images;
+};
+
+// Built on first use, so a Memory constructed during static init finds it ready
+RomRegistry& Registry() {
+    static RomRegistry registry;
+    return registry;
+}
+
+// FNV-1a over the 8KB image
+uint64_t HashRom(const uint8_t* data, size_t size) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+// All-zero image used after construction and Clear() | Never freed, never hashed again
+const Memory::SharedRom& ZeroRom() {
+    static const Memory::SharedRom zero = [] {
+        std::array<uint8_t, Memory::RAM_START> bytes{};
+        return Memory::InternRom(bytes.data());
+    }();
+    return zero;
+}
+} // namespace
+
 
 // ================= Constructor ============================ 
 //Initalize and clear the memory on startup
-Memory::Memory() {
-    mem.fill(0x00);  
+Memory::Memory(Layout initialLayout) : rom(ZeroRom()) {
+    ApplyLayout(initialLayout);
+    MarkAllRowsDirty();
 // ---DEBUG MODE ---
-// Initialize debug tracking counters and snapshot
+// Count every access from the start
 // Used with the Romloader to Memory Process
 #ifdef ENABLE_MEMORY_DEBUG
-    snapshot.clear();
-    readCounts.clear();
-    writeCounts.clear();
-    watchpoints.clear();
+    SetAccessPolicy(AccessPolicy::Counting);
     std::cout << "[Debug] Memory fully cleared.\n";
 #endif // --- END DEBUG ---
 }
 
-// Created to zero memory | Will also clear debug counters
+// === Copy === Page pointers must point into this copy, not the original
+Memory::Memory(const Memory& other) {
+    *this = other;
+}
+
+Memory& Memory::operator=(const Memory& other) {
+    if (this == &other) {
+        return *this;
+    }
+    layout = other.layout;
+    addressMask = other.addressMask;
+    pageMask = other.pageMask;
+    ram = other.ram;
+    ownRom = other.ownRom ? std::make_shared<RomImage>(*other.ownRom) : nullptr;
+    rom = ownRom ? SharedRom(ownRom) : other.rom;
+    romGeneration = other.romGeneration;
+    vramDirty = other.vramDirty;
+    accessPolicy = other.accessPolicy;
+    readSlow = other.readSlow;
+    writeSlow = other.writeSlow;
+    readCounts = other.readCounts ? std::make_unique<AccessCounts>(*other.readCounts) : nullptr;
+    writeCounts = other.writeCounts ? std::make_unique<AccessCounts>(*other.writeCounts) : nullptr;
+    watchedLines = other.watchedLines;
+    watchReads = other.watchReads;
+    watchWrites = other.watchWrites;
+    watchCallback = other.watchCallback;
+    cow = other.cow;
+    BuildPageTable();
+    for (uint32_t page = 0; page < PAGE_COUNT; ++page) {
+        pages[page].flags = other.pages[page].flags;
+    }
+    return *this;
+}
+
+// Created to zero memory | Will also clear access counters and drop the snapshot
+// The ROM goes back to the shared all-zero image
 // Used with CPU process
 void Memory::Clear() {
-    mem.fill(0x00);
+    std::fill(ram.begin(), ram.end(), 0x00);
+    rom = ZeroRom();
+    ownRom.reset();
+    MapRom();
+    ++romGeneration;
+    MarkAllRowsDirty();
+    if (readCounts) {
+        readCounts->fill(0);
+        writeCounts->fill(0);
+    }
+    cow.index.clear();
+    cow.data.clear();
+    for (Page& page : pages) {
+        page.flags &= ~static_cast<uint32_t>(PAGE_COW);
+    }
 // ---DEBUG MODE ---
-// Initialize debug tracking counters and snapshot
-#ifdef ENABLE_CPU_TESTING
-    snapshot.clear();
-    readCounts.clear();
-    writeCounts.clear();
-    watchpoints.clear();
+#ifdef ENABLE_MEMORY_DEBUG
     std::cout << "[Debug] Memory fully cleared.\n";
 #endif // --- END DEBUG ---
 }
 
 
+//================== Layout ===================================
+
+// === LAYOUT === Sizes RAM/VRAM for the layout (zeroed) and maps it
+void Memory::ApplyLayout(Layout newLayout) {
+    layout = newLayout;
+    addressMask = static_cast<uint32_t>((layout == Layout::Compact16K ? COMPACT_SIZE : MEMORY_SIZE) - 1);
+    pageMask = addressMask >> PAGE_SHIFT;
+    ram.assign(addressMask + 1 - RAM_START, 0x00);
+    ram.shrink_to_fit();
+    BuildPageTable();
+}
+
+// === SET LAYOUT === Fresh RAM, fresh page flags | Code decoded at the old
+// mirror/expansion addresses is dropped through the ROM generation
+void Memory::SetLayout(Layout newLayout) {
+    ApplyLayout(newLayout);
+    cow.index.clear();
+    cow.data.clear();
+    SetAccessPolicy(accessPolicy);
+    ++romGeneration;
+    MarkAllRowsDirty();
+}
+
+
+//================== Page Table ===============================
+
+// === MAP === Points count pages at consecutive 256-byte blocks of storage
+// ROM pages keep their storage for reads and send writes to romSink
+// VRAM pages mark the rows of their storage | Every other page marks dirtySink
+void Memory::MapPages(uint32_t firstPage, uint32_t count, uint8_t* storage, uint32_t flags) {
+    for (uint32_t i = 0; i < count; ++i) {
+        uint8_t* base = storage + i * PAGE_SIZE;
+        pages[firstPage + i].read = base;
+        pages[firstPage + i].write = (flags & PAGE_ROM) ? romSink.data() : base;
+        pages[firstPage + i].dirty = (flags & PAGE_VRAM)
+            ? &vramDirty[(base - &ram[VRAM_START - RAM_START]) >> VRAM_ROW_SHIFT]
+            : dirtySink.data();
+        pages[firstPage + i].flags = flags;
+    }
+}
+
+// === BUILD === Flat 64KB map: ROM | Work RAM | VRAM | Expansion RAM
+// Compact: ROM | Work RAM | VRAM, repeated every 16KB (PAGE_MIRROR above 0x3FFF)
+void Memory::BuildPageTable() {
+    const uint32_t regionPages = pageMask + 1;
+    for (uint32_t base = 0; base < PAGE_COUNT; base += regionPages) {
+        const uint32_t mirror = base ? static_cast<uint32_t>(PAGE_MIRROR) : 0;
+        for (uint32_t page = base; page < base + (RAM_START >> PAGE_SHIFT); ++page) {
+            pages[page].flags = PAGE_ROM | mirror;
+        }
+        MapPages(base + (RAM_START >> PAGE_SHIFT), (VRAM_START - RAM_START) >> PAGE_SHIFT, &ram[0], PAGE_RAM | mirror);
+        MapPages(base + (VRAM_START >> PAGE_SHIFT), (VRAM_END + 1 - VRAM_START) >> PAGE_SHIFT, &ram[VRAM_START - RAM_START], PAGE_VRAM | mirror);
+    }
+    if (layout == Layout::Full64K) {
+        MapPages((VRAM_END + 1) >> PAGE_SHIFT, (MEMORY_SIZE - VRAM_END - 1) >> PAGE_SHIFT, &ram[VRAM_END + 1 - RAM_START], PAGE_RAM);
+    }
+    MapRom();
+}
+
+// === MAP ROM === ROM pages (and their mirrors) read the current image | Flags are left as they are
+void Memory::MapRom() {
+    for (uint32_t page = 0; page < PAGE_COUNT; ++page) {
+        uint32_t backing = page & pageMask;
+        if (backing < (RAM_START >> PAGE_SHIFT)) {
+            pages[page].read = rom->bytes.data() + backing * PAGE_SIZE;
+            pages[page].write = romSink.data();
+            pages[page].dirty = dirtySink.data();
+        }
+    }
+}
+
+
+//================== Shared ROM ===============================
+
+// === INTERN === Returns the live image with these bytes or registers a new one
+// Equal hashes are compared byte for byte before an image is reused
+Memory::SharedRom Memory::InternRom(const uint8_t* data) {
+    uint64_t hash = HashRom(data, RAM_START);
+    RomRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    SharedRom image = registry.images[hash].lock();
+    if (image && std::memcmp(image->bytes.data(), data, RAM_START) == 0) {
+        return image;
+    }
+    auto created = std::make_shared<RomImage>();
+    std::memcpy(created->bytes.data(), data, RAM_START);
+    created->hash = hash;
+    if (!image) {
+        registry.images[hash] = created;
+    }
+    return created;
+}
+
+// === COUNT === Images still used by some instance | Drops the expired entries
+size_t Memory::GetSharedRomCount() {
+    RomRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (auto it = registry.images.begin(); it != registry.images.end();) {
+        it = it->second.expired() ? registry.images.erase(it) : std::next(it);
+    }
+    return registry.images.size();
+}
+
+// === ATTACH === Reads come from the image from now on | Own copy is freed
+void Memory::AttachRom(SharedRom image) {
+    if (!image || image == rom) {
+        return;
+    }
+    if (image->bytes != rom->bytes) {
+        ++romGeneration;
+    }
+    rom = std::move(image);
+    ownRom.reset();
+    MapRom();
+}
+
+// === SHARE === Same bytes, same generation: decoded code and states stay valid
+void Memory::ShareRom() {
+    if (ownRom) {
+        AttachRom(InternRom(ownRom->bytes.data()));
+    }
+}
+
+// === WRITABLE ROM === First write to a shared image copies it for this instance
+uint8_t* Memory::WritableRom() {
+    if (!ownRom) {
+        ownRom = std::make_shared<RomImage>(*rom);
+        rom = ownRom;
+        MapRom();
+    }
+    return ownRom->bytes.data();
+}
+
+
+//================== Access Policy ============================
+
+// === POLICY === Picks the slow path instantiation and flags the pages it needs
+// NoTracking leaves every page unflagged: the fast path is all that runs
+void Memory::SetAccessPolicy(AccessPolicy policy) {
+    accessPolicy = policy;
+    switch (policy) {
+        case AccessPolicy::Counting:
+            readSlow = &Memory::ReadSlow<Counting>;
+            writeSlow = &Memory::WriteSlow<Counting>;
+            readCounts = std::make_unique<AccessCounts>();
+            writeCounts = std::make_unique<AccessCounts>();
+            readCounts->fill(0);
+            writeCounts->fill(0);
+            break;
+        case AccessPolicy::Watching:
+            readSlow = &Memory::ReadSlow<Watching>;
+            writeSlow = &Memory::WriteSlow<Watching>;
+            readCounts.reset();
+            writeCounts.reset();
+            break;
+        default:
+            readSlow = &Memory::ReadSlow<NoTracking>;
+            writeSlow = &Memory::WriteSlow<NoTracking>;
+            readCounts.reset();
+            writeCounts.reset();
+            break;
+    }
+
+    for (uint32_t page = 0; page < PAGE_COUNT; ++page) {
+        pages[page].flags &= ~static_cast<uint32_t>(PAGE_TRACKED | PAGE_WATCHED);
+        if (policy == AccessPolicy::Counting) {
+            pages[page].flags |= PAGE_TRACKED;
+        }
+    }
+    if (policy != AccessPolicy::NoTracking) {
+        for (uint32_t page = 0; page < PAGE_COUNT; ++page) {
+            if (PageHasWatchpoint(page)) {
+                pages[page].flags |= PAGE_WATCHED;
+            }
+        }
+    }
+}
+
+// === COUNTERS === Zero unless the Counting policy is active
+uint32_t Memory::GetReadCount(uint16_t address) const {
+    return readCounts ? (*readCounts)[address] : 0;
+}
+
+uint32_t Memory::GetWriteCount(uint16_t address) const {
+    return writeCounts ? (*writeCounts)[address] : 0;
+}
+
+
 //================== Core Memory Access ======================
 
 // =================  READ ===================================
 
-// === READ === Handles Memory read requests
-uint8_t Memory::ReadByte(uint16_t address) const {
+// === READ SLOW === Flagged pages only | ReadByte() handles the rest inline
+template <class Policy>
+uint8_t Memory::ReadSlow(uint16_t address) const {
+    const Page& page = pages[address >> PAGE_SHIFT];
+    uint8_t value = page.read[address & PAGE_MASK];
 
- // --- DEBUG MODE --- Track Memory Reads and Check for a watchpoint   
-#ifdef ENABLE_MEMORY_DEBUG
-    ++readCounts[address];
-    if (watchpoints.find(address) != watchpoints.end()) {
-        std::cout << "[Watchpoint] READ at 0x" 
-          << std::hex << std::setw(4) << std::setfill('0') << address
-          << ": 0x" << std::setw(2) << (int)mem[address] << "\n";
+    // Track Memory Reads and Check for a watchpoint   
+    if constexpr (Policy::COUNTS) {
+        ++(*readCounts)[address];
     }
-#endif // --- END DEBUG ---
-    return mem[address]; // Send memory Bytes 
+    if constexpr (Policy::WATCHES) {
+        uint32_t backing = address & addressMask;
+        if ((page.flags & PAGE_WATCHED) && watchedLines[backing >> WATCH_LINE_SHIFT] && watchReads[backing]) {
+            ReportWatch(address, value, false);
+        }
+    }
+    return value; // Send memory Bytes 
 }
 
 
@@ -78,7 +355,8 @@ uint8_t Memory::ReadByte(uint16_t address) const {
 // Bypasses the memory ROM protection
 void Memory::writeRomBytes(uint16_t address, uint8_t value) {
     if (address < 0x2000) {
-        mem[address] = value;
+        WritableRom()[address] = value;
+        ++romGeneration;
     
     // --- DEBUG MODE --- 
     #ifdef ENABLE_MEMORY_DEBUG
@@ -95,34 +373,155 @@ void Memory::writeRomBytes(uint16_t address, uint8_t value) {
     }
 }
 
+// === BULK ROM WRITE: (ONLY FOR ROMLoader) === Copies a whole ROM file at once
+// One generation bump per block, so a 4-file load invalidates decoded code 4 times, not 8K
+void Memory::WriteRom(uint16_t address, const uint8_t* data, size_t size) {
+    size_t inRom = address < RAM_START ? std::min<size_t>(size, RAM_START - address) : 0;
+    if (inRom > 0) {
+        std::memcpy(WritableRom() + address, data, inRom);
+        ++romGeneration;
+    }
+
+    // --- DEBUG MODE --- 
+    #ifdef ENABLE_MEMORY_DEBUG
+    if (inRom > 0) {
+        std::cout << "[ROM block] " << std::hex << std::setw(4) << std::setfill('0') << address
+                  << " (" << std::dec << inRom << " bytes)\n";
+    }
+    #endif // --- END DEBUG ---
+
+    if (inRom < size) {
+        // Error catching: if ROM writes outside of 0x2000
+        std::cerr << "[Error] WriteRom() attempted to write outside ROM at 0x"
+                  << std::hex << std::setw(4) << std::setfill('0') << (address + inRom) << std::dec << "\n";
+    }
+}
+
 // ====================== Write (Normal) ============================
 
-// === Core Write == Handles Memory normal writing request
-void Memory::WriteByte(uint16_t address, uint8_t value) {
-   // Blocks writing to ROM section
-    if (address < 0x2000) {
+// === WRITE SLOW === Flagged pages only | WriteByte() handles the rest inline
+template <class Policy>
+void Memory::WriteSlow(uint16_t address, uint8_t value) {
+    const Page& page = pages[address >> PAGE_SHIFT];
 
 // --- DEBUG MODE --- Display Warning when trying to write to ROM (< 0x2000)
 #ifdef ENABLE_MEMORY_DEBUG
+    if (page.flags & PAGE_ROM) {
         std::cout << "[Warning] Attempted to write to ROM at 0x"
                   << std::hex << std::setw(4) << std::setfill('0') << address
                   << " ignored.\n";
-#endif // --- END DEBUG --- 
         return; // Blocks ROM writes 
     }
+#endif // --- END DEBUG ---
 
-// --- DEBUG MODE --- Track Memory writes and Check for a watchpoint  
-#ifdef ENABLE_MEMORY_DEBUG
-    ++writeCounts[address];
-    // Display watchpoint value
-    if (watchpoints.find(address) != watchpoints.end()) {
-       std::cout << "[Watchpoint] WRITE at 0x"
-                 << std::hex << std::setw(4) << std::setfill('0') << address
-                 << ": 0x" << std::setw(2) << static_cast<int>(value) << "\n";
+    // Track Memory writes and Check for a watchpoint  
+    if constexpr (Policy::COUNTS) {
+        ++(*writeCounts)[address];
     }
-#endif // --- END DEBUG ---
-    // Write to memory at specific address
-    mem[address] = value; 
+    // First write since the snapshot: keep the old page
+    if (page.flags & PAGE_COW) {
+        CopyPageToSnapshot(address >> PAGE_SHIFT);
+    }
+    // Write through the page | ROM pages write to the discard page
+    page.write[address & PAGE_MASK] = value; 
+    page.dirty[(address & PAGE_MASK) >> VRAM_ROW_SHIFT] = 1;
+
+    // Report after the write, so a callback sees the new value in memory
+    if constexpr (Policy::WATCHES) {
+        uint32_t backing = address & addressMask;
+        if ((page.flags & PAGE_WATCHED) && watchedLines[backing >> WATCH_LINE_SHIFT] && watchWrites[backing]) {
+            ReportWatch(address, value, true);
+        }
+    }
+}
+
+
+// ==================== Save States ==================================
+
+// === SAVE STATE === Copies the owned RAM in one block
+// 0x2000 - 0xFFFF, or 0x2000 - 0x3FFF in the compact layout
+// Only the first save into a state allocates, later ones reuse its capacity
+void Memory::SaveState(State& out) const {
+    out.ram.assign(ram.begin(), ram.end());
+    out.romGeneration = romGeneration;
+}
+
+// === LOAD STATE === Restores RAM | Refuses a state taken under another ROM
+bool Memory::LoadState(const State& in) {
+    if (in.romGeneration != romGeneration || in.ram.size() != ram.size()) {
+        return false;
+    }
+    // The copy bypasses WriteByte: keep the snapshot's pages first
+    for (uint32_t page = 0; page < PAGE_COUNT; ++page) {
+        if (pages[page].flags & PAGE_COW) {
+            CopyPageToSnapshot(page);
+        }
+    }
+    std::memcpy(ram.data(), in.ram.data(), ram.size());
+    MarkAllRowsDirty();
+    return true;
+}
+
+
+// ==================== Copy-On-Write Snapshots ======================
+
+// === TAKE SNAPSHOT === Flags every writable page | Nothing is copied yet
+// The finished snapshot trades buffers with previous, so a chain reuses its storage
+void Memory::TakeSnapshot(PageSnapshot* previous) {
+    if (previous) {
+        std::swap(cow, *previous);
+    }
+    cow.index.clear();
+    cow.data.clear();
+    cow.romGeneration = romGeneration;
+    for (Page& page : pages) {
+        if (!(page.flags & PAGE_ROM)) {
+            page.flags |= PAGE_COW;
+        }
+    }
+}
+
+// === COPY PAGE === Called once per backing page: clears PAGE_COW on it and its mirrors
+// A write through a mirror must not copy the already-written page a second time
+void Memory::CopyPageToSnapshot(uint32_t page) {
+    uint32_t backing = page & pageMask;
+    for (uint32_t alias = backing; alias < PAGE_COUNT; alias += pageMask + 1) {
+        pages[alias].flags &= ~static_cast<uint32_t>(PAGE_COW);
+    }
+    cow.index.push_back(static_cast<uint8_t>(backing));
+    cow.data.emplace_back();
+    std::memcpy(cow.data.back().data(), pages[backing].read, PAGE_SIZE);
+}
+
+// === RESTORE SNAPSHOT === Active snapshot: copied pages are put back, the
+// others were never written | The snapshot stays active
+bool Memory::RestoreSnapshot() {
+    if (cow.romGeneration != romGeneration) {
+        return false;
+    }
+    for (size_t i = 0; i < cow.index.size(); ++i) {
+        Page& page = pages[cow.index[i]];
+        std::memcpy(page.write, cow.data[i].data(), PAGE_SIZE);
+        std::fill(page.dirty, page.dirty + ROWS_PER_PAGE, 1);
+    }
+    return true;
+}
+
+// === RESTORE SNAPSHOT === Finished snapshot | Pages it overwrites are kept
+// in the active one first, so RestoreSnapshot() still returns to it
+bool Memory::RestoreSnapshot(const PageSnapshot& snapshot) {
+    if (snapshot.romGeneration != romGeneration) {
+        return false;
+    }
+    for (size_t i = 0; i < snapshot.index.size(); ++i) {
+        Page& page = pages[snapshot.index[i]];
+        if (page.flags & PAGE_COW) {
+            CopyPageToSnapshot(snapshot.index[i]);
+        }
+        std::memcpy(page.write, snapshot.data[i].data(), PAGE_SIZE);
+        std::fill(page.dirty, page.dirty + ROWS_PER_PAGE, 1);
+    }
+    return true;
 }
 
 
@@ -138,7 +537,7 @@ std::vector<uint8_t> Memory::GetVRAM() const {
     vram.reserve(VRAM_END - VRAM_START + 1);
 
     for (uint16_t addr = VRAM_START; addr <= VRAM_END; ++addr) {
-        vram.push_back(mem[addr]);
+        vram.push_back(ram[addr - RAM_START]);
     }
 
     return vram;
@@ -146,7 +545,24 @@ std::vector<uint8_t> Memory::GetVRAM() const {
 
 // === VRAM === Direct read-only pointer to video RAM
 const uint8_t* Memory::GetVRAMPointer() const {
-    return &mem[VRAM_START];
+    return &ram[VRAM_START - RAM_START];
+}
+
+// === DIRTY ROWS === Collects and clears the written rows of a range
+Memory::DirtyRows Memory::ConsumeDirtyRows(uint32_t first, uint32_t last) {
+    DirtyRows rows;
+    for (uint32_t row = first; row < last && row < VRAM_ROWS; ++row) {
+        if (vramDirty[row]) {
+            rows.set(row);
+            vramDirty[row] = 0;
+        }
+    }
+    return rows;
+}
+
+// === DIRTY ROWS === Whole screen must be redrawn (new contents or new consumer)
+void Memory::MarkAllRowsDirty() {
+    vramDirty.fill(1);
 }
 
 // --- DEBUG MODE -- 
@@ -162,7 +578,7 @@ void Memory::DumpVRAM(uint16_t start, uint16_t end) const {
 
     for (uint16_t addr = start; addr <= end; ++addr) {
         std::cout << "VRAM[0x" << std::hex << std::setw(4) << std::setfill('0') << addr
-                  << "] = 0x" << std::setw(2) << static_cast<int>(mem[addr]) << "\n";
+                  << "] = 0x" << std::setw(2) << static_cast<int>(ram[addr - RAM_START]) << "\n";
     }
 }
 #endif // --- END DEBUG ---
@@ -179,7 +595,8 @@ void Memory::DumpMemory(const std::string& filename) const {
         return;
     }
 
-    out.write(reinterpret_cast<const char*>(mem.data()), MEMORY_SIZE);
+    out.write(reinterpret_cast<const char*>(rom->bytes.data()), RAM_START);
+    out.write(reinterpret_cast<const char*>(ram.data()), ram.size());
     out.close();
     std::cout << "[Debug] Memory dumped to \"" << filename << "\"\n";
 }
@@ -190,28 +607,32 @@ void Memory::DumpRegion(uint16_t start, uint16_t end) const {
         if ((addr - start) % 16 == 0)
             std::cout << "\n0x" << std::hex << std::setw(4) << std::setfill('0') << addr << ": ";
 
-        std::cout << std::setw(2) << std::setfill('0') << static_cast<int>(mem[addr]) << " ";
+        std::cout << std::setw(2) << std::setfill('0') << static_cast<int>(pages[addr >> PAGE_SHIFT].read[addr & PAGE_MASK]) << " ";
     }
     std::cout << std::dec << "\n";
 }
 
-// === Debug: Take a Snapshot of Memory ===
+// === Debug: Take a Snapshot of Memory === Copy-on-write, nothing is copied here
 void Memory::Snapshot() {
-    snapshot.assign(mem.begin(), mem.end());  
+    TakeSnapshot();
     std::cout << "[Debug] Snapshot taken.\n";
 }
 
-// === Debug: Compare Snapshot to Memory ===
+// === Debug: Compare Snapshot to Memory === Only pages written since can differ
 void Memory::CompareWithSnapshot() const {
     std::cout << "[Debug] Comparing memory with snapshot:\n";
     bool found = false;
 
-    for (size_t i = 0; i < MEMORY_SIZE; ++i) {
-        if (mem[i] != snapshot[i]) {
-            std::cout << "  0x" << std::hex << std::setw(4) << std::setfill('0') << i
-                      << ": was 0x" << std::setw(2) << static_cast<int>(snapshot[i])
-                      << ", now 0x" << std::setw(2) << static_cast<int>(mem[i]) << "\n";
-            found = true;
+    for (size_t i = 0; i < cow.index.size(); ++i) {
+        const uint8_t* now = pages[cow.index[i]].read;
+        for (uint32_t offset = 0; offset < PAGE_SIZE; ++offset) {
+            if (now[offset] != cow.data[i][offset]) {
+                uint32_t address = (static_cast<uint32_t>(cow.index[i]) << PAGE_SHIFT) | offset;
+                std::cout << "  0x" << std::hex << std::setw(4) << std::setfill('0') << address
+                          << ": was 0x" << std::setw(2) << static_cast<int>(cow.data[i][offset])
+                          << ", now 0x" << std::setw(2) << static_cast<int>(now[offset]) << "\n";
+                found = true;
+            }
         }
     }
 
@@ -220,19 +641,84 @@ void Memory::CompareWithSnapshot() const {
     }
 }
 
-// === Debug: Create Watchpoints in Memory ===
-void Memory::AddWatchpoint(uint16_t address) {
-    watchpoints.insert(address);
+#endif // --- END DEBUG TOOLS --- 
+
+// ======================== Watchpoints ==============================
+
+// === Create Watchpoints in Memory === Flags the page so accesses leave the fast path
+// Kept by backing address, so every mirror of the byte is watched
+void Memory::AddWatchpoint(uint16_t address, uint8_t kind) {
+    uint32_t backing = address & addressMask;
+    watchReads[backing] = watchReads[backing] || (kind & WATCH_READ);
+    watchWrites[backing] = watchWrites[backing] || (kind & WATCH_WRITE);
+    watchedLines[backing >> WATCH_LINE_SHIFT] = true;
+    if (accessPolicy != AccessPolicy::NoTracking) {
+        for (uint32_t page = backing >> PAGE_SHIFT; page < PAGE_COUNT; page += pageMask + 1) {
+            pages[page].flags |= PAGE_WATCHED;
+        }
+    }
     std::cout << "[Debug] Watchpoint added at 0x"
               << std::hex << std::setw(4) << std::setfill('0') << address << "\n";
 }
-// === Debug: Clear Watchpoints in Memory ===
+
+// === Remove a Watchpoint === The line and page stay flagged only while they hold another
+void Memory::RemoveWatchpoint(uint16_t address) {
+    uint32_t backing = address & addressMask;
+    watchReads[backing] = false;
+    watchWrites[backing] = false;
+    uint32_t first = backing & ~((1u << WATCH_LINE_SHIFT) - 1);
+    bool lineWatched = false;
+    for (uint32_t addr = first; addr < first + (1u << WATCH_LINE_SHIFT); ++addr) {
+        lineWatched = lineWatched || watchReads[addr] || watchWrites[addr];
+    }
+    watchedLines[backing >> WATCH_LINE_SHIFT] = lineWatched;
+    if (!PageHasWatchpoint(backing >> PAGE_SHIFT)) {
+        for (uint32_t page = backing >> PAGE_SHIFT; page < PAGE_COUNT; page += pageMask + 1) {
+            pages[page].flags &= ~static_cast<uint32_t>(PAGE_WATCHED);
+        }
+    }
+}
+
+// === Clear Watchpoints in Memory ===
 void Memory::ClearWatchpoints() {
-    watchpoints.clear();
+    watchedLines.reset();
+    watchReads.reset();
+    watchWrites.reset();
+    for (Page& page : pages) {
+        page.flags &= ~static_cast<uint32_t>(PAGE_WATCHED);
+    }
     std::cout << "[Debug] All watchpoints cleared.\n";
 }
 
-// === Debug: Access Logging for Reads and Writes ===
+// === Watch Callback === Replaces the console report
+void Memory::SetWatchCallback(WatchCallback callback) {
+    watchCallback = std::move(callback);
+}
+
+// === Page Check === Any of the (backing) page's four 64-byte lines watched
+bool Memory::PageHasWatchpoint(uint32_t page) const {
+    constexpr uint32_t LINES_PER_PAGE = PAGE_SIZE >> WATCH_LINE_SHIFT;
+    page &= pageMask;
+    for (uint32_t line = page * LINES_PER_PAGE; line < (page + 1) * LINES_PER_PAGE; ++line) {
+        if (watchedLines[line]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// === Report === Callback if set | Otherwise display the access
+void Memory::ReportWatch(uint16_t address, uint8_t value, bool isWrite) const {
+    if (watchCallback) {
+        watchCallback(address, value, isWrite);
+        return;
+    }
+    std::cout << "[Watchpoint] " << (isWrite ? "WRITE" : "READ") << " at 0x"
+              << std::hex << std::setw(4) << std::setfill('0') << address
+              << ": 0x" << std::setw(2) << static_cast<int>(value) << "\n";
+}
+
+// === Access Logging for Reads and Writes ===
 void Memory::LogAccessCounts(const std::string& filename) const {
     std::ofstream out(filename);
     if (!out) {
@@ -243,8 +729,8 @@ void Memory::LogAccessCounts(const std::string& filename) const {
     out << "Address\tReads\tWrites\n";
     for (size_t i = 0; i < MEMORY_SIZE; ++i) {
         uint16_t addr = static_cast<uint16_t>(i);
-        int reads = readCounts.count(addr) ? readCounts.at(addr) : 0;
-        int writes = writeCounts.count(addr) ? writeCounts.at(addr) : 0;
+        uint32_t reads = GetReadCount(addr);
+        uint32_t writes = GetWriteCount(addr);
 
         if (reads > 0 || writes > 0) {
             out << "0x" << std::hex << std::setw(4) << std::setfill('0') << addr
@@ -256,5 +742,10 @@ void Memory::LogAccessCounts(const std::string& filename) const {
     std::cout << "[Debug] Access counts logged to \"" << filename << "\"\n";
 }
 
-#endif // --- END DEBUG TOOLS --- 
-
+// ======================== Policy Instantiations ====================
+template uint8_t Memory::ReadSlow<Memory::NoTracking>(uint16_t) const;
+template uint8_t Memory::ReadSlow<Memory::Counting>(uint16_t) const;
+template uint8_t Memory::ReadSlow<Memory::Watching>(uint16_t) const;
+template void Memory::WriteSlow<Memory::NoTracking>(uint16_t, uint8_t);
+template void Memory::WriteSlow<Memory::Counting>(uint16_t, uint8_t);
+template void Memory::WriteSlow<Memory::Watching>(uint16_t, uint8_t);
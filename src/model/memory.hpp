@@ -8,6 +8,7 @@
 // Working RAM: 0x2000 – 0x23FF | CPU Functions
 // Video RAM: 0x2400 – 0x3FFF | Video RAM for QT
 // Expansion / Stack:0x4000 – 0xFFFF | Emulation Core and I/O
+// Compact layout: only 0x0000 – 0x3FFF exists, mirrored up to 0xFFFF
 //
 // Provides memory access for: RAM/ROM access, VRAM, Debugging
 // Author: Fredo | Date: 7/19/25
@@ -20,18 +21,13 @@
 
 // ======================= Include Files ===================================
 #include <array>
+#include <bitset>
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
-// ====================== ENABLE MEMORY DEBUG =============================
-//--- DEBUG MODE ---  Enables DEBUG MODE 
-#ifdef ENABLE_MEMORY_DEBUG
-#include <unordered_map>
-#include <unordered_set>
-
-#endif // --- END DEBUG -- 
-
 // ================== Memory Class ========================================
 // Declares and Manages Memory 
 class Memory {
@@ -39,27 +35,246 @@ public:
     static const size_t MEMORY_SIZE = 0x10000; // Creates 64KB Memory
     static constexpr uint16_t VRAM_START = 0x2400; // QT: VRAM Access
     static constexpr uint16_t VRAM_END   = 0x3FFF; // QT: VRAM Access
+    static constexpr uint16_t RAM_START  = 0x2000; // First writable byte (end of ROM)
+
+    // =============== Layouts ===================================
+    // Full64K:    flat 64KB, expansion RAM at 0x4000 - 0xFFFF
+    // Compact16K: the 16KB the arcade board decodes (8KB ROM, 1KB RAM, 7KB VRAM)
+    //             Seen 4 times: address & 0x3FFF, resolved in the page table
+    enum class Layout { Full64K, Compact16K };
+    static constexpr size_t COMPACT_SIZE = 0x4000;
+
+    // =============== Page Table =================================
+    // The bus is split in 256-byte pages | Each page has read/write base pointers
+    static constexpr uint32_t PAGE_SHIFT = 8;
+    static constexpr uint32_t PAGE_SIZE  = 1u << PAGE_SHIFT;
+    static constexpr uint32_t PAGE_MASK  = PAGE_SIZE - 1;
+    static constexpr uint32_t PAGE_COUNT = MEMORY_SIZE >> PAGE_SHIFT;
+
+    // === Page Flags ===
+    // What a page is | Only PAGE_SLOW pages leave the fast path
+    enum PageFlags : uint32_t {
+        PAGE_ROM     = 1u << 0, // Writes land in a discard page
+        PAGE_RAM     = 1u << 1, // Work RAM and expansion RAM
+        PAGE_VRAM    = 1u << 2, // Video RAM (0x2400 - 0x3FFF)
+        PAGE_MIRROR  = 1u << 3, // Pointers alias another page's storage
+        PAGE_WATCHED = 1u << 4, // Holds a watchpoint
+        PAGE_IO_TRAP = 1u << 5, // Accesses are forwarded to a device
+        PAGE_TRACKED = 1u << 6, // Access counting (ENABLE_MEMORY_DEBUG)
+        PAGE_COW     = 1u << 7, // Not yet copied into the active snapshot (writes only)
+        PAGE_SLOW    = PAGE_WATCHED | PAGE_IO_TRAP | PAGE_TRACKED,
+        PAGE_SLOW_WRITE = PAGE_SLOW | PAGE_COW,
+    };
+
+    // =============== Dirty Rows ================================
+    // VRAM is 224 rows of 32 bytes (one scanline each) | A row is dirty once written
+    static constexpr uint32_t VRAM_ROW_SHIFT = 5;
+    static constexpr uint32_t VRAM_ROW_SIZE  = 1u << VRAM_ROW_SHIFT;
+    static constexpr uint32_t VRAM_ROWS      = (VRAM_END + 1 - VRAM_START) >> VRAM_ROW_SHIFT;
+    static constexpr uint32_t ROWS_PER_PAGE  = PAGE_SIZE >> VRAM_ROW_SHIFT;
+    using DirtyRows = std::bitset<VRAM_ROWS>;
+
+    // === Page ===
+    // ROM pages read from ROM and write to the discard page, so the
+    // fast path needs no ROM check | dirty holds one flag per 32-byte
+    // row: VRAM rows for VRAM pages, a shared sink for every other page
+    struct Page {
+        const uint8_t* read;
+        uint8_t* write;
+        uint8_t* dirty;
+        uint32_t flags;
+    };
+
+    // =============== Access Policies ============================
+    // Chosen at runtime | Each one is a separate instantiation of the slow path
+    // NoTracking: no page is flagged, every access stays on the fast path
+    // Counting:   every page is flagged, reads/writes counted per address
+    // Watching:   only pages holding a watchpoint are flagged
+    enum class AccessPolicy { NoTracking, Counting, Watching };
+
+    struct NoTracking { static constexpr bool COUNTS = false; static constexpr bool WATCHES = false; };
+    struct Counting   { static constexpr bool COUNTS = true;  static constexpr bool WATCHES = true;  };
+    struct Watching   { static constexpr bool COUNTS = false; static constexpr bool WATCHES = true;  };
+
+    // Flat per-address counters (only allocated while Counting)
+    using AccessCounts = std::array<uint32_t, MEMORY_SIZE>;
+
+    // =============== Watchpoints ================================
+    // Watched pages leave the fast path | A 64-byte line bitmap then an
+    // exact per-address bit decide if the callback runs
+    static constexpr uint32_t WATCH_LINE_SHIFT = 6;
+    static constexpr uint32_t WATCH_LINES      = MEMORY_SIZE >> WATCH_LINE_SHIFT;
+    enum WatchKind : uint8_t {
+        WATCH_READ   = 1u << 0,
+        WATCH_WRITE  = 1u << 1,
+        WATCH_ACCESS = WATCH_READ | WATCH_WRITE,
+    };
+    // Called on every watched access (after a write lands) | Empty: print to std::cout
+    using WatchCallback = std::function<void(uint16_t address, uint8_t value, bool isWrite)>;
+
+    // =============== Shared ROM ================================
+    // The 8KB ROM is an immutable image | Instances loading the same bytes
+    // share one process-wide copy (keyed by hash, freed with its last user)
+    // Only RAM and VRAM are owned per instance
+    struct RomImage {
+        std::array<uint8_t, RAM_START> bytes{};
+        uint64_t hash = 0;
+    };
+    using SharedRom = std::shared_ptr<const RomImage>;
 
     // =============== Constructor ================================
-    Memory();   
+    explicit Memory(Layout layout = Layout::Full64K);   
+    // Copies rebuild the page table over the copy's own storage
+    Memory(const Memory& other);
+    Memory& operator=(const Memory& other);
 
     // =============== Core Memory Access ==========================
     // === Main Memory === 
     // Used to Read, Write and Write the ROM to memory
-    uint8_t ReadByte(uint16_t address) const; 
-    void WriteByte(uint16_t address, uint8_t value); 
+    // One page lookup and one indexed load/store | Flagged pages take the slow path
+    // Writes also mark their row, branch-free (non-VRAM rows land in a sink)
+    // Reads ignore PAGE_COW: a snapshot never slows them down
+    uint8_t ReadByte(uint16_t address) const {
+        const Page& page = pages[address >> PAGE_SHIFT];
+        if (page.flags & PAGE_SLOW) {
+            return (this->*readSlow)(address);
+        }
+        return page.read[address & PAGE_MASK];
+    }
+    void WriteByte(uint16_t address, uint8_t value) {
+        const Page& page = pages[address >> PAGE_SHIFT];
+        if (page.flags & PAGE_SLOW_WRITE) {
+            (this->*writeSlow)(address, value);
+            return;
+        }
+        page.write[address & PAGE_MASK] = value;
+        page.dirty[(address & PAGE_MASK) >> VRAM_ROW_SHIFT] = 1;
+    }
+
+    // === Words (little-endian) ===
+    // Both bytes on one unflagged page: one unaligned 16-bit load/store
+    // Otherwise two byte accesses, address + 1 wrapping 0xFFFF -> 0x0000
+    // ROM pages discard the write like WriteByte
+    uint16_t ReadWord(uint16_t address) const {
+        const Page& page = pages[address >> PAGE_SHIFT];
+        uint32_t offset = address & PAGE_MASK;
+        if (!(page.flags & PAGE_SLOW) && offset != PAGE_MASK) {
+            return static_cast<uint16_t>(page.read[offset] | (page.read[offset + 1] << 8));
+        }
+        return static_cast<uint16_t>(ReadByte(address) | (ReadByte(static_cast<uint16_t>(address + 1)) << 8));
+    }
+    void WriteWord(uint16_t address, uint16_t value) {
+        const Page& page = pages[address >> PAGE_SHIFT];
+        uint32_t offset = address & PAGE_MASK;
+        if (!(page.flags & PAGE_SLOW_WRITE) && offset != PAGE_MASK) {
+            page.write[offset] = static_cast<uint8_t>(value);
+            page.write[offset + 1] = static_cast<uint8_t>(value >> 8);
+            page.dirty[offset >> VRAM_ROW_SHIFT] = 1;
+            page.dirty[(offset + 1) >> VRAM_ROW_SHIFT] = 1;
+            return;
+        }
+        WriteByte(address, static_cast<uint8_t>(value));
+        WriteByte(static_cast<uint16_t>(address + 1), static_cast<uint8_t>(value >> 8));
+    }
+
     void writeRomBytes(uint16_t address, uint8_t value); 
+    // === Bulk ROM Write === One memcpy and one ROM generation bump per block
+    // Bytes past the ROM are dropped with an error, like writeRomBytes()
+    void WriteRom(uint16_t address, const uint8_t* data, size_t size);
     void Clear();
 
+    // === Layout ===
+    // Switching reallocates RAM/VRAM, zeroes it and drops the snapshot | ROM is kept
+    void SetLayout(Layout newLayout);
+    Layout GetLayout() const { return layout; }
+    // Bytes owned per instance above the ROM: 56KB (Full64K) or 8KB (Compact16K)
+    size_t GetRamSize() const { return ram.size(); }
+
+    // === Page Flags ===
+    // Flags of the page holding an address
+    uint32_t GetPageFlags(uint16_t address) const { return pages[address >> PAGE_SHIFT].flags; }
+
+    // === Access Policy ===
+    // Switches the slow path and re-flags the pages | Counters start from zero
+    void SetAccessPolicy(AccessPolicy policy);
+    AccessPolicy GetAccessPolicy() const { return accessPolicy; }
+
+    // === Access Counters ===
+    // Reads/writes per address while Counting (0 otherwise) | Log to a file
+    uint32_t GetReadCount(uint16_t address) const;
+    uint32_t GetWriteCount(uint16_t address) const;
+    void LogAccessCounts(const std::string& filename) const; 
+
+    // === Create and Clear Watchpoints ===
+    // Adds a watch point at specific address | Removes one | Clears watchpoints
+    // Reported while Watching or Counting
+    void AddWatchpoint(uint16_t address, uint8_t kind = WATCH_ACCESS); 
+    void RemoveWatchpoint(uint16_t address);
+    void ClearWatchpoints(); 
+    void SetWatchCallback(WatchCallback callback);
+
+    // === Shared ROM ===
+    // Process-wide image holding these 8KB (created on first use) | Live images
+    static SharedRom InternRom(const uint8_t* data);
+    static size_t GetSharedRomCount();
+    // Reads the ROM from an image | Drops this instance's own copy
+    // The generation only changes if the bytes differ
+    void AttachRom(SharedRom image);
+    // Swaps this instance's ROM for the shared image with the same bytes
+    void ShareRom();
+    // False once writeRomBytes()/WriteRom() gave this instance a private copy
+    bool IsRomShared() const { return !ownRom; }
+    const SharedRom& GetRom() const { return rom; }
+
+    // === ROM Generation ===
+    // Bumped on every ROM write and Clear() | Lets the CPU drop code decoded from old ROM
+    uint32_t GetRomGeneration() const { return romGeneration; }
+
+    // === Save States ===
+    // Everything above the ROM, plus the ROM generation it belongs to
+    // The ROM is never written at runtime, so a state never copies it
+    // ram holds GetRamSize() bytes: 8KB in the compact layout, 56KB otherwise
+    struct State {
+        std::vector<uint8_t> ram;
+        uint32_t romGeneration = 0;
+    };
+    // Copies RAM into a state | Restores it (fails if the ROM or layout changed since)
+    void SaveState(State& out) const;
+    bool LoadState(const State& in);
+
+    // === Copy-On-Write Snapshots ===
+    // Taking a snapshot only flags the writable pages (PAGE_COW); the first
+    // write to a flagged page copies it here | Cost = pages actually written
+    struct PageSnapshot {
+        std::vector<uint8_t> index;                       // Pages copied, in copy order
+        std::vector<std::array<uint8_t, PAGE_SIZE>> data; // Their contents at snapshot time
+        uint32_t romGeneration = 0;
+    };
+    // Starts a new snapshot | The finished one is swapped into previous (for rewind chains)
+    void TakeSnapshot(PageSnapshot* previous = nullptr);
+    // Back to the last TakeSnapshot() (repeatable) | Fails if the ROM changed since
+    bool RestoreSnapshot();
+    // Puts back a finished snapshot | Restore a chain newest first to step back further
+    bool RestoreSnapshot(const PageSnapshot& snapshot);
+    // Pages copied since the last TakeSnapshot()
+    size_t GetSnapshotPageCount() const { return cow.index.size(); }
+
     // === VRAM access ===
     // Copy of VRAM for QT | Direct Read only access to VRAM via pointer
     std::vector<uint8_t> GetVRAM() const;  
     const uint8_t* GetVRAMPointer() const; 
 
+    // === VRAM Dirty Rows ===
+    // Returns rows [first, last) written since they were last consumed and clears them
+    // Clear() and LoadState() mark every row dirty
+    DirtyRows ConsumeDirtyRows(uint32_t first = 0, uint32_t last = VRAM_ROWS);
+    void MarkAllRowsDirty();
+
 #ifdef ENABLE_MEMORY_DEBUG
     // ================ DEBUG Tools ================================
     //  === Snapshots & Comparison ===
     // Used to Snapshot memory | Compares snapshots to Memory
+    // Copy-on-write: only the pages written since Snapshot() are compared
     void Snapshot(); 
     void CompareWithSnapshot() const; 
 
@@ -67,32 +282,81 @@ public:
     // Used for Dumping Memory, Dumping a region of memory, and creating an access log
     void DumpMemory(const std::string& filename) const; 
     void DumpRegion(uint16_t start, uint16_t end) const; 
-    void LogAccessCounts(const std::string& filename) const; 
     
     // === Video RAM Dump ===
     void DumpVRAM(uint16_t start, uint16_t end) const;
 
-    // === Create and Clear Watchpoints ===
-    // Adds a watch point at specific address | Clears watchpoints
-    void AddWatchpoint(uint16_t address); 
-    void ClearWatchpoints(); 
-
 #endif
 
 private:
     // === Memory Storge ===
-    // The Main Memory - 64KB for  ROM, RAM, VRAM
-    std::array<uint8_t, MEMORY_SIZE> mem{}; 
+    // Owned per instance: 0x2000 - 0xFFFF (Work RAM, VRAM, Expansion RAM)
+    // Compact layout: 0x2000 - 0x3FFF only
+    std::vector<uint8_t> ram; 
 
-#ifdef ENABLE_MEMORY_DEBUG
-    // ===============  DEBUG TOOLS =========================================
-    // === Setup States ===
-    // Sets up snapshot, readCounts, writeCounts, and watchpoint States
-    std::vector<uint8_t> snapshot;   
-    mutable std::unordered_map<uint16_t, int> readCounts; 
-    mutable std::unordered_map<uint16_t, int> writeCounts; 
-    mutable std::unordered_set<uint16_t> watchpoints; 
-#endif
+    // === Layout ===
+    // Masks giving the backing address/page an address/page aliases (all ones when flat)
+    Layout layout = Layout::Full64K;
+    uint32_t addressMask = MEMORY_SIZE - 1;
+    uint32_t pageMask = PAGE_COUNT - 1;
+
+    // === ROM Storage ===
+    // Image the ROM pages read | This instance's private copy (null while shared)
+    // A ROM write first copies a shared image, so other instances never see it
+    SharedRom rom;
+    std::shared_ptr<RomImage> ownRom;
+    uint8_t* WritableRom();
+
+    // === Page Table ===
+    // One entry per 256-byte page | ROM writes go to romSink and are never read
+    std::array<Page, PAGE_COUNT> pages{};
+    std::array<uint8_t, PAGE_SIZE> romSink{};
+
+    // === Dirty Rows ===
+    // One byte per VRAM row (a plain store, no read-modify-write) | Sink for the other pages
+    std::array<uint8_t, VRAM_ROWS> vramDirty{};
+    std::array<uint8_t, ROWS_PER_PAGE> dirtySink{};
+
+    // === Page Mapping ===
+    // Builds the ROM/RAM/VRAM map (and its mirrors) | Points count pages at storage with flags
+    // Points the ROM pages at the current image | Sizes RAM for a layout and maps it
+    void ApplyLayout(Layout newLayout);
+    void BuildPageTable();
+    void MapRom();
+    void MapPages(uint32_t firstPage, uint32_t count, uint8_t* storage, uint32_t flags);
+
+    // === Snapshot ===
+    // Active snapshot (cow) | Copies one flagged page into it before its first write
+    // Pages are stored by backing page, and every mirror of it is unflagged
+    PageSnapshot cow;
+    void CopyPageToSnapshot(uint32_t page);
+
+    // === Slow Path ===
+    // Flagged pages: counting, watchpoints, ROM write warnings
+    // One instantiation per policy | The active one is picked at runtime
+    template <class Policy> uint8_t ReadSlow(uint16_t address) const;
+    template <class Policy> void WriteSlow(uint16_t address, uint8_t value);
+    uint8_t (Memory::*readSlow)(uint16_t) const = &Memory::ReadSlow<NoTracking>;
+    void (Memory::*writeSlow)(uint16_t, uint8_t) = &Memory::WriteSlow<NoTracking>;
+
+    // === Access Tracking ===
+    // Active policy | Counters
+    AccessPolicy accessPolicy = AccessPolicy::NoTracking;
+    std::unique_ptr<AccessCounts> readCounts;
+    std::unique_ptr<AccessCounts> writeCounts;
+
+    // === Watchpoints ===
+    // Lines holding any watchpoint | Exact read/write addresses | Callback
+    std::bitset<WATCH_LINES> watchedLines;
+    std::bitset<MEMORY_SIZE> watchReads;
+    std::bitset<MEMORY_SIZE> watchWrites;
+    WatchCallback watchCallback;
+    bool PageHasWatchpoint(uint32_t page) const;
+    void ReportWatch(uint16_t address, uint8_t value, bool isWrite) const;
+
+    // === ROM Generation === 
+    // Counts changes to 0x0000 - 0x1FFF 
+    uint32_t romGeneration = 0;
 };
 
 #endif // memory.hpp
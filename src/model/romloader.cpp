@@ -26,40 +26,110 @@
 #include <iomanip>
 #include <vector>
 #include <filesystem>
+#include <chrono>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ROMLOADER_USE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define ROMLOADER_USE_MMAP 0
+#endif
 
 
 // ================= Constants ===============================
 static const std::string DEFAULT_ROM_DIR = "src/tests/";
 
 
-// =================== Load ROM File =========================
-// Reads a ROM file and loads it into emulator memory
-bool LoadROMFile(const std::string& filepath, Memory& memory, uint16_t targetAddr) {
+// =================== Map ROM File ==========================
+// Maps a ROM file read-only (POSIX) or reads it into a buffer (elsewhere)
+// The mapping is dropped as soon as its bytes are copied into ROM
+struct RomFileView {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+#if ROMLOADER_USE_MMAP
+    void* mapping = nullptr;
+#else
+    std::vector<uint8_t> buffer;
+#endif
+};
+
+static bool OpenRomFile(const std::string& filepath, RomFileView& view) {
+#if ROMLOADER_USE_MMAP
+    // === open + fstat + mmap | No read() copy, no heap buffer ===
+    int fd = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+    view.size = static_cast<size_t>(info.st_size);
+    if (view.size > 0 && view.size <= Memory::MEMORY_SIZE) {
+        view.mapping = ::mmap(nullptr, view.size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view.mapping == MAP_FAILED) {
+            view.mapping = nullptr;
+            ::close(fd);
+            return false;
+        }
+        view.data = static_cast<const uint8_t*>(view.mapping);
+    }
+    ::close(fd); // The mapping outlives the descriptor
+    return true;
+#else
     std::ifstream romFile(filepath, std::ios::binary);
     if (!romFile) {
-        std::cerr << "[ROM Load Error] Failed to open: " << filepath << "\n";
         return false;
     }
+    view.buffer.assign(std::istreambuf_iterator<char>(romFile), {});
+    view.data = view.buffer.data();
+    view.size = view.buffer.size();
+    return true;
+#endif
+}
 
-    // === Read file into buffer ===
-    std::vector<uint8_t> buffer(std::istreambuf_iterator<char>(romFile), {});
-    size_t size = buffer.size();
+static void CloseRomFile(RomFileView& view) {
+#if ROMLOADER_USE_MMAP
+    if (view.mapping) {
+        ::munmap(view.mapping, view.size);
+        view.mapping = nullptr;
+    }
+#endif
+    view.data = nullptr;
+}
+
+
+// =================== Load ROM File =========================
+// Maps a ROM file and copies it into emulator memory with a single memcpy
+bool LoadROMFile(const std::string& filepath, Memory& memory, uint16_t targetAddr) {
+    RomFileView view;
+    if (!OpenRomFile(filepath, view)) {
+        std::cerr << "[ROM Load Error] Failed to open: " << filepath << "\n";
+        return false;
+    }
+    size_t size = view.size;
 
     // === Memory bounds check ===
     if (targetAddr + size > Memory::MEMORY_SIZE) {
         std::cerr << "[ROM Load Error] File \"" << filepath 
                   << "\" exceeds memory bounds at 0x"
-                  << std::hex << std::setw(4) << std::setfill('0') << targetAddr << "\n";
+                  << std::hex << std::setw(4) << std::setfill('0') << targetAddr << std::dec << "\n";
+        CloseRomFile(view);
         return false;
     }
 
     // === Write to ROM Section ===
-    for (size_t i = 0; i < size; ++i) {
-        memory.writeRomBytes(static_cast<uint16_t>(targetAddr + i), buffer[i]);
+    if (size > 0) {
+        memory.WriteRom(targetAddr, view.data, size);
     }
+    CloseRomFile(view);
 
     // --- DEBUG MODE --- 
-    // Prints each Byte of the ROM write
+    // Prints a summary of the ROM write
     #ifdef ENABLE_MEMORY_DEBUG
     std::cout << "[ROM Load] " << filepath << " → 0x"
               << std::hex << std::setw(4) << std::setfill('0') << targetAddr
@@ -72,15 +142,15 @@ bool LoadROMFile(const std::string& filepath, Memory& memory, uint16_t targetAdd
 
 // ================= Load Space Invaders =====================
 // Loads the full 4-part Space Invaders ROM set
-
-
 // into the appropriate memory regions. Optionally prints
 // ROM checksums for validation if DEBUG mode is enabled.
 //
 // Returns: true if all parts loaded successfully.
+// loadTimeUs (optional) receives the wall time of the load in µs.
 //
 // ===========================================================
-bool LoadSpaceInvadersROM(Memory& memory, const std::string& overrideDirectory) {
+bool LoadSpaceInvadersROM(Memory& memory, const std::string& overrideDirectory, uint64_t* loadTimeUs) {
+    const auto loadStart = std::chrono::steady_clock::now();
     const std::string romDirectory = overrideDirectory.empty() ? DEFAULT_ROM_DIR : overrideDirectory;
 
     // === ROM Parts: Store Files ===
@@ -101,6 +171,12 @@ bool LoadSpaceInvadersROM(Memory& memory, const std::string& overrideDirectory)
         }
     }
 
+    // === Load Time ===
+    if (loadTimeUs) {
+        *loadTimeUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - loadStart).count());
+    }
+
     // ================= ROM Checksum Validation =============
 
     // --- DEBUG MODE --- 
@@ -21,6 +21,7 @@
 
 // ======================= Includes Files =============================
 #include "memory.hpp"
+#include <cstdint>
 #include <string>
 
 // ======================= ROM Loader ================================
@@ -28,9 +29,12 @@
 // Loads the full Space Invaders ROM set into memory
 // If overrideDirectory is provided, loads from that folder.
 // Returns true on success, false on failure.
-bool LoadSpaceInvadersROM(Memory& memory, const std::string& overrideDirectory = "");
+// If loadTimeUs is provided, receives the time the whole set took in microseconds.
+bool LoadSpaceInvadersROM(Memory& memory, const std::string& overrideDirectory = "",
+                          uint64_t* loadTimeUs = nullptr);
 
 // Loads a single ROM binary file into memory starting at target address specified 
+// Maps the file read-only (mmap on POSIX) and copies it into ROM with one memcpy
 // Performs memory boundary check and writes to ROM only
 bool LoadROMFile(const std::string& filepath, Memory& memory, uint16_t targetAddr);
 
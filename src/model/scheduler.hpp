@@ -0,0 +1,116 @@
+/**********************************************************
+ * @file scheduler.hpp
+ *
+ * @brief Cycle-timestamped event queue for the emulator.
+ *        Hardware events (the mid-screen and vblank interrupts,
+ *        later sound and watchdog timers) are kept in a min-heap
+ *        keyed on the absolute emulated cycle count, so the run
+ *        loop only has to compare against the earliest deadline.
+ *
+ * @author Jese/Arnav (CPU Core)
+ *
+ *********************************************************/
+#ifndef SCHEDULER_HPP_
+#define SCHEDULER_HPP_
+
+/***************** Include files. ***********************/
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+/***************** Global Classes. ***********************/
+
+/**
+ * @brief Events the emulator schedules on the cycle counter.
+ */
+enum class EventId : uint8_t
+{
+    MidScreen, // RST 1, the beam reached the middle of the screen.
+    VBlank,    // RST 2, the beam reached the bottom; end of frame.
+};
+
+/**
+ * @brief One pending event.
+ */
+struct ScheduledEvent
+{
+    uint64_t when; // Absolute cycle the event is due at.
+    EventId id;
+};
+
+/**
+ * @brief Min-heap of pending events ordered by deadline. Events with
+ *        the same deadline fire in the order they were scheduled.
+ */
+class EventScheduler
+{
+public:
+    /**
+     * @brief Adds an event due at the absolute cycle when.
+     */
+    void schedule(EventId id, uint64_t when)
+    {
+        events.push_back({when, id, sequence++});
+        std::push_heap(events.begin(), events.end(), Later());
+    }
+
+    /**
+     * @brief Cycle of the earliest pending event, or UINT64_MAX if
+     *        nothing is scheduled.
+     */
+    uint64_t nextDeadline() const
+    {
+        return events.empty() ? std::numeric_limits<uint64_t>::max() : events.front().when;
+    }
+
+    /**
+     * @brief Removes the earliest event if it is due at or before now.
+     * @param now The current cycle count.
+     * @param event Set to the removed event.
+     *
+     * @returns false if no event is due.
+     */
+    bool popDue(uint64_t now, ScheduledEvent& event)
+    {
+        if (events.empty() || events.front().when > now)
+        {
+            return false;
+        }
+        std::pop_heap(events.begin(), events.end(), Later());
+        event = {events.back().when, events.back().id};
+        events.pop_back();
+        return true;
+    }
+
+    /**
+     * @brief Drops every pending event.
+     */
+    void clear()
+    {
+        events.clear();
+        sequence = 0;
+    }
+
+private:
+    struct Entry
+    {
+        uint64_t when;
+        EventId id;
+        uint64_t order; // Tie-break: schedule order.
+    };
+
+    // std::push_heap builds a max-heap, so "less" means "due later".
+    struct Later
+    {
+        bool operator()(const Entry& lhs, const Entry& rhs) const
+        {
+            return lhs.when != rhs.when ? lhs.when > rhs.when : lhs.order > rhs.order;
+        }
+    };
+
+    std::vector<Entry> events;
+    uint64_t sequence = 0;
+};
+
+#endif // SCHEDULER_HPP_
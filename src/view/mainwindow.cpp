@@ -240,6 +240,9 @@ void MainWindow::on_frameBufferReceived(const frame_buffer_t *buffer)
 
     // Update UI with painted graphics.
     this->update();
+
+    // Let the controller know the GUI caught up with this frame.
+    emit sendFrameConsumedSignal();
 }
 
 void MainWindow::keyPressEvent(QKeyEvent *event)
@@ -235,6 +235,15 @@ signals:
      */
     void sendCloseGameSignal(void);
 
+    /**
+     * @brief Send Frame Consumed signal.
+     * 
+     * Emitted once a received frame has been converted. The
+     * controller counts frames still waiting in the GUI queue,
+     * and skips frames while the GUI is behind.
+     */
+    void sendFrameConsumedSignal(void);
+
 private:
 
     /***************** Private class functions. ***********************/
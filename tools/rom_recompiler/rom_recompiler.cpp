@@ -0,0 +1,562 @@
+/**********************************************************
+ * @file rom_recompiler.cpp
+ *
+ * @brief Build-time static recompiler for the Space Invaders ROM.
+ *        Loads the ROM set with LoadSpaceInvadersROM, discovers its
+ *        basic blocks by following every direct branch from the
+ *        reset and interrupt vectors, and writes a C++ file with one
+ *        function per block plus the AOT_ROM table (see aot_rom.hpp).
+ *
+ *        Only opcodes the dispatch table implements are translated,
+ *        with the same semantics. A block ends at a branch, before
+ *        IN/OUT and unimplemented opcodes (the interpreter runs those)
+ *        and before the start of another block. Targets the tool
+ *        cannot see (RET, PCHL) are looked up by the Aot dispatcher
+ *        at runtime and interpreted when no block starts there.
+ *
+ *        Usage: rom_recompiler <rom directory> <output .cpp>
+ *
+ * @author Jese/Arnav (CPU Core)
+ *
+ *********************************************************/
+
+/***************** Include files. ***********************/
+#include "aot_rom.hpp"
+#include "memory.hpp"
+#include "romloader.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/***************** Macros and defines. ***********************/
+
+// Only the write-protected ROM is recompiled.
+static constexpr uint32_t ROM_END = 0x2000;
+
+// Same upper bound as the block cache.
+static constexpr int MAX_BLOCK_OPS = 64;
+
+/***************** Local Classes. ***********************/
+
+/**
+ * @brief How an opcode affects block discovery.
+ */
+enum class OpKind
+{
+    Unsupported, // Left to the interpreter (IN/OUT, unimplemented).
+    Straight,    // Falls through to the next instruction.
+    Jump,        // JMP: constant target only.
+    Branch,      // Jcc, CALL, Ccc, RST: constant target and fall through.
+    Return,      // RET/Rcc, PCHL: target unknown at build time.
+};
+
+/**
+ * @brief One decoded instruction.
+ */
+struct Instr
+{
+    uint8_t opcode;
+    uint8_t length;
+    uint16_t operand;
+    OpKind kind;
+    uint8_t cycles;       // Base cycles.
+    uint8_t cycles_taken; // Cycles of a taken conditional CALL/RET.
+};
+
+/***************** Local Functions. ***********************/
+
+// Register names in opcode order (6 = M).
+static const char* const REG_NAMES[8] = {"b", "c", "d", "e", "h", "l", nullptr, "a"};
+
+// Condition tests in opcode order (bits 3-5): NZ, Z, NC, C, PO, PE, P, M.
+static const char* const CONDITIONS[8] = {
+    "!alu_test(s.flags, lz, FLAG_Z)",  "alu_test(s.flags, lz, FLAG_Z)",
+    "!alu_test(s.flags, lz, FLAG_CY)", "alu_test(s.flags, lz, FLAG_CY)",
+    "!alu_test(s.flags, lz, FLAG_P)",  "alu_test(s.flags, lz, FLAG_P)",
+    "!alu_test(s.flags, lz, FLAG_S)",  "alu_test(s.flags, lz, FLAG_S)",
+};
+
+static std::string hex16(uint32_t value)
+{
+    char text[8];
+    std::snprintf(text, sizeof(text), "0x%04X", value & 0xFFFF);
+    return text;
+}
+
+static std::string hex8(uint32_t value)
+{
+    char text[8];
+    std::snprintf(text, sizeof(text), "0x%02X", value & 0xFF);
+    return text;
+}
+
+/**
+ * @brief Length of an opcode the dispatch table implements, 0 if it
+ *        only has op_UNIMPLEMENTED. Mirrors buildOpcodeTable().
+ */
+static uint8_t implementedLength(uint8_t op)
+{
+    static const uint8_t ONE_BYTE[] = {
+        0x00, 0x02, 0x03, 0x04, 0x05, 0x07, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0F,
+        0x12, 0x13, 0x14, 0x15, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1F,
+        0x23, 0x24, 0x25, 0x27, 0x29, 0x2B, 0x2C, 0x2D, 0x2F,
+        0x34, 0x35, 0x37, 0x39, 0x3C, 0x3D, 0x3F,
+        0xC1, 0xC5, 0xC9, 0xD1, 0xD5, 0xE1, 0xE3, 0xE5, 0xE9, 0xEB,
+        0xF1, 0xF5, 0xF9, 0xFB,
+    };
+    static const uint8_t TWO_BYTE[] = {
+        0x06, 0x0E, 0x16, 0x1E, 0x26, 0x2E, 0x36, 0x3E,
+        0xC6, 0xCE, 0xD3, 0xD6, 0xDB, 0xDE, 0xE6, 0xEE, 0xF6, 0xFE,
+    };
+    static const uint8_t THREE_BYTE[] = {
+        0x01, 0x11, 0x21, 0x22, 0x2A, 0x31, 0x32, 0x3A, 0xC3, 0xCD,
+    };
+
+    if (op >= 0x40 && op <= 0xBF)
+    {
+        return 1; // MOV, HLT and the ALU group.
+    }
+    uint8_t low = op & 0x07;
+    if (op >= 0xC0 && (low == 0x00 || low == 0x07))
+    {
+        return 1; // Rcc, RST.
+    }
+    if (op >= 0xC0 && (low == 0x02 || low == 0x04))
+    {
+        return 3; // Jcc, Ccc.
+    }
+    for (uint8_t code : ONE_BYTE)   { if (code == op) { return 1; } }
+    for (uint8_t code : TWO_BYTE)   { if (code == op) { return 2; } }
+    for (uint8_t code : THREE_BYTE) { if (code == op) { return 3; } }
+    return 0;
+}
+
+/**
+ * @brief Base cycles of an implemented opcode. Mirrors the cycle
+ *        counts of buildOpcodeTable() (Intel 8080 datasheet).
+ */
+static uint8_t baseCycles(uint8_t op)
+{
+    uint8_t low = op & 0x07;
+    uint8_t reg = (op >> 3) & 0x07;
+    if (op >= 0x40 && op <= 0x7F)
+    {
+        return (op == 0x76 || reg == 6 || low == 6) ? 7 : 5; // HLT, MOV
+    }
+    if (op >= 0x80 && op <= 0xBF)
+    {
+        return low == 6 ? 7 : 4; // ALU A,r / A,M
+    }
+    if (op < 0x40)
+    {
+        switch (op)
+        {
+            case 0x22: case 0x2A: return 16;       // SHLD, LHLD
+            case 0x32: case 0x3A: return 13;       // STA, LDA
+            case 0x34: case 0x35: case 0x36: return 10; // INR M, DCR M, MVI M
+            case 0x00: case 0x07: case 0x0F: case 0x1F:
+            case 0x27: case 0x2F: case 0x37: case 0x3F: return 4;
+            default: break;
+        }
+        switch (op & 0x0F)
+        {
+            case 0x01: case 0x09: return 10;                 // LXI, DAD
+            case 0x02: case 0x0A: case 0x06: case 0x0E: return 7; // STAX, LDAX, MVI
+            default: return 5;                               // INX, DCX, INR, DCR
+        }
+    }
+    switch (low)
+    {
+        case 0x00: return 5;  // Rcc
+        case 0x02: return 10; // Jcc
+        case 0x04: return 11; // Ccc
+        case 0x06: return 7;  // ALU immediate
+        case 0x07: return 11; // RST
+        default: break;
+    }
+    switch (op)
+    {
+        case 0xCD: return 17;
+        case 0xE3: return 18;
+        case 0xC5: case 0xD5: case 0xE5: case 0xF5: return 11;
+        case 0xE9: case 0xF9: return 5;
+        case 0xEB: case 0xFB: return 4;
+        default: return 10; // JMP, RET, POP, IN, OUT
+    }
+}
+
+static OpKind opKind(uint8_t op)
+{
+    uint8_t low = op & 0x07;
+    // HLT is left to runAot(), which idles out the batch.
+    if (implementedLength(op) == 0 || op == 0xD3 || op == 0xDB || op == 0x76)
+    {
+        return OpKind::Unsupported;
+    }
+    if (op == 0xC3)
+    {
+        return OpKind::Jump;
+    }
+    if (op == 0xC9 || op == 0xE9 || (op >= 0xC0 && low == 0x00))
+    {
+        return OpKind::Return;
+    }
+    if (op == 0xCD || (op >= 0xC0 && (low == 0x02 || low == 0x04 || low == 0x07)))
+    {
+        return OpKind::Branch;
+    }
+    return OpKind::Straight;
+}
+
+/**
+ * @brief Decodes the instruction at pc. Instructions whose operand
+ *        reaches past the ROM are left to the interpreter.
+ */
+static Instr decode(const Memory& rom, uint32_t pc)
+{
+    Instr in{};
+    in.opcode = rom.ReadByte(static_cast<uint16_t>(pc));
+    in.length = implementedLength(in.opcode);
+    in.kind = opKind(in.opcode);
+    in.cycles = baseCycles(in.opcode);
+    in.cycles_taken = in.cycles;
+    if (in.opcode >= 0xC0 && ((in.opcode & 0x07) == 0x00 || (in.opcode & 0x07) == 0x04))
+    {
+        in.cycles_taken = in.cycles + 6; // RET cc 5/11, CALL cc 11/17.
+    }
+    if (in.length == 0)
+    {
+        in.length = 1;
+    }
+    if (pc + in.length > ROM_END)
+    {
+        in.kind = OpKind::Unsupported;
+        return in;
+    }
+    if (in.length > 1)
+    {
+        in.operand = rom.ReadByte(static_cast<uint16_t>(pc + 1));
+    }
+    if (in.length > 2)
+    {
+        in.operand |= rom.ReadByte(static_cast<uint16_t>(pc + 2)) << 8;
+    }
+    return in;
+}
+
+/**
+ * @brief Constant target of a Jump/Branch instruction.
+ */
+static uint16_t branchTarget(const Instr& in)
+{
+    return (in.opcode & 0x07) == 0x07 ? (in.opcode & 0x38) : in.operand;
+}
+
+/**
+ * @brief Finds every block start reachable through direct control flow
+ *        from the reset vector and the RST 1/RST 2 interrupt vectors.
+ */
+static std::set<uint32_t> discoverLeaders(const Memory& rom)
+{
+    std::set<uint32_t> leaders;
+    std::vector<uint32_t> work = {0x0000, 0x0008, 0x0010};
+
+    while (!work.empty())
+    {
+        uint32_t pc = work.back();
+        work.pop_back();
+        if (pc >= ROM_END || !leaders.insert(pc).second)
+        {
+            continue;
+        }
+
+        // Walk straight-line code up to the next instruction that ends it.
+        for (int ops = 0; pc < ROM_END; ++ops)
+        {
+            Instr in = decode(rom, pc);
+            uint32_t next = pc + in.length;
+            if (in.kind == OpKind::Unsupported || ops == MAX_BLOCK_OPS)
+            {
+                // The interpreter runs it, translated code resumes after it.
+                work.push_back(in.kind == OpKind::Unsupported ? next : pc);
+                break;
+            }
+            if (in.kind == OpKind::Jump || in.kind == OpKind::Branch)
+            {
+                work.push_back(branchTarget(in));
+            }
+            if (in.kind == OpKind::Branch || (in.kind == OpKind::Return && (in.opcode & 0x07) == 0x00))
+            {
+                work.push_back(next); // Fall through / return address.
+            }
+            if (in.kind != OpKind::Straight)
+            {
+                break;
+            }
+            pc = next;
+        }
+    }
+    return leaders;
+}
+
+/**
+ * @brief Source register/memory operand of MOV and the ALU group.
+ */
+static std::string readReg(uint8_t code)
+{
+    return code == Emulator::REG_M ? "m.ReadByte(aot_pair(s.h, s.l))" : std::string("s.") + REG_NAMES[code];
+}
+
+/**
+ * @brief Statement storing value into a register or memory at HL.
+ */
+static std::string writeReg(uint8_t code, const std::string& value)
+{
+    if (code == Emulator::REG_M)
+    {
+        return "m.WriteByte(aot_pair(s.h, s.l), " + value + ");";
+    }
+    return std::string("s.") + REG_NAMES[code] + " = " + value + ";";
+}
+
+/**
+ * @brief C++ for one instruction at pc. Branches store s.pc, every
+ *        other instruction leaves it alone. A taken CALL/RET cc
+ *        returns takenCycles from the block.
+ */
+static std::string translate(const Instr& in, uint32_t pc, int takenCycles)
+{
+    uint8_t op = in.opcode;
+    uint32_t next = pc + in.length;
+    std::string d8 = hex8(in.operand);
+    std::string d16 = hex16(in.operand);
+
+    // 0x40-0x7F: MOV (0x76 HLT is never translated, see opKind()).
+    if (op >= 0x40 && op <= 0x7F)
+    {
+        return writeReg((op >> 3) & 0x07, readReg(op & 0x07));
+    }
+
+    // 0x80-0xBF: ALU A,r and the matching immediate forms.
+    static const char* const ALU[8] = {
+        "alu_add(s.a, s.flags, lz, %s, 0);", "alu_add(s.a, s.flags, lz, %s, s.flags.cy);",
+        "alu_sub(s.a, s.flags, lz, %s, 0);", "alu_sub(s.a, s.flags, lz, %s, s.flags.cy);",
+        "alu_ana(s.a, s.flags, lz, %s);",    "alu_xra(s.a, s.flags, lz, %s);",
+        "alu_ora(s.a, s.flags, lz, %s);",    "alu_cmp(s.a, s.flags, lz, %s);",
+    };
+    if ((op >= 0x80 && op <= 0xBF) || (op >= 0xC0 && (op & 0x07) == 0x06))
+    {
+        std::string value = op < 0xC0 ? readReg(op & 0x07) : d8;
+        char text[128];
+        std::snprintf(text, sizeof(text), ALU[(op >> 3) & 0x07], value.c_str());
+        return text;
+    }
+
+    // INR/DCR/MVI r (bits 3-5 select the register).
+    if (op < 0x40 && (op & 0x07) >= 0x04 && (op & 0x07) <= 0x06)
+    {
+        uint8_t reg = (op >> 3) & 0x07;
+        if ((op & 0x07) == 0x06)
+        {
+            return writeReg(reg, d8);
+        }
+        const char* fn = (op & 0x07) == 0x04 ? "alu_inr" : "alu_dcr";
+        if (reg == Emulator::REG_M)
+        {
+            return std::string("{ uint16_t addr = aot_pair(s.h, s.l); m.WriteByte(addr, ") +
+                   fn + "(lz, m.ReadByte(addr))); }";
+        }
+        return writeReg(reg, std::string(fn) + "(lz, s." + REG_NAMES[reg] + ")");
+    }
+
+    // Conditional RET / JMP / CALL and RST.
+    if (op >= 0xC0 && op != 0xC9 && op != 0xC3 && op != 0xCD)
+    {
+        const char* cond = CONDITIONS[(op >> 3) & 0x07];
+        switch (op & 0x07)
+        {
+            case 0x00:
+                return std::string("if (") + cond + ") { s.pc = aot_pop(s, m); return " +
+                       std::to_string(takenCycles) + "; } s.pc = " + hex16(next) + ";";
+            case 0x02:
+                return std::string("s.pc = ") + cond + " ? " + d16 + " : " + hex16(next) + ";";
+            case 0x04:
+                return std::string("if (") + cond + ") { aot_push(s, m, " + hex16(next) + "); s.pc = " + d16 +
+                       "; return " + std::to_string(takenCycles) + "; } s.pc = " + hex16(next) + ";";
+            case 0x07:
+                return "aot_push(s, m, " + hex16(next) + "); s.pc = " + hex16(op & 0x38) + ";";
+            default:
+                break;
+        }
+    }
+
+    switch (op)
+    {
+        case 0x00: return "";
+        case 0x01: return "s.b = " + hex8(in.operand >> 8) + "; s.c = " + d8 + ";";
+        case 0x11: return "s.d = " + hex8(in.operand >> 8) + "; s.e = " + d8 + ";";
+        case 0x21: return "s.h = " + hex8(in.operand >> 8) + "; s.l = " + d8 + ";";
+        case 0x31: return "s.sp = " + d16 + ";";
+        case 0x02: return "m.WriteByte(aot_pair(s.b, s.c), s.a);";
+        case 0x12: return "m.WriteByte(aot_pair(s.d, s.e), s.a);";
+        case 0x0A: return "s.a = m.ReadByte(aot_pair(s.b, s.c));";
+        case 0x1A: return "s.a = m.ReadByte(aot_pair(s.d, s.e));";
+        case 0x22: return "m.WriteWord(" + d16 + ", aot_pair(s.h, s.l));";
+        case 0x2A: return "{ uint16_t v = m.ReadWord(" + d16 + "); s.h = v >> 8; s.l = v & 0xFF; }";
+        case 0x32: return "m.WriteByte(" + d16 + ", s.a);";
+        case 0x3A: return "s.a = m.ReadByte(" + d16 + ");";
+        case 0xEB: return "std::swap(s.h, s.d); std::swap(s.l, s.e);";
+
+        case 0x03: return "{ uint16_t v = aot_pair(s.b, s.c) + 1; s.b = v >> 8; s.c = v & 0xFF; }";
+        case 0x13: return "{ uint16_t v = aot_pair(s.d, s.e) + 1; s.d = v >> 8; s.e = v & 0xFF; }";
+        case 0x23: return "{ uint16_t v = aot_pair(s.h, s.l) + 1; s.h = v >> 8; s.l = v & 0xFF; }";
+        case 0x0B: return "{ uint16_t v = aot_pair(s.b, s.c) - 1; s.b = v >> 8; s.c = v & 0xFF; }";
+        case 0x1B: return "{ uint16_t v = aot_pair(s.d, s.e) - 1; s.d = v >> 8; s.e = v & 0xFF; }";
+        case 0x2B: return "{ uint16_t v = aot_pair(s.h, s.l) - 1; s.h = v >> 8; s.l = v & 0xFF; }";
+        case 0x09: return "{ uint16_t v = alu_dad(s.flags, aot_pair(s.h, s.l), aot_pair(s.b, s.c)); s.h = v >> 8; s.l = v & 0xFF; }";
+        case 0x19: return "{ uint16_t v = alu_dad(s.flags, aot_pair(s.h, s.l), aot_pair(s.d, s.e)); s.h = v >> 8; s.l = v & 0xFF; }";
+        case 0x29: return "{ uint16_t v = alu_dad(s.flags, aot_pair(s.h, s.l), aot_pair(s.h, s.l)); s.h = v >> 8; s.l = v & 0xFF; }";
+        case 0x39: return "{ uint16_t v = alu_dad(s.flags, aot_pair(s.h, s.l), s.sp); s.h = v >> 8; s.l = v & 0xFF; }";
+        case 0x27: return "alu_daa(s.a, s.flags, lz);";
+
+        case 0x07: return "alu_rlc(s.a, s.flags);";
+        case 0x0F: return "alu_rrc(s.a, s.flags);";
+        case 0x1F: return "alu_rar(s.a, s.flags);";
+        case 0x2F: return "s.a = ~s.a;";
+        case 0x37: return "s.flags.cy = true;";
+        case 0x3F: return "s.flags.cy = !s.flags.cy;";
+
+        case 0xC3: return "s.pc = " + d16 + ";";
+        case 0xC9: return "s.pc = aot_pop(s, m);";
+        case 0xCD: return "aot_push(s, m, " + hex16(next) + "); s.pc = " + d16 + ";";
+        case 0xE9: return "s.pc = aot_pair(s.h, s.l);";
+
+        case 0xC1: return "{ uint16_t v = aot_pop(s, m); s.b = v >> 8; s.c = v & 0xFF; }";
+        case 0xD1: return "{ uint16_t v = aot_pop(s, m); s.d = v >> 8; s.e = v & 0xFF; }";
+        case 0xE1: return "{ uint16_t v = aot_pop(s, m); s.h = v >> 8; s.l = v & 0xFF; }";
+        case 0xF1: return "{ uint16_t v = aot_pop(s, m); alu_unpack_psw(s.flags, lz, v & 0xFF); s.a = v >> 8; }";
+        case 0xC5: return "aot_push(s, m, aot_pair(s.b, s.c));";
+        case 0xD5: return "aot_push(s, m, aot_pair(s.d, s.e));";
+        case 0xE5: return "aot_push(s, m, aot_pair(s.h, s.l));";
+        case 0xF5: return "aot_push(s, m, aot_pair(s.a, alu_pack_psw(s.flags, lz)));";
+        case 0xE3:
+            return "{ uint16_t v = m.ReadWord(s.sp); m.WriteWord(s.sp, aot_pair(s.h, s.l)); "
+                   "s.h = v >> 8; s.l = v & 0xFF; }";
+        case 0xF9: return "s.sp = aot_pair(s.h, s.l);";
+        case 0xFB: return "s.interrupts_enabled = true;";
+        default: break;
+    }
+    return "";
+}
+
+/**
+ * @brief Writes the generated translation unit.
+ */
+static void emit(std::ostream& out, const Memory& rom, const std::set<uint32_t>& leaders, const std::string& romDir)
+{
+    std::ostringstream table;
+    int blockCount = 0;
+
+    out << "// Generated by tools/rom_recompiler from " << romDir << ". Do not edit.\n"
+        << "#include \"aot_rom.hpp\"\n"
+        << "#include <utility>\n\n"
+        << "namespace {\n\n";
+
+    for (uint32_t start : leaders)
+    {
+        std::ostringstream body;
+        uint32_t pc = start;
+        int count = 0;
+        int cycles = 0;
+        int lead_cycles = 0;
+        bool stored = false;
+
+        while (pc < ROM_END && count < MAX_BLOCK_OPS)
+        {
+            // Stop where another block starts, that block runs next.
+            if (count > 0 && leaders.count(pc) != 0)
+            {
+                break;
+            }
+            Instr in = decode(rom, pc);
+            if (in.kind == OpKind::Unsupported)
+            {
+                break;
+            }
+            lead_cycles = cycles;
+            cycles += in.cycles;
+            std::string code = translate(in, pc, lead_cycles + in.cycles_taken);
+            body << "    " << (code.empty() ? "// " + hex16(pc) + ": nothing to do" : code) << "\n";
+            pc += in.length;
+            ++count;
+            if (in.kind != OpKind::Straight)
+            {
+                stored = true;
+                break;
+            }
+        }
+
+        if (count == 0)
+        {
+            continue; // The interpreter runs the opcode at start.
+        }
+        if (!stored)
+        {
+            body << "    s.pc = " << hex16(pc) << ";\n";
+        }
+        body << "    return " << cycles << ";\n";
+
+        std::string name = "block_" + hex16(start).substr(2);
+        out << "// " << hex16(start) << ", " << count << " instruction(s), " << cycles << " cycles\n"
+            << "int " << name << "(CPUState& s, LazyFlags& lz, Memory& m)\n"
+            << "{\n"
+            << "    (void)lz;\n"
+            << "    (void)m;\n"
+            << body.str()
+            << "}\n\n";
+        table << "    {" << hex16(start) << ", " << lead_cycles << ", &" << name << "},\n";
+        ++blockCount;
+    }
+
+    out << "const AotBlock BLOCKS[] = {\n"
+        << table.str()
+        << "};\n\n"
+        << "} // namespace\n\n"
+        << "const AotRom AOT_ROM = {" << aot_rom_hash(rom) << "ull, BLOCKS, " << blockCount << "};\n";
+}
+
+/***************** Main. ***********************/
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <rom directory> <output .cpp>\n";
+        return 1;
+    }
+
+    Memory rom;
+    uint64_t loadTimeUs = 0;
+    if (!LoadSpaceInvadersROM(rom, argv[1], &loadTimeUs))
+    {
+        return 1;
+    }
+    std::cout << "[rom_recompiler] ROM set loaded in " << loadTimeUs << " us\n";
+
+    std::set<uint32_t> leaders = discoverLeaders(rom);
+
+    std::ofstream out(argv[2]);
+    if (!out)
+    {
+        std::cerr << "[rom_recompiler] Cannot write " << argv[2] << "\n";
+        return 1;
+    }
+    emit(out, rom, leaders, argv[1]);
+
+    std::cout << "[rom_recompiler] " << leaders.size() << " block starts written to " << argv[2] << "\n";
+    return 0;
+}